@@ -8,6 +8,7 @@
 #include <common.h>
 #include <command.h>
 #include <asm/system.h>
+#include <linux/log2.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -62,3 +63,37 @@ unsigned long usec2ticks(unsigned long usec)
 
 	return ticks;
 }
+
+#ifdef CONFIG_EFI_CPU_IDLE
+/* CNTKCTL_EL1 event stream of the virtual counter */
+#define CNTKCTL_EVNTEN		(1 << 2)
+#define CNTKCTL_EVNTI_SHIFT	4
+#define CNTKCTL_EVNT_MASK	(0xf << CNTKCTL_EVNTI_SHIFT | 0x3 << 2)
+
+/*
+ * Wait with WFE until the deadline has passed. No interrupt is set up to
+ * end a WFI, so the event stream of the generic timer is enabled instead.
+ * It signals an event about every 100us without any interrupt controller.
+ */
+void efi_cpu_idle(ulong usec)
+{
+	ulong end = timer_read_counter() + usec2ticks(usec);
+	ulong cntkctl, evnti;
+
+	/* An event on each 0 to 1 transition of counter bit evnti */
+	evnti = ilog2(max(get_tbclk() / 10000, 2UL)) - 1;
+	evnti = min(evnti, 15UL);
+
+	asm volatile("mrs %0, cntkctl_el1" : "=r" (cntkctl));
+	asm volatile("msr cntkctl_el1, %0" : :
+		     "r" ((cntkctl & ~CNTKCTL_EVNT_MASK) | CNTKCTL_EVNTEN |
+			  evnti << CNTKCTL_EVNTI_SHIFT));
+	isb();
+
+	while ((long)(end - timer_read_counter()) > 0)
+		asm volatile("wfe" : : : "memory");
+
+	asm volatile("msr cntkctl_el1, %0" : : "r" (cntkctl));
+	isb();
+}
+#endif
@@ -100,6 +100,27 @@ lr	.req	x30
 	b.eq	\a53_label
 .endm
 
+/*
+ * Branch if unaligned accesses may fault at the current exception level,
+ * that is if the MMU is off (all memory is Device memory) or alignment
+ * checking is on.
+ */
+.macro	branch_if_strict_align, xreg, label
+	switch_el \xreg, .Lsa_el3\@, .Lsa_el2\@, .Lsa_el1\@
+.Lsa_el3\@:
+	mrs	\xreg, sctlr_el3
+	b	.Lsa_done\@
+.Lsa_el2\@:
+	mrs	\xreg, sctlr_el2
+	b	.Lsa_done\@
+.Lsa_el1\@:
+	mrs	\xreg, sctlr_el1
+.Lsa_done\@:
+	and	\xreg, \xreg, #(CR_M | CR_A)
+	cmp	\xreg, #CR_M
+	b.ne	\label
+.endm
+
 /*
  * Branch if current processor is a slave,
  * choose processor with all zero affinity value as the master.
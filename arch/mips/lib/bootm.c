@@ -246,6 +246,7 @@ static int boot_reloc_fdt(bootm_headers_t *images)
 
 #if CONFIG_IS_ENABLED(MIPS_BOOT_FDT) && CONFIG_IS_ENABLED(OF_LIBFDT)
 	boot_fdt_add_mem_rsv_regions(&images->lmb, images->ft_addr);
+	boot_fdt_reserve_container(images);
 	return boot_relocate_fdt(&images->lmb, &images->ft_addr,
 		&images->ft_len);
 #else
@@ -8,6 +8,7 @@
 #define _ASM_CONFIG_H_
 
 #define CONFIG_SANDBOX_ARCH
+#define CONFIG_SYS_BOOT_RAMDISK_HIGH
 
 /* Used by drivers/spi/sandbox_spi.c and arch/sandbox/include/asm/state.h */
 #ifndef CONFIG_SANDBOX_SPI_MAX_BUS
@@ -12,6 +12,8 @@
 
 void sandbox_eth_disable_response(int index, bool disable);
 
+void sandbox_eth_damage_ip_sum(int index, bool damage);
+
 void sandbox_eth_skip_timeout(void);
 
 #endif /* __ETH_H */
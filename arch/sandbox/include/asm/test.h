@@ -14,6 +14,7 @@
 
 #define SANDBOX_PCI_VENDOR_ID		0x1234
 #define SANDBOX_PCI_DEVICE_ID		0x5678
+#define SANDBOX_PCI_BRIDGE_DEVICE_ID	0x5679
 #define SANDBOX_PCI_CLASS_CODE		PCI_CLASS_CODE_COMM
 #define SANDBOX_PCI_CLASS_SUB_CODE	PCI_CLASS_SUB_CODE_COMM_SERIAL
 
@@ -79,4 +80,21 @@ long sandbox_i2c_rtc_get_set_base_time(struct udevice *dev, long base_time);
 
 int sandbox_usb_keyb_add_string(struct udevice *dev, const char *str);
 
+/**
+ * sandbox_spi_set_mem_read_err() - control the bus's mem_read() method
+ *
+ * @bus:	sandbox SPI bus to adjust
+ * @err:	Error for mem_read() to return (e.g. -ENOTSUPP or -ENOSYS), or
+ *		0 to perform reads normally
+ */
+void sandbox_spi_set_mem_read_err(struct udevice *bus, int err);
+
+/**
+ * sandbox_spi_get_mem_read_count() - get the number of mem_read() reads
+ *
+ * @bus:	sandbox SPI bus to check
+ * @return number of reads performed by the bus's mem_read() method
+ */
+uint sandbox_spi_get_mem_read_count(struct udevice *bus);
+
 #endif
@@ -244,6 +244,10 @@ int cpu_init_r(void)
 	struct udevice *dev;
 	int ret;
 
+	/* x86_device is only set if the CPU has CPUID */
+	if (IS_ENABLED(CONFIG_X86_64) || gd->arch.x86_device)
+		x86_string_init();
+
 	if (!ll_boot_init())
 		return 0;
 
@@ -33,6 +33,13 @@
 #define PIT_CMD_MODE4	0x08	/* Select mode 4 */
 #define PIT_CMD_MODE5	0x0a	/* Select mode 5 */
 
+/* Read-back command, the status byte has the same layout as bits 5-0 */
+#define PIT_CMD_READBACK	0xc0	/* Read-back command */
+#define PIT_RB_NOCOUNT		0x20	/* Do not latch the count */
+#define PIT_RB_NOSTATUS		0x10	/* Do not latch the status */
+#define PIT_RB_CTR0		0x02	/* Read back counter 0 */
+#define PIT_STATUS_MASK		0x3f	/* Access mode, mode and BCD bits */
+
 /* The clock frequency of the i8253/i8254 PIT */
 #define PIT_TICK_RATE	1193182
 
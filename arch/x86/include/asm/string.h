@@ -29,4 +29,7 @@ extern void * memset(void *, int, __kernel_size_t);
 #undef __HAVE_ARCH_MEMZERO
 extern void memzero(void *ptr, __kernel_size_t n);
 
+/* Pick the fastest string moves for this CPU, once CPUID is known to work */
+void x86_string_init(void);
+
 #endif
@@ -44,6 +44,11 @@ void bootm_announce_and_cleanup(void)
 	bootstage_report();
 #endif
 
+#ifdef CONFIG_PCI_LAZY_ENUM
+	/* Set up the PCI devices not used so far, as the kernel expects */
+	pci_init();
+#endif
+
 	/*
 	 * Call remove function of all devices with a removal flag set.
 	 * This may be useful for last-stage operations, like cancelling
@@ -8,6 +8,7 @@
 #include <common.h>
 #include <asm/io.h>
 #include <asm/i8254.h>
+#include <asm/ibmpc.h>
 
 #define TIMER1_VALUE	18	/* 15.6us */
 #define TIMER2_VALUE	0x0a8e	/* 440Hz */
@@ -35,3 +36,70 @@ int i8254_init(void)
 
 	return 0;
 }
+
+#ifdef CONFIG_EFI_CPU_IDLE
+static void i8254_idle_isr(void *arg)
+{
+}
+
+/* Put counter 0 back into the mode it had before efi_cpu_idle() */
+static void i8254_restore_ctr0(u8 status)
+{
+	u8 access = status & PIT_CMD_BOTH;
+
+	/* Not set up before, leave the one-shot mode, which is quiet now */
+	if (!access)
+		return;
+
+	/*
+	 * The initial count cannot be read back. Restart with 0, which is
+	 * 65536 and gives the usual 18.2Hz of a PC.
+	 */
+	outb(PIT_CMD_CTR0 | (status & PIT_STATUS_MASK),
+	     PIT_BASE + PIT_COMMAND);
+	if (access & PIT_CMD_LOW)
+		outb(0, PIT_BASE + PIT_T0);
+	if (access & PIT_CMD_HIGH)
+		outb(0, PIT_BASE + PIT_T0);
+}
+
+/*
+ * Halt until the deadline, using counter 0 in one-shot mode to raise IRQ0.
+ * Other interrupts may end the wait early, which is harmless. Without
+ * interrupts enabled nothing would end HLT, so just delay then.
+ *
+ * IRQ0 is only unmasked, and its handler only installed, around the HLT.
+ * Nothing is left behind for the rest of U-Boot or the OS.
+ */
+void efi_cpu_idle(ulong usec)
+{
+	ulong count;
+	u8 status;
+
+	if (!disable_interrupts()) {
+		udelay(usec);
+		return;
+	}
+
+	outb(PIT_CMD_READBACK | PIT_RB_NOCOUNT | PIT_RB_CTR0,
+	     PIT_BASE + PIT_COMMAND);
+	status = inb(PIT_BASE + PIT_T0);
+
+	/* At most 54ms fit into the 16-bit counter */
+	count = min(usec, 50000UL) * (PIT_TICK_RATE / 1000) / 1000;
+	count = clamp(count, 1UL, 0xffffUL);
+	outb(PIT_CMD_CTR0 | PIT_CMD_BOTH | PIT_CMD_MODE0,
+	     PIT_BASE + PIT_COMMAND);
+	outb(count & 0xff, PIT_BASE + PIT_T0);
+	outb(count >> 8, PIT_BASE + PIT_T0);
+	irq_install_handler(0, i8254_idle_isr, NULL);
+
+	/* STI only takes effect after HLT, so IRQ0 cannot be missed */
+	asm volatile("sti; hlt" : : : "memory");
+
+	disable_interrupts();
+	irq_free_handler(0);
+	i8254_restore_ctr0(status);
+	enable_interrupts();
+}
+#endif
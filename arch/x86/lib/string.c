@@ -8,15 +8,41 @@
 
 /* From glibc-2.14, sysdeps/i386/memset.c */
 
+#include <common.h>
 #include <linux/types.h>
 #include <linux/compiler.h>
+#include <asm/cpu.h>
 #include <asm/string.h>
 
+#if CONFIG_IS_ENABLED(X86_64)
+typedef uint64_t op_t;
+#define MOVS_OP		"movsq"
+#define STOS_OP		"stosq"
+#else
 typedef uint32_t op_t;
+#define MOVS_OP		"movsl"
+#define STOS_OP		"stosl"
+#endif
+
+/*
+ * With Enhanced REP MOVSB/STOSB (ERMS) a single 'rep movsb' or 'rep stosb'
+ * beats word moves above a few cache lines. This is only known after
+ * relocation, so keep it in .data which is readable from flash before.
+ */
+#define ERMS_THRES	256
+
+static bool string_erms __attribute__((section(".data")));
+
+void x86_string_init(void)
+{
+	/* ERMS is bit 9 of EBX in leaf 7 */
+	if (cpuid_eax(0) >= 7 && (cpuid_ext(7, 0).ebx & (1 << 9)))
+		string_erms = true;
+}
 
 void *memset(void *dstpp, int c, size_t len)
 {
-	int d0;
+	unsigned long d0;
 	unsigned long int dstp = (unsigned long int) dstpp;
 
 	/* This explicit register allocation improves code very much indeed. */
@@ -27,11 +53,24 @@ void *memset(void *dstpp, int c, size_t len)
 	/* Clear the direction flag, so filling will move forward.  */
 	asm volatile("cld");
 
+	if (string_erms && len >= ERMS_THRES) {
+		asm volatile(
+			"rep\n"
+			"stosb" /* %0, %2, %3 */ :
+			"=D" (dstp), "=c" (d0) :
+			"0" (dstp), "1" (len), "a" (x) :
+			"memory");
+		return dstpp;
+	}
+
 	/* This threshold value is optimal.  */
 	if (len >= 12) {
-		/* Fill X with four copies of the char we want to fill with. */
+		/* Fill X with copies of the char we want to fill with. */
 		x |= (x << 8);
 		x |= (x << 16);
+#if CONFIG_IS_ENABLED(X86_64)
+		x |= (x << 32);
+#endif
 
 		/* Adjust LEN for the bytes handled in the first loop.  */
 		len -= (-dstp) % sizeof(op_t);
@@ -52,7 +91,7 @@ void *memset(void *dstpp, int c, size_t len)
 		/* Fill longwords.  */
 		asm volatile(
 			"rep\n"
-			"stosl" /* %0, %2, %3 */ :
+			STOS_OP /* %0, %2, %3 */ :
 			"=D" (dstp), "=c" (d0) :
 			"0" (dstp), "1" (len / sizeof(op_t)), "a" (x) :
 			"memory");
@@ -75,7 +114,7 @@ void *memset(void *dstpp, int c, size_t len)
 
 #define BYTE_COPY_FWD(dst_bp, src_bp, nbytes)				  \
 do {									  \
-	int __d0;							  \
+	unsigned long __d0;						  \
 	asm volatile(							  \
 		/* Clear the direction flag, so copying goes forward.  */ \
 		"cld\n"							  \
@@ -89,17 +128,17 @@ do {									  \
 
 #define WORD_COPY_FWD(dst_bp, src_bp, nbytes_left, nbytes)		  \
 do {									  \
-	int __d0;							  \
+	unsigned long __d0;						  \
 	asm volatile(							  \
 		/* Clear the direction flag, so copying goes forward.  */ \
 		"cld\n"							  \
 		/* Copy longwords.  */					  \
 		"rep\n"							  \
-		"movsl" :						  \
+		MOVS_OP :						  \
 		"=D" (dst_bp), "=S" (src_bp), "=c" (__d0) :		  \
-		"0" (dst_bp), "1" (src_bp), "2" ((nbytes) / 4) :	  \
+		"0" (dst_bp), "1" (src_bp), "2" ((nbytes) / OPSIZ) :	  \
 		"memory");						  \
-	(nbytes_left) = (nbytes) % 4;					  \
+	(nbytes_left) = (nbytes) % OPSIZ;				  \
 } while (0)
 
 void *memcpy(void *dstpp, const void *srcpp, size_t len)
@@ -109,6 +148,11 @@ void *memcpy(void *dstpp, const void *srcpp, size_t len)
 
 	/* Copy from the beginning to the end.  */
 
+	if (string_erms && len >= ERMS_THRES) {
+		BYTE_COPY_FWD(dstp, srcp, len);
+		return dstpp;
+	}
+
 	/* If there not too few bytes to copy, use word copy.  */
 	if (len >= OP_T_THRES) {
 		/* Copy just a few bytes to make DSTP aligned.  */
@@ -32,6 +32,11 @@ static void efi_init_obj_list(void)
 {
 	efi_obj_list_initalized = 1;
 
+#ifdef CONFIG_PCI_LAZY_ENUM
+	/* Set up the PCI devices not used so far, as the payload expects */
+	pci_init();
+#endif
+
 	/* Initialize EFI driver uclass */
 	efi_driver_init();
 
@@ -187,6 +192,9 @@ static efi_status_t do_bootefi_exec(void *efi, void *fdt,
 	if (!efi_obj_list_initalized)
 		efi_init_obj_list();
 
+	/* U-Boot may have written to the disks since the last payload ran */
+	efi_disk_invalidate_cache(NULL);
+
 	efi_setup_loaded_image(&loaded_image_info, &loaded_image_info_obj,
 			       device_path, image_path);
 
@@ -274,6 +282,9 @@ exit:
 	/* image has returned, loaded-image obj goes *poof*: */
 	list_del(&loaded_image_info_obj.link);
 
+	/* Persist variables changed by the payload */
+	efi_variables_flush();
+
 	return ret;
 }
 
@@ -317,6 +328,10 @@ static int do_bootefi(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 
 	if (argc < 2)
 		return CMD_RET_USAGE;
+
+	/* The environment may have changed since the last run */
+	efi_variables_reload();
+
 #ifdef CONFIG_CMD_BOOTEFI_HELLO
 	if (!strcmp(argv[1], "hello")) {
 		ulong size = __efi_helloworld_end - __efi_helloworld_begin;
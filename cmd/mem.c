@@ -17,6 +17,7 @@
 #include <cli.h>
 #include <command.h>
 #include <console.h>
+#include <div64.h>
 #include <hash.h>
 #include <inttypes.h>
 #include <mapmem.h>
@@ -852,6 +853,152 @@ static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
 	return errs;
 }
 
+/* Bytes written and read by each step of the wide test, a cache line */
+#define MEMTEST_LINE		64
+#define MEMTEST_LINE_WORDS	(MEMTEST_LINE / sizeof(ulong))
+
+/* Bytes tested between checks for ctrl-c */
+#define MEMTEST_CHUNK		(1 << 20)
+
+/*
+ * Fill @lines cache lines with the address of each word xor'ed with
+ * @pattern, so that every word differs and address line faults show up.
+ * Plain (non-volatile) accesses let the compiler use its widest stores.
+ */
+static void mem_test_wide_fill(ulong *buf, ulong addr, ulong lines,
+			       ulong pattern)
+{
+	int i;
+
+	for (; lines; lines--, buf += MEMTEST_LINE_WORDS) {
+		for (i = 0; i < MEMTEST_LINE_WORDS; i++)
+			buf[i] = (addr + i * sizeof(ulong)) ^ pattern;
+		addr += MEMTEST_LINE;
+	}
+}
+
+/* Check lines written by mem_test_wide_fill(), returning the errors */
+static ulong mem_test_wide_check(ulong *buf, ulong addr, ulong lines,
+				 ulong pattern)
+{
+	ulong errs = 0;
+	ulong diff, val;
+	int i;
+
+	for (; lines; lines--, buf += MEMTEST_LINE_WORDS) {
+		diff = 0;
+		for (i = 0; i < MEMTEST_LINE_WORDS; i++)
+			diff |= buf[i] ^ (addr + i * sizeof(ulong)) ^ pattern;
+
+		/* Only look at single words once a line is known to be bad */
+		for (i = 0; diff && i < MEMTEST_LINE_WORDS; i++) {
+			val = (addr + i * sizeof(ulong)) ^ pattern;
+			if (buf[i] == val)
+				continue;
+			printf("\nMem error @ 0x%08lX: "
+			       "found %08lX, expected %08lX\n",
+			       addr + i * sizeof(ulong), buf[i], val);
+			errs++;
+			if (ctrlc())
+				return -1;
+		}
+		addr += MEMTEST_LINE;
+	}
+
+	return errs;
+}
+
+/* Write back and drop the cache lines of a chunk, so reads come from RAM */
+static void mem_test_wide_flush(ulong *buf, ulong size)
+{
+	ulong start = (ulong)buf & ~(ARCH_DMA_MINALIGN - 1);
+
+	flush_dcache_range(start, ALIGN((ulong)buf + size, ARCH_DMA_MINALIGN));
+}
+
+/* Show the progress of a pass, as a percentage */
+static void mem_test_wide_progress(ulong done, ulong size)
+{
+	u64 percent = (u64)done * 100;
+
+	do_div(percent, size);
+	printf("%3u%%\b\b\b\b", (uint)percent);
+}
+
+/* Return the bandwidth in MiB/s of moving @size bytes in @ms */
+static ulong mem_test_wide_rate(ulong size, ulong ms)
+{
+	u64 rate = ((u64)size * 1000) >> 20;
+
+	do_div(rate, ms ? ms : 1);
+
+	return rate;
+}
+
+/*
+ * Test memory a cache line at a time. Each pass writes the whole range and
+ * then reads it back, a chunk at a time, flushing the cache in between so
+ * that the data goes through the RAM. The second pass uses the complement
+ * of the pattern so that every data line is seen both ways.
+ */
+static ulong mem_test_wide(ulong *buf, ulong start_addr, ulong end_addr,
+			   ulong pattern, int iteration)
+{
+	ulong lines = (end_addr - start_addr) / MEMTEST_LINE;
+	ulong size = lines * MEMTEST_LINE;
+	ulong chunk = MEMTEST_CHUNK / MEMTEST_LINE;
+	ulong errs = 0;
+	ulong offset, count, ret;
+	ulong start, write_ms, read_ms;
+	int pass;
+
+	/* Move the values around from one iteration to the next */
+	pattern += iteration;
+	for (pass = 0; pass < 2; pass++, pattern = ~pattern) {
+		printf("\rPattern %08lX  Writing...", pattern);
+		start = get_timer(0);
+		for (offset = 0; offset < lines; offset += count) {
+			count = min(lines - offset, chunk);
+			mem_test_wide_fill(buf + offset * MEMTEST_LINE_WORDS,
+					   start_addr + offset * MEMTEST_LINE,
+					   count, pattern);
+			mem_test_wide_flush(buf + offset * MEMTEST_LINE_WORDS,
+					    count * MEMTEST_LINE);
+			WATCHDOG_RESET();
+			if (ctrlc())
+				return -1;
+			mem_test_wide_progress(offset + count, lines);
+		}
+		write_ms = get_timer(start);
+
+		puts("Reading...");
+		start = get_timer(0);
+		for (offset = 0; offset < lines; offset += count) {
+			count = min(lines - offset, chunk);
+			ret = mem_test_wide_check(buf +
+						  offset * MEMTEST_LINE_WORDS,
+						  start_addr +
+						  offset * MEMTEST_LINE,
+						  count, pattern);
+			if (ret == -1UL)
+				return -1;
+			errs += ret;
+			WATCHDOG_RESET();
+			if (ctrlc())
+				return -1;
+			mem_test_wide_progress(offset + count, lines);
+		}
+		read_ms = get_timer(start);
+
+		printf("\rPattern %08lX  written at %lu MiB/s, "
+		       "read at %lu MiB/s\n", pattern,
+		       mem_test_wide_rate(size, write_ms),
+		       mem_test_wide_rate(size, read_ms));
+	}
+
+	return errs;
+}
+
 /*
  * Perform a memory test. A more complete alternative test can be
  * configured using CONFIG_SYS_ALT_MEMTEST. The complete test loops until
@@ -872,6 +1019,14 @@ static int do_mem_mtest(cmd_tbl_t *cmdtp, int flag, int argc,
 #else
 	const int alt_test = 0;
 #endif
+	int wide_test = 0;
+
+	if (IS_ENABLED(CONFIG_CMD_MEMTEST_WIDE) && argc > 1 &&
+	    !strcmp(argv[1], "-w")) {
+		wide_test = 1;
+		argc--;
+		argv++;
+	}
 
 	start = CONFIG_SYS_MEMTEST_START;
 	end = CONFIG_SYS_MEMTEST_END;
@@ -913,7 +1068,10 @@ static int do_mem_mtest(cmd_tbl_t *cmdtp, int flag, int argc,
 
 		printf("Iteration: %6d\r", iteration + 1);
 		debug("\n");
-		if (alt_test) {
+		if (wide_test) {
+			errs = mem_test_wide((ulong *)buf, start, end, pattern,
+					     iteration);
+		} else if (alt_test) {
 			errs = mem_test_alt(buf, start, end, dummy);
 		} else {
 			errs = mem_test_quick(buf, start, end, pattern,
@@ -1218,9 +1376,14 @@ U_BOOT_CMD(
 
 #ifdef CONFIG_CMD_MEMTEST
 U_BOOT_CMD(
-	mtest,	5,	1,	do_mem_mtest,
+	mtest,	6,	1,	do_mem_mtest,
 	"simple RAM read/write test",
+#ifdef CONFIG_CMD_MEMTEST_WIDE
+	"[-w] [start [end [pattern [iterations]]]]\n"
+	"    -w: test a cache line at a time and show the bandwidth"
+#else
 	"[start [end [pattern [iterations]]]]"
+#endif
 );
 #endif	/* CONFIG_CMD_MEMTEST */
 
@@ -0,0 +1,167 @@
+/*
+ * Measure the speed of memcpy(), memmove(), memset() and memcmp()
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <console.h>
+#include <div64.h>
+#include <malloc.h>
+
+/* Bytes handled per measurement, so that all sizes take similar time */
+#define MEMBENCH_BYTES		(16 << 20)
+
+/* Extra room in the buffers for the offsets and the memmove() overlap */
+#define MEMBENCH_SLACK		128
+
+static const ulong membench_sizes[] = {
+	32, 256, 4 << 10, 64 << 10, 1 << 20, 16 << 20,
+};
+
+/* Offsets of the destination and the source from an aligned address */
+static const struct {
+	int dst;
+	int src;
+} membench_align[] = {
+	{ 0, 0 },
+	{ 3, 3 },
+	{ 0, 5 },
+	{ 5, 0 },
+};
+
+enum membench_op {
+	MEMBENCH_MEMCPY,
+	MEMBENCH_MEMMOVE,
+	MEMBENCH_MEMSET,
+	MEMBENCH_MEMCMP,
+
+	MEMBENCH_COUNT,
+};
+
+static const char *const membench_name[MEMBENCH_COUNT] = {
+	"memcpy", "memmove", "memset", "memcmp",
+};
+
+/* Run @op on @size bytes until MEMBENCH_BYTES are done, return MB/s */
+static ulong membench_run(enum membench_op op, char *dst, char *src,
+			  ulong size)
+{
+	ulong loops = max(MEMBENCH_BYTES / size, 1UL);
+	ulong i, start, us;
+	int res = 0;
+
+	start = timer_get_us();
+	for (i = 0; i < loops; i++) {
+		switch (op) {
+		case MEMBENCH_MEMCPY:
+			memcpy(dst, src, size);
+			break;
+		case MEMBENCH_MEMMOVE:
+			memmove(dst, src, size);
+			break;
+		case MEMBENCH_MEMSET:
+			memset(dst, i, size);
+			break;
+		case MEMBENCH_MEMCMP:
+			res |= memcmp(dst, src, size);
+			break;
+		default:
+			break;
+		}
+	}
+	us = timer_get_us() - start;
+	if (res)
+		printf("memcmp() found a difference\n");
+
+	return us ? lldiv((u64)loops * size, us) : 0;
+}
+
+static void membench_print_size(ulong size)
+{
+	if (size >= 1 << 20)
+		printf(" %6luM", size >> 20);
+	else if (size >= 1 << 10)
+		printf(" %6luK", size >> 10);
+	else
+		printf(" %7lu", size);
+}
+
+static int do_membench(cmd_tbl_t *cmdtp, int flag, int argc,
+		       char * const argv[])
+{
+	ulong max_size = 1 << 20;
+	char *dst_buf, *src_buf, *dst, *src;
+	enum membench_op op;
+	ulong mbps;
+	int i, a;
+
+	if (argc > 2)
+		return CMD_RET_USAGE;
+	if (argc == 2)
+		max_size = simple_strtoul(argv[1], NULL, 16);
+	if (max_size < membench_sizes[0])
+		return CMD_RET_USAGE;
+
+	dst_buf = memalign(ARCH_DMA_MINALIGN, max_size + MEMBENCH_SLACK);
+	src_buf = memalign(ARCH_DMA_MINALIGN, max_size + MEMBENCH_SLACK);
+	if (!dst_buf || !src_buf) {
+		printf("Cannot allocate buffers of %#lx bytes\n", max_size);
+		free(dst_buf);
+		free(src_buf);
+		return CMD_RET_FAILURE;
+	}
+
+	printf("MB/s     dst/src");
+	for (i = 0; i < ARRAY_SIZE(membench_sizes); i++) {
+		if (membench_sizes[i] <= max_size)
+			membench_print_size(membench_sizes[i]);
+	}
+	puts("\n");
+
+	for (op = 0; op < MEMBENCH_COUNT; op++) {
+		for (a = 0; a < ARRAY_SIZE(membench_align); a++) {
+			/* memset() has no source */
+			if (op == MEMBENCH_MEMSET && membench_align[a].src)
+				continue;
+			printf("%-8s %3d/%-3d", membench_name[op],
+			       membench_align[a].dst, membench_align[a].src);
+			dst = dst_buf + membench_align[a].dst;
+			src = src_buf + membench_align[a].src;
+			memset(dst_buf, 0x5a, max_size + MEMBENCH_SLACK);
+			memset(src_buf, 0x5a, max_size + MEMBENCH_SLACK);
+			/* overlap for memmove(), so that it copies backwards */
+			if (op == MEMBENCH_MEMMOVE)
+				dst = src_buf + MEMBENCH_SLACK / 2 +
+				      membench_align[a].dst;
+			for (i = 0; i < ARRAY_SIZE(membench_sizes); i++) {
+				if (membench_sizes[i] > max_size)
+					break;
+				if (ctrlc()) {
+					puts("\nAbort\n");
+					goto out;
+				}
+				mbps = membench_run(op, dst, src,
+						    membench_sizes[i]);
+				printf(" %7lu", mbps);
+			}
+			puts("\n");
+		}
+	}
+
+out:
+	free(dst_buf);
+	free(src_buf);
+
+	return CMD_RET_SUCCESS;
+}
+
+U_BOOT_CMD(
+	membench,	2,	1,	do_membench,
+	"measure the speed of the memory routines",
+	"[size]\n"
+	"    - report MB/s of memcpy, memmove, memset and memcmp for sizes\n"
+	"      up to 'size' bytes (hex, default 0x100000) and for aligned and\n"
+	"      misaligned destinations and sources"
+);
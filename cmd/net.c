@@ -10,6 +10,7 @@
  */
 #include <common.h>
 #include <command.h>
+#include <dm.h>
 #include <net.h>
 
 static int netboot_common(enum proto_t, cmd_tbl_t *, int, char * const []);
@@ -442,3 +443,74 @@ U_BOOT_CMD(
 );
 
 #endif  /* CONFIG_CMD_LINK_LOCAL */
+
+#if defined(CONFIG_CMD_NET_STATS)
+static void net_stats_show(struct udevice *dev)
+{
+	struct eth_stats *stats = eth_get_stats(dev);
+
+	printf("eth%d: %s%s\n", dev->seq, dev->name,
+	       dev == eth_get_dev() ? " [active]" : "");
+	printf("  rx: %lu packets, %lu bytes, %lu copied\n",
+	       stats->rx_packets, stats->rx_bytes, stats->rx_copies);
+	printf("      %lu dropped, %lu errors\n", stats->rx_dropped,
+	       stats->rx_errors);
+	printf("  tx: %lu packets, %lu bytes, %lu errors\n",
+	       stats->tx_packets, stats->tx_bytes, stats->tx_errors);
+}
+
+static int do_net_stats(cmd_tbl_t *cmdtp, int flag, int argc,
+			char * const argv[])
+{
+	struct udevice *dev;
+	bool reset = false;
+
+	if (argc > 2)
+		return CMD_RET_USAGE;
+	if (argc == 2) {
+		if (strcmp(argv[1], "reset"))
+			return CMD_RET_USAGE;
+		reset = true;
+	}
+
+	for (uclass_first_device(UCLASS_ETH, &dev); dev;
+	     uclass_next_device(&dev)) {
+		if (reset)
+			eth_reset_stats(dev);
+		else
+			net_stats_show(dev);
+	}
+
+	return CMD_RET_SUCCESS;
+}
+
+static cmd_tbl_t cmd_net_sub[] = {
+	U_BOOT_CMD_MKENT(stats, 2, 0, do_net_stats, "", ""),
+};
+
+static int do_net(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	cmd_tbl_t *c;
+
+	if (argc < 2)
+		return CMD_RET_USAGE;
+
+	/* Strip off leading argument */
+	argc--;
+	argv++;
+
+	c = find_cmd_tbl(argv[0], cmd_net_sub, ARRAY_SIZE(cmd_net_sub));
+	if (!c)
+		return CMD_RET_USAGE;
+
+	return c->cmd(cmdtp, flag, argc, argv);
+}
+
+U_BOOT_CMD(
+	net,	3,	1,	do_net,
+	"network interface information",
+	"stats - show per-interface packet counters\n"
+	"net stats reset - clear the packet counters"
+);
+
+#endif  /* CONFIG_CMD_NET_STATS */
@@ -153,11 +153,81 @@ static int do_spi_flash_probe(int argc, char * const argv[])
 	return 0;
 }
 
+/**
+ * Check whether flash holding @old can be changed to @new by programming
+ * alone, i.e. whether no bit needs to go from 0 to 1.
+ *
+ * @param old		current flash contents
+ * @param new		wanted flash contents
+ * @param len		number of bytes to check
+ * @return true if an erase is needed, false if not
+ */
+static bool spi_flash_needs_erase(const char *old, const char *new, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		if (new[i] & ~old[i])
+			return true;
+	}
+
+	return false;
+}
+
+/**
+ * Program the pages of a region which differ from what is in flash. Runs of
+ * changed pages are written with a single call.
+ *
+ * @param flash		flash context pointer
+ * @param offset	flash offset to write
+ * @param len		number of bytes to write
+ * @param buf		buffer to write from
+ * @param old		current flash contents, or NULL if the region is erased
+ * @param skipped	Count of skipped data (incremented by this function)
+ * @return 0 if OK, -ve on error
+ */
+static int spi_flash_write_changed(struct spi_flash *flash, u32 offset,
+		size_t len, const char *buf, const char *old, size_t *skipped)
+{
+	size_t pos, todo, start = 0;
+	bool changed;
+	int ret;
+
+	for (pos = 0; pos < len; pos += todo) {
+		todo = min_t(size_t, len - pos, flash->page_size);
+		if (old)
+			changed = memcmp(buf + pos, old + pos, todo) != 0;
+		else
+			changed = memchr_inv(buf + pos, 0xff, todo) != NULL;
+		if (changed)
+			continue;
+
+		if (old)
+			*skipped += todo;
+		if (pos > start) {
+			ret = spi_flash_write(flash, offset + start,
+					      pos - start, buf + start);
+			if (ret)
+				return ret;
+		}
+		start = pos + todo;
+	}
+	if (len > start)
+		return spi_flash_write(flash, offset + start, len - start,
+				       buf + start);
+
+	return 0;
+}
+
 /**
  * Write a block of data to SPI flash, first checking if it is different from
  * what is already there.
  *
  * If the data being written is the same, then *skipped is incremented by len.
+ * With CONFIG_CMD_SF_UPDATE_NO_ERASE, if only some pages differ and none of
+ * them needs a bit set back to 1, just those pages are programmed and the
+ * erase is avoided. After an erase, pages which are to hold only 0xff are not
+ * programmed.
  *
  * @param flash		flash context pointer
  * @param offset	flash offset to write
@@ -184,6 +254,16 @@ static const char *spi_flash_update_block(struct spi_flash *flash, u32 offset,
 		*skipped += len;
 		return NULL;
 	}
+	/* Avoid the erase if programming the changed pages is enough */
+	if (IS_ENABLED(CONFIG_CMD_SF_UPDATE_NO_ERASE) &&
+	    !spi_flash_needs_erase(cmp_buf, buf, len)) {
+		debug("Program region %x size %zx without erase\n",
+		      offset, len);
+		if (spi_flash_write_changed(flash, offset, len, buf, cmp_buf,
+					    skipped))
+			return "write";
+		return NULL;
+	}
 	/* Erase the entire sector */
 	if (spi_flash_erase(flash, offset, flash->sector_size))
 		return "erase";
@@ -192,8 +272,9 @@ static const char *spi_flash_update_block(struct spi_flash *flash, u32 offset,
 		memcpy(cmp_buf, buf, len);
 		ptr = cmp_buf;
 	}
-	/* Write one complete sector */
-	if (spi_flash_write(flash, offset, flash->sector_size, ptr))
+	/* Write one complete sector, skipping pages left erased */
+	if (spi_flash_write_changed(flash, offset, flash->sector_size, ptr,
+				    NULL, skipped))
 		return "write";
 
 	return NULL;
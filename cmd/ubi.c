@@ -85,6 +85,13 @@ static void display_ubi_info(struct ubi_device *ubi)
 	ubi_msg("number of PEBs reserved for bad PEB handling: %d",
 			ubi->beb_rsvd_pebs);
 	ubi_msg("max/mean erase counter: %d/%d", ubi->max_ec, ubi->mean_ec);
+	ubi_msg("attached from:              %s (%d PEBs scanned)",
+			ubi->attach_fastmap ? "fastmap" : "full scan",
+			ubi->attach_scanned);
+	ubi_msg("attach time: scan %lu ms, vtbl %lu ms, WL %lu ms, EBA %lu ms, fastmap write %lu ms",
+			ubi->attach_scan_ms, ubi->attach_vtbl_ms,
+			ubi->attach_wl_ms, ubi->attach_eba_ms,
+			ubi->attach_fm_ms);
 }
 
 static int ubi_info(int layout)
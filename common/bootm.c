@@ -451,6 +451,8 @@ static int bootm_load_os(bootm_headers_t *images, unsigned long *load_end,
 
 	debug("   kernel loaded at 0x%08lx, end = 0x%08lx\n", load, *load_end);
 	bootstage_mark(BOOTSTAGE_ID_KERNEL_LOADED);
+	if (os.comp == IH_COMP_NONE)
+		boot_place_count(load == image_start ? 0 : image_len);
 
 	no_overlap = (os.comp == IH_COMP_NONE && load == image_start);
 
@@ -653,10 +655,14 @@ int do_bootm_states(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 #if IMAGE_ENABLE_OF_LIBFDT && defined(CONFIG_LMB)
 	if (!ret && (states & BOOTM_STATE_FDT)) {
 		boot_fdt_add_mem_rsv_regions(&images->lmb, images->ft_addr);
+		boot_fdt_reserve_container(images);
 		ret = boot_relocate_fdt(&images->lmb, &images->ft_addr,
 					&images->ft_len);
 	}
 #endif
+	if (!ret && (states & (BOOTM_STATE_LOADOS | BOOTM_STATE_RAMDISK |
+			       BOOTM_STATE_FDT)))
+		boot_place_report();
 
 	/* From now on, we need the OS boot function */
 	if (ret)
@@ -681,6 +687,10 @@ int do_bootm_states(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 	if (!ret && (states & BOOTM_STATE_OS_BD_T))
 		ret = boot_fn(BOOTM_STATE_OS_BD_T, argc, argv, images);
 	if (!ret && (states & BOOTM_STATE_OS_PREP)) {
+#ifdef CONFIG_PCI_LAZY_ENUM
+		/* The OS expects every PCI device to have its resources */
+		pci_init();
+#endif
 #if defined(CONFIG_SILENT_CONSOLE) && !defined(CONFIG_SILENT_U_BOOT_ONLY)
 		if (images->os.os == IH_OS_LINUX)
 			fixup_silent_linux();
@@ -272,6 +272,7 @@ void do_bootvx_fdt(bootm_headers_t *images)
 
 	if (*of_flat_tree) {
 		boot_fdt_add_mem_rsv_regions(lmb, *of_flat_tree);
+		boot_fdt_reserve_container(images);
 
 		ret = boot_relocate_fdt(lmb, of_flat_tree, &of_size);
 		if (ret)
@@ -1589,6 +1589,9 @@ static int run_pipe_real(struct pipe *pi)
 #endif
 		return rcode;
 	} else if (pi->num_progs == 1 && pi->progs[0].argv != NULL) {
+		/* the parsed pipe may be run again, so leave child->sp alone */
+		int sp = child->sp;
+
 		for (i=0; is_assignment(child->argv[i]); i++) { /* nothing */ }
 		if (i!=0 && child->argv[i]==NULL) {
 			/* assignments, but no command: set the local environment */
@@ -1627,11 +1630,11 @@ static int run_pipe_real(struct pipe *pi)
 			set_local_var(p, 0);
 #endif
 			if (p != child->argv[i]) {
-				child->sp--;
+				sp--;
 				free(p);
 			}
 		}
-		if (child->sp) {
+		if (sp) {
 			char * str = NULL;
 
 			str = make_string(child->argv + i,
@@ -1759,11 +1762,28 @@ static int run_pipe_real(struct pipe *pi)
 	return -1;
 }
 
+#ifdef __U_BOOT__
+/* Put back the loop variable of a "for" left early, so that a cached
+ * parse of the list can be run again. */
+static void abort_for_loop(struct pipe *pi, char *save_name, char **list,
+			   char **save_list)
+{
+	free(pi->progs->argv[0]);
+	while (*list)
+		free(*list++);
+	free(save_list);
+	pi->progs->argv[0] = save_name;
+}
+#endif
+
 static int run_list_real(struct pipe *pi)
 {
 	char *save_name = NULL;
 	char **list = NULL;
 	char **save_list = NULL;
+#ifdef __U_BOOT__
+	struct pipe *for_pipe = NULL;
+#endif
 	struct pipe *rpipe;
 	int flag_rep = 0;
 #ifndef __U_BOOT__
@@ -1803,6 +1823,10 @@ static int run_list_real(struct pipe *pi)
 				/* check Ctrl-C */
 				ctrlc();
 				if ((had_ctrlc())) {
+					if (list)
+						abort_for_loop(for_pipe,
+							       save_name, list,
+							       save_list);
 					return 1;
 				}
 #endif
@@ -1832,6 +1856,9 @@ static int run_list_real(struct pipe *pi)
 				list = make_list_in(pi->next->progs->argv,
 					pi->progs->argv[0]);
 				save_list = list;
+#ifdef __U_BOOT__
+				for_pipe = pi;
+#endif
 				save_name = pi->progs->argv[0];
 				pi->progs->argv[0] = NULL;
 				flag_rep = 1;
@@ -1903,6 +1930,9 @@ static int run_list_real(struct pipe *pi)
 #else
 		if (rcode < -1) {
 			last_return_code = -rcode - 2;
+			if (list)
+				abort_for_loop(for_pipe, save_name, list,
+					       save_list);
 			return -2;	/* exit */
 		}
 		last_return_code=(rcode == 0) ? 0 : 1;
@@ -1923,6 +1953,10 @@ static int run_list_real(struct pipe *pi)
 		checkjobs(NULL);
 #endif
 	}
+#ifdef __U_BOOT__
+	if (list)
+		abort_for_loop(for_pipe, save_name, list, save_list);
+#endif
 	return rcode;
 }
 
@@ -3284,6 +3318,168 @@ int parse_string_outer(const char *s, int flag)
 #endif
 }
 
+#ifdef CONFIG_HUSH_PARSE_CACHE
+/*
+ * Parsed scripts of environment variables that were run with 'run'.
+ * The distro boot scripts run the same handful of variables over and over
+ * for every device, partition and prefix, so keep their pipe lists around
+ * and only parse again when the text of the variable has changed.
+ */
+struct hush_cache_entry {
+	char *name;
+	char *text;		/* text the list was parsed from */
+	struct pipe *list;
+	int busy;		/* the list is being run */
+	ulong stamp;		/* last use, for eviction */
+};
+
+static struct hush_cache_entry hush_cache[CONFIG_HUSH_PARSE_CACHE_ENTRIES];
+static ulong hush_cache_clock;
+static int hush_cache_off;
+
+static void hush_cache_drop(struct hush_cache_entry *ent)
+{
+	free_pipe_list(ent->list, 0);
+	free(ent->name);
+	free(ent->text);
+	memset(ent, 0, sizeof(*ent));
+}
+
+void hush_cache_flush(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(hush_cache); i++) {
+		if (hush_cache[i].name && !hush_cache[i].busy)
+			hush_cache_drop(&hush_cache[i]);
+	}
+}
+
+void hush_cache_enable(int enable)
+{
+	hush_cache_off = !enable;
+	if (!enable)
+		hush_cache_flush();
+}
+
+/* Parse a complete script into a pipe list without running it */
+static struct pipe *hush_compile(const char *s, int flag)
+{
+	struct in_str input;
+	struct p_context ctx;
+	o_string temp = NULL_O_STRING;
+	char *p;
+	int rcode;
+
+	p = xmalloc(strlen(s) + 2);
+	strcpy(p, s);
+	strcat(p, "\n");
+	setup_string_in_str(&input, p);
+
+	ctx.type = flag;
+	initialize_context(&ctx);
+	update_ifs_map();
+	if (!(flag & FLAG_PARSE_SEMICOLON))
+		mapset((uchar *)";$&|", 0);
+	input.promptmode = 1;
+	rcode = parse_stream(&temp, &ctx, &input, -1);
+	if (rcode != 1 && ctx.old_flag == 0) {
+		done_word(&temp, &ctx);
+		done_pipe(&ctx, PIPE_SEQ);
+	} else {
+		if (ctx.old_flag != 0)
+			free(ctx.stack);
+		free_pipe_list(ctx.list_head, 0);
+		ctx.list_head = NULL;
+	}
+	b_free(&temp);
+	free(p);
+
+	return ctx.list_head;
+}
+
+static struct hush_cache_entry *hush_cache_lookup(const char *name,
+						  const char *s, int flag)
+{
+	struct hush_cache_entry *ent, *victim = NULL;
+	struct pipe *list;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(hush_cache); i++) {
+		ent = &hush_cache[i];
+		if (!ent->name) {
+			if (!victim || victim->name)
+				victim = ent;
+			continue;
+		}
+		if (!strcmp(ent->name, name)) {
+			if (ent->busy)
+				return NULL;
+			if (!strcmp(ent->text, s))
+				return ent;
+			victim = ent;
+			break;
+		}
+		if (ent->busy)
+			continue;
+		if (!victim || (victim->name && ent->stamp < victim->stamp))
+			victim = ent;
+	}
+	if (!victim)
+		return NULL;
+
+	list = hush_compile(s, flag);
+	if (!list)
+		return NULL;
+	if (victim->name)
+		hush_cache_drop(victim);
+	victim->name = xstrdup(name);
+	victim->text = xstrdup(s);
+	victim->list = list;
+
+	return victim;
+}
+
+/*
+ * Run the script @s held in environment variable @name, using the cached
+ * parse of an earlier run if the variable has not changed since. Variables
+ * running themselves, syntax errors and a full cache go through
+ * parse_string_outer() as before.
+ */
+int parse_string_cached(const char *name, const char *s, int flag)
+{
+	struct hush_cache_entry *ent;
+	int code;
+
+	if (!s)
+		return 1;
+	if (!*s)
+		return 0;
+	if (hush_cache_off ||
+	    (flag & (FLAG_EXIT_FROM_LOOP | FLAG_CONT_ON_NEWLINE)) !=
+	    (FLAG_EXIT_FROM_LOOP | FLAG_CONT_ON_NEWLINE) ||
+	    (flag & FLAG_REPARSING))
+		return parse_string_outer(s, flag);
+
+	ent = hush_cache_lookup(name, s, flag);
+	if (!ent)
+		return parse_string_outer(s, flag);
+
+	ent->stamp = ++hush_cache_clock;
+	ent->busy = 1;
+	code = run_list_real(ent->list);
+	ent->busy = 0;
+
+	/* same as parse_stream_outer() for a string */
+	if (code == -2)
+		code = 0;
+	if (code == -1)
+		flag_repeat = 0;
+
+	return (code != 0) ? 1 : 0;
+}
+#endif /* CONFIG_HUSH_PARSE_CACHE */
+
 #ifndef __U_BOOT__
 static int parse_file_outer(FILE *f)
 #else
@@ -13,6 +13,95 @@
 #include <command.h>
 #include <console.h>
 #include <linux/ctype.h>
+#include <malloc.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#ifdef CONFIG_CMDLINE
+/*
+ * Command tables are searched in name order so that a command is found by
+ * binary search and the commands starting with an abbreviation form a
+ * range. The linker sorts the command linker list already, other tables
+ * get an index of entry pointers the first time they are searched.
+ */
+#define CMD_INDEX_TABLES	32
+#define CMD_INDEX_MIN_LEN	8	/* smaller tables are scanned */
+
+struct cmd_index {
+	cmd_tbl_t *table;
+	int len;
+	cmd_tbl_t **entry;	/* NULL if the table is in name order */
+};
+
+static struct cmd_index cmd_index[CMD_INDEX_TABLES];
+
+static int cmd_index_cmp(const void *a, const void *b)
+{
+	const cmd_tbl_t *ca = *(const cmd_tbl_t **)a;
+	const cmd_tbl_t *cb = *(const cmd_tbl_t **)b;
+
+	return strcmp(ca->name, cb->name);
+}
+
+static struct cmd_index *cmd_get_index(cmd_tbl_t *table, int table_len)
+{
+	struct cmd_index *idx, *free_idx = NULL;
+	int i;
+
+	/* BSS is not available before relocation */
+	if (table_len < CMD_INDEX_MIN_LEN || !(gd->flags & GD_FLG_RELOC))
+		return NULL;
+
+	for (idx = cmd_index; idx != cmd_index + CMD_INDEX_TABLES; idx++) {
+		if (idx->table == table && idx->len == table_len)
+			return idx;
+		if (!idx->table && !free_idx)
+			free_idx = idx;
+	}
+	idx = free_idx;
+	if (!idx)
+		return NULL;
+
+	for (i = 1; i < table_len; i++) {
+		if (strcmp(table[i - 1].name, table[i].name) > 0)
+			break;
+	}
+	if (i < table_len) {
+		idx->entry = malloc(table_len * sizeof(*idx->entry));
+		if (!idx->entry)
+			return NULL;
+		for (i = 0; i < table_len; i++)
+			idx->entry[i] = &table[i];
+		qsort(idx->entry, table_len, sizeof(*idx->entry),
+		      cmd_index_cmp);
+	}
+	idx->table = table;
+	idx->len = table_len;
+
+	return idx;
+}
+
+static cmd_tbl_t *cmd_index_at(struct cmd_index *idx, int i)
+{
+	return idx->entry ? idx->entry[i] : &idx->table[i];
+}
+
+/* Find the first entry not below the first @len characters of @cmd */
+static int cmd_index_lower(struct cmd_index *idx, const char *cmd, int len)
+{
+	int lo = 0, hi = idx->len, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (strncmp(cmd_index_at(idx, mid)->name, cmd, len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+#endif /* CONFIG_CMDLINE */
 
 /*
  * Use puts() instead of printf() to avoid printf buffer overflow
@@ -89,7 +178,8 @@ cmd_tbl_t *find_cmd_tbl(const char *cmd, cmd_tbl_t *table, int table_len)
 	cmd_tbl_t *cmdtp;
 	cmd_tbl_t *cmdtp_temp = table;	/* Init value */
 	const char *p;
-	int len;
+	struct cmd_index *idx;
+	int len, i;
 	int n_found = 0;
 
 	if (!cmd)
@@ -100,6 +190,22 @@ cmd_tbl_t *find_cmd_tbl(const char *cmd, cmd_tbl_t *table, int table_len)
 	 */
 	len = ((p = strchr(cmd, '.')) == NULL) ? strlen (cmd) : (p - cmd);
 
+	idx = cmd_get_index(table, table_len);
+	if (idx) {
+		/* a full match sorts first among the names it starts */
+		for (i = cmd_index_lower(idx, cmd, len); i < idx->len; i++) {
+			cmdtp = cmd_index_at(idx, i);
+			if (strncmp(cmdtp->name, cmd, len))
+				break;
+			if (!cmdtp->name[len])
+				return cmdtp;
+			if (++n_found > 1)
+				return NULL;
+			cmdtp_temp = cmdtp;
+		}
+		return n_found ? cmdtp_temp : NULL;
+	}
+
 	for (cmdtp = table; cmdtp != table + table_len; cmdtp++) {
 		if (strncmp(cmd, cmdtp->name, len) == 0) {
 			if (len == strlen(cmdtp->name))
@@ -168,8 +274,9 @@ static int complete_cmdv(int argc, char * const argv[], char last_char, int maxv
 	cmd_tbl_t *cmdtp = ll_entry_start(cmd_tbl_t, cmd);
 	const int count = ll_entry_count(cmd_tbl_t, cmd);
 	const cmd_tbl_t *cmdend = cmdtp + count;
+	struct cmd_index *idx;
 	const char *p;
-	int len, clen;
+	int len, i;
 	int n_found = 0;
 	const char *cmd;
 
@@ -213,15 +320,16 @@ static int complete_cmdv(int argc, char * const argv[], char last_char, int maxv
 	else
 		len = p - cmd;
 
-	/* return the partial matches */
-	for (; cmdtp != cmdend; cmdtp++) {
-
-		clen = strlen(cmdtp->name);
-		if (clen < len)
-			continue;
+	/* return the partial matches, a range of the index if there is one */
+	idx = cmd_get_index(cmdtp, count);
+	for (i = idx ? cmd_index_lower(idx, cmd, len) : 0; i < count; i++) {
+		const cmd_tbl_t *ent = idx ? cmd_index_at(idx, i) : cmdtp + i;
 
-		if (memcmp(cmd, cmdtp->name, len) != 0)
+		if (strncmp(ent->name, cmd, len) != 0) {
+			if (idx)
+				break;
 			continue;
+		}
 
 		/* too many! */
 		if (n_found >= maxv - 2) {
@@ -229,7 +337,7 @@ static int complete_cmdv(int argc, char * const argv[], char last_char, int maxv
 			break;
 		}
 
-		cmdv[n_found++] = cmdtp->name;
+		cmdv[n_found++] = ent->name;
 	}
 
 	cmdv[n_found] = NULL;
@@ -9,6 +9,7 @@
 #include <console.h>
 #include <debug_uart.h>
 #include <dm.h>
+#include <dm/async.h>
 #include <stdarg.h>
 #include <iomux.h>
 #include <malloc.h>
@@ -418,6 +419,8 @@ int tstc(void)
 
 	if (!gd->have_console)
 		return 0;
+	/* Let background operations move along while waiting for input */
+	dm_async_poll();
 #ifdef CONFIG_CONSOLE_RECORD
 	if (gd->console_in.start) {
 		if (membuff_peekbyte(&gd->console_in) != -1)
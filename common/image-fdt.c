@@ -92,6 +92,36 @@ void boot_fdt_add_mem_rsv_regions(struct lmb *lmb, void *fdt_blob)
 	}
 }
 
+/**
+ * boot_fdt_reserve_container - protect the image the fdt was taken from
+ * @images: pointer to the bootm images structure
+ *
+ * If the device tree sits inside a FIT or multi-component image, reserve
+ * that image in the lmb. boot_relocate_fdt() then neither relocates the
+ * device tree on top of it nor pads the device tree in place into the
+ * image data following it.
+ */
+void boot_fdt_reserve_container(bootm_headers_t *images)
+{
+	ulong fdt = (ulong)images->ft_addr;
+	ulong start = 0, end = 0;
+
+	if (!fdt)
+		return;
+#if IMAGE_ENABLE_FIT
+	if (images->fit_hdr_fdt) {
+		start = (ulong)images->fit_hdr_fdt;
+		end = start + fdt_totalsize(images->fit_hdr_fdt);
+	}
+#endif
+	if (fdt < start || fdt >= end) {
+		start = (ulong)map_sysmem(images->os.start, 0);
+		end = start + images->os.end - images->os.start;
+	}
+	if (fdt >= start && fdt < end)
+		lmb_reserve(&images->lmb, start, end - start);
+}
+
 /**
  * boot_relocate_fdt - relocate flat device tree
  * @lmb: pointer to lmb handle, will be used for memory mgmt
@@ -141,23 +171,21 @@ int boot_relocate_fdt(struct lmb *lmb, char **of_flat_tree, ulong *of_size)
 			of_start = fdt_blob;
 			lmb_reserve(lmb, (ulong)of_start, of_len);
 			disable_relocation = 1;
-		} else if (desired_addr) {
-			of_start =
-			    (void *)(ulong) lmb_alloc_base(lmb, of_len, 0x1000,
-							   (ulong)desired_addr);
-			if (of_start == NULL) {
+		} else {
+			/* Keep the fdt where it is if that is allowed */
+			of_start = (void *)boot_place_image(lmb,
+					(ulong)fdt_blob, of_len, 0x1000,
+					(ulong)desired_addr);
+			if (of_start == NULL && desired_addr) {
 				puts("Failed using fdt_high value for Device Tree");
 				goto error;
 			}
-		} else {
-			of_start =
-			    (void *)(ulong) lmb_alloc(lmb, of_len, 0x1000);
 		}
 	} else {
-		of_start =
-		    (void *)(ulong) lmb_alloc_base(lmb, of_len, 0x1000,
-						   env_get_bootm_mapsize()
-						   + env_get_bootm_low());
+		of_start = (void *)boot_place_image(lmb, (ulong)fdt_blob,
+						    of_len, 0x1000,
+						    env_get_bootm_mapsize() +
+						    env_get_bootm_low());
 	}
 
 	if (of_start == NULL) {
@@ -173,6 +201,15 @@ int boot_relocate_fdt(struct lmb *lmb, char **of_flat_tree, ulong *of_size)
 		fdt_set_totalsize(of_start, of_len);
 		printf("   Using Device Tree in place at %p, end %p\n",
 		       of_start, of_start + of_len - 1);
+	} else if (of_start == fdt_blob) {
+		/* The padding after the fdt is free memory, grow in place */
+		err = fdt_open_into(fdt_blob, of_start, of_len);
+		if (err != 0) {
+			fdt_error("fdt resize failed");
+			goto error;
+		}
+		printf("   Using Device Tree in place at %p, end %p\n",
+		       of_start, of_start + of_len - 1);
 	} else {
 		debug("## device tree at %p ... %p (len=%ld [0x%lX])\n",
 		      fdt_blob, fdt_blob + *of_size - 1, of_len, of_len);
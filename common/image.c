@@ -1110,6 +1110,88 @@ int boot_get_ramdisk(int argc, char * const argv[], bootm_headers_t *images,
 	return 0;
 }
 
+#ifdef CONFIG_LMB
+/* Copies avoided and bytes copied while placing boot image components */
+static uint boot_place_skipped;
+static ulong boot_place_moved;
+
+/**
+ * boot_place_image - choose the final location of a boot image component
+ * @lmb: pointer to lmb handle, will be used for memory mgmt
+ * @addr: current address of the component
+ * @size: number of bytes the component needs at its final location
+ * @align: required alignment of the final location
+ * @max_addr: the component must end at or below this address, 0 for none
+ *
+ * boot_place_image() leaves the component where it was loaded if that
+ * location meets the constraints and does not overlap memory that is
+ * already reserved for the kernel or other components. Only otherwise a
+ * new location is allocated, which the caller has to copy the component
+ * to. The chosen location is reserved in @lmb either way.
+ *
+ * returns:
+ *     final address of the component, 0 if no suitable memory is free
+ */
+ulong boot_place_image(struct lmb *lmb, ulong addr, ulong size, ulong align,
+		       ulong max_addr)
+{
+	ulong dest;
+
+	if (!(addr & (align - 1)) && (!max_addr || addr + size <= max_addr) &&
+	    lmb_alloc_addr(lmb, addr, size) == addr) {
+		debug("   in-place at 0x%08lx, len 0x%lx\n", addr, size);
+		boot_place_skipped++;
+		return addr;
+	}
+
+	if (max_addr)
+		dest = lmb_alloc_base(lmb, size, align, max_addr);
+	else
+		dest = lmb_alloc(lmb, size, align);
+	if (dest)
+		boot_place_count(size);
+
+	return dest;
+}
+
+/**
+ * boot_place_count - account for a boot image component being placed
+ * @moved: number of bytes copied to place the component, 0 if it was
+ *	used in place
+ */
+void boot_place_count(ulong moved)
+{
+	if (moved)
+		boot_place_moved += moved;
+	else
+		boot_place_skipped++;
+}
+
+/**
+ * boot_place_report - record how boot image components were placed
+ *
+ * Marks the end of placing the components in bootstage, with the number of
+ * components used in place and of bytes copied since the last report in
+ * the name of the record.
+ *
+ * bootstage keeps only the first mark of an ID and refers to its name
+ * without copying it. The name is therefore kept in a static buffer, which
+ * holds the counts of the latest report.
+ */
+void boot_place_report(void)
+{
+	static char name[64];
+
+	snprintf(name, sizeof(name),
+		 "bootm_place: %u in place, %lu bytes moved",
+		 boot_place_skipped, boot_place_moved);
+	debug("## %s\n", name);
+	bootstage_mark_name(BOOTSTAGE_ID_BOOTM_PLACE, name);
+	boot_place_skipped = 0;
+	boot_place_moved = 0;
+}
+#endif /* CONFIG_LMB */
+
 #ifdef CONFIG_SYS_BOOT_RAMDISK_HIGH
 /**
  * boot_ramdisk_high - relocate init ramdisk
@@ -1161,26 +1243,30 @@ int boot_ramdisk_high(struct lmb *lmb, ulong rd_data, ulong rd_len,
 			*initrd_start = rd_data;
 			*initrd_end = rd_data + rd_len;
 			lmb_reserve(lmb, rd_data, rd_len);
+			boot_place_count(0);
 		} else {
-			if (initrd_high)
-				*initrd_start = (ulong)lmb_alloc_base(lmb,
-						rd_len, 0x1000, initrd_high);
-			else
-				*initrd_start = (ulong)lmb_alloc(lmb, rd_len,
-								 0x1000);
-
+			/* Keep the ramdisk where it is if that is allowed */
+			*initrd_start = boot_place_image(lmb, rd_data, rd_len,
+							 0x1000, initrd_high);
 			if (*initrd_start == 0) {
 				puts("ramdisk - allocation error\n");
 				goto error;
 			}
-			bootstage_mark(BOOTSTAGE_ID_COPY_RAMDISK);
 
 			*initrd_end = *initrd_start + rd_len;
-			printf("   Loading Ramdisk to %08lx, end %08lx ... ",
-					*initrd_start, *initrd_end);
-
-			memmove_wd((void *)*initrd_start,
-					(void *)rd_data, rd_len, CHUNKSZ);
+			if (*initrd_start == rd_data) {
+				printf("   Using Ramdisk in place at %08lx, end %08lx\n",
+				       *initrd_start, *initrd_end);
+			} else {
+				bootstage_mark(BOOTSTAGE_ID_COPY_RAMDISK);
+				printf("   Loading Ramdisk to %08lx, end %08lx ... ",
+				       *initrd_start, *initrd_end);
+
+				memmove_wd(map_sysmem(*initrd_start, rd_len),
+					   map_sysmem(rd_data, rd_len), rd_len,
+					   CHUNKSZ);
+				puts("OK\n");
+			}
 
 #ifdef CONFIG_MP
 			/*
@@ -1191,7 +1277,6 @@ int boot_ramdisk_high(struct lmb *lmb, ulong rd_data, ulong rd_len,
 			flush_cache((unsigned long)*initrd_start,
 				    ALIGN(rd_len, ARCH_DMA_MINALIGN));
 #endif
-			puts("OK\n");
 		}
 	} else {
 		*initrd_start = 0;
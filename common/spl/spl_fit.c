@@ -9,6 +9,8 @@
 #include <errno.h>
 #include <image.h>
 #include <linux/libfdt.h>
+#include <lzma/LzmaTypes.h>
+#include <lzma/LzmaTools.h>
 #include <spl.h>
 
 #ifndef CONFIG_SYS_BOOTM_LEN
@@ -141,6 +143,52 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
 	return (data_size + info->bl_len - 1) / info->bl_len;
 }
 
+/* Check whether SPL can decompress any image */
+static inline bool spl_fit_decompression_enabled(void)
+{
+	return IS_ENABLED(CONFIG_SPL_GZIP) || IS_ENABLED(CONFIG_SPL_LZMA) ||
+		IS_ENABLED(CONFIG_SPL_LZ4);
+}
+
+/**
+ * spl_fit_decompress(): decompress an image to its load address
+ * @comp:	compression type of the image (IH_COMP_...)
+ * @dst:	where to write the uncompressed image
+ * @src:	the compressed image
+ * @sizep:	on entry the size of the compressed image, on exit the size
+ *		of the uncompressed one
+ *
+ * Return:	0 on success, -ENOTSUPP if SPL does not support @comp, or
+ *		-EIO if the image is corrupted or too large
+ */
+static int spl_fit_decompress(int comp, void *dst, void *src, size_t *sizep)
+{
+	int ret = -ENOTSUPP;
+
+	if (IS_ENABLED(CONFIG_SPL_GZIP) && comp == IH_COMP_GZIP) {
+		unsigned long size = *sizep;
+
+		ret = gunzip(dst, CONFIG_SYS_BOOTM_LEN, src, &size);
+		*sizep = size;
+	} else if (IS_ENABLED(CONFIG_SPL_LZMA) && comp == IH_COMP_LZMA) {
+		SizeT size = CONFIG_SYS_BOOTM_LEN;
+
+		ret = lzmaBuffToBuffDecompress(dst, &size, src, *sizep);
+		*sizep = size;
+	} else if (IS_ENABLED(CONFIG_SPL_LZ4) && comp == IH_COMP_LZ4) {
+		size_t size = CONFIG_SYS_BOOTM_LEN;
+
+		ret = ulz4fn(src, *sizep, dst, &size);
+		*sizep = size;
+	}
+	if (ret && ret != -ENOTSUPP) {
+		puts("Uncompressing error\n");
+		return -EIO;
+	}
+
+	return ret;
+}
+
 /**
  * spl_load_fit_image(): load the image described in a certain FIT node
  * @info:	points to information about the device to load data from
@@ -156,6 +204,12 @@ static int get_aligned_image_size(struct spl_load_info *info, int data_size,
  *		the image gets loaded to the address pointed to by the
  *		load_addr member in this struct.
  *
+ * External data is read straight to the load address when the load address
+ * and the position of the data on the device allow it. Compressed images are
+ * read to CONFIG_SYS_LOAD_ADDR and decompressed from there (or from the FIT,
+ * for embedded data) to the load address. Hashes are checked on the data as
+ * stored in the FIT, before it is copied or decompressed.
+ *
  * Return:	0 on success or a negative error number.
  */
 static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
@@ -165,29 +219,21 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	int offset;
 	size_t length;
 	int len;
-	ulong size;
 	ulong load_addr, load_ptr;
 	void *src;
 	ulong overhead;
 	int nr_sectors;
 	int align_len = ARCH_DMA_MINALIGN - 1;
-	uint8_t image_comp = -1, type = -1;
+	uint8_t image_comp = IH_COMP_NONE;
 	const void *data;
 	bool external_data = false;
-#ifdef CONFIG_SPL_FIT_SIGNATURE
 	int ret;
-#endif
 
-	if (IS_ENABLED(CONFIG_SPL_OS_BOOT) && IS_ENABLED(CONFIG_SPL_GZIP)) {
+	if (spl_fit_decompression_enabled()) {
 		if (fit_image_get_comp(fit, node, &image_comp))
 			puts("Cannot get image compression format.\n");
 		else
 			debug("%s ", genimg_get_comp_name(image_comp));
-
-		if (fit_image_get_type(fit, node, &type))
-			puts("Cannot get image type.\n");
-		else
-			debug("%s ", genimg_get_type_name(type));
 	}
 
 	if (fit_image_get_load(fit, node, &load_addr))
@@ -205,12 +251,24 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		if (fit_image_get_data_size(fit, node, &len))
 			return -ENOENT;
 
-		load_ptr = (load_addr + align_len) & ~align_len;
 		length = len;
 
 		overhead = get_aligned_image_overhead(info, offset);
 		nr_sectors = get_aligned_image_size(info, length, offset);
 
+		/*
+		 * Compressed data cannot be decompressed in place, so read it
+		 * out of the way. Otherwise read it to the load address if
+		 * that needs no copy afterwards.
+		 */
+		if (image_comp != IH_COMP_NONE)
+			load_ptr = (CONFIG_SYS_LOAD_ADDR + align_len) &
+				~align_len;
+		else if (!overhead && !(load_addr & align_len))
+			load_ptr = load_addr;
+		else
+			load_ptr = (load_addr + align_len) & ~align_len;
+
 		if (info->read(info,
 			       sector + get_aligned_image_offset(info, offset),
 			       nr_sectors, (void *)load_ptr) != nr_sectors)
@@ -234,19 +292,24 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 	board_fit_image_post_process(&src, &length);
 #endif
 
-	if (IS_ENABLED(CONFIG_SPL_OS_BOOT)	&&
-	    IS_ENABLED(CONFIG_SPL_GZIP)		&&
-	    image_comp == IH_COMP_GZIP		&&
-	    type == IH_TYPE_KERNEL) {
-		size = length;
-		if (gunzip((void *)load_addr, CONFIG_SYS_BOOTM_LEN,
-			   src, &size)) {
-			puts("Uncompressing error\n");
-			return -EIO;
-		}
-		length = size;
-	} else {
-		memcpy((void *)load_addr, src, length);
+#ifdef CONFIG_SPL_FIT_SIGNATURE
+	printf("## Checking hash(es) for Image %s ...\n",
+	       fit_get_name(fit, node, NULL));
+	ret = fit_image_verify_with_data(fit, node, src, length);
+	printf("\n");
+	if (!ret)
+		return -EPERM;
+#endif
+
+	ret = -ENOTSUPP;
+	if (image_comp != IH_COMP_NONE)
+		ret = spl_fit_decompress(image_comp, (void *)load_addr, src,
+					 &length);
+	if (ret == -ENOTSUPP) {
+		if (src != (void *)load_addr)
+			memmove((void *)load_addr, src, length);
+	} else if (ret) {
+		return ret;
 	}
 
 	if (image_info) {
@@ -255,16 +318,7 @@ static int spl_load_fit_image(struct spl_load_info *info, ulong sector,
 		image_info->entry_point = fdt_getprop_u32(fit, node, "entry");
 	}
 
-#ifdef CONFIG_SPL_FIT_SIGNATURE
-	printf("## Checking hash(es) for Image %s ...\n",
-	       fit_get_name(fit, node, NULL));
-	ret = fit_image_verify_with_data(fit, node,
-					 (const void *)load_addr, length);
-	printf("\n");
-	return !ret;
-#else
 	return 0;
-#endif
 }
 
 static int spl_fit_append_fdt(struct spl_image_info *spl_image,
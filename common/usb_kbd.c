@@ -107,6 +107,9 @@ struct usb_kbd_pdata {
 	int		intinterval;
 	unsigned long	last_report;
 	struct int_queue *intq;
+#if defined(CONFIG_SYS_USB_EVENT_POLL) && defined(CONFIG_DM_USB)
+	struct usb_request req;
+#endif
 
 	uint32_t	repeat_delay;
 
@@ -315,12 +318,27 @@ static inline void usb_kbd_poll_for_event(struct usb_device *dev)
 {
 #if defined(CONFIG_SYS_USB_EVENT_POLL)
 	struct usb_kbd_pdata *data = dev->privptr;
+#ifdef CONFIG_DM_USB
+	int ret;
+
+	/*
+	 * The report request stays queued on the controller between calls,
+	 * so this does not wait for the keyboard
+	 */
+	ret = usb_poll_request(&data->req);
+	if (ret == -EINPROGRESS)
+		return;
+	if (!ret)
+		usb_kbd_irq_worker(dev);
+	usb_submit_request(&data->req);
+#else
 
 	/* Submit a interrupt transfer request */
 	usb_submit_int_msg(dev, data->intpipe, &data->new[0], data->intpktsize,
 			   data->intinterval);
 
 	usb_kbd_irq_worker(dev);
+#endif
 #elif defined(CONFIG_SYS_USB_EVENT_POLL_VIA_CONTROL_EP) || \
       defined(CONFIG_SYS_USB_EVENT_POLL_VIA_INT_QUEUE)
 #if defined(CONFIG_SYS_USB_EVENT_POLL_VIA_CONTROL_EP)
@@ -489,6 +507,19 @@ static int usb_kbd_probe_dev(struct usb_device *dev, unsigned int ifnum)
 		return 0;
 	}
 
+#if defined(CONFIG_SYS_USB_EVENT_POLL) && defined(CONFIG_DM_USB)
+	/* Keep a report request queued from now on */
+	data->req.udev = dev;
+	data->req.pipe = data->intpipe;
+	data->req.buffer = data->new;
+	data->req.length = data->intpktsize;
+	data->req.interval = data->intinterval;
+	if (usb_submit_request(&data->req)) {
+		printf("Failed to queue keyboard report request\n");
+		return 0;
+	}
+#endif
+
 	/* Success. */
 	return 1;
 }
@@ -634,6 +665,8 @@ static int usb_kbd_remove(struct udevice *dev)
 #endif
 #ifdef CONFIG_SYS_USB_EVENT_POLL_VIA_INT_QUEUE
 	destroy_int_queue(udev, data->intq);
+#elif defined(CONFIG_SYS_USB_EVENT_POLL)
+	usb_cancel_request(&data->req);
 #endif
 	free(data->new);
 	free(data);
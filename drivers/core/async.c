@@ -0,0 +1,128 @@
+/*
+ * Operations started by drivers which complete in the background
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <dm/async.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Operations in progress, in the order they were started */
+static LIST_HEAD(async_list);
+
+/* Set while poll functions run, so that they are not called recursively */
+static bool async_polling;
+
+/* Incremented when operations are added or removed */
+static uint async_changes;
+
+/* Call the poll function of @op if its deadline has passed */
+static void async_run(struct dm_async *op)
+{
+	bool polling = async_polling;
+	int ret;
+
+	if ((long)(get_timer(0) - op->deadline) < 0)
+		return;
+
+	async_polling = true;
+	ret = op->poll(op);
+	async_polling = polling;
+	if (ret == -EAGAIN)
+		return;
+
+	debug("%s: %s %s: %d\n", __func__, op->dev ? op->dev->name : "",
+	      op->name, ret);
+	list_del(&op->node);
+	async_changes++;
+	op->ret = ret;
+}
+
+int dm_async_start(struct dm_async *op, struct udevice *dev, const char *name,
+		   dm_async_poll_t poll, ulong delay_ms)
+{
+	if (dm_async_pending(op))
+		return -EBUSY;
+
+	op->dev = dev;
+	op->name = name;
+	op->poll = poll;
+	op->ret = -EINPROGRESS;
+	dm_async_delay(op, delay_ms);
+	list_add_tail(&op->node, &async_list);
+	async_changes++;
+
+	/* Nothing polls before relocation, so finish the operation now */
+	if (!(gd->flags & GD_FLG_RELOC))
+		dm_async_wait(op);
+
+	return 0;
+}
+
+void dm_async_delay(struct dm_async *op, ulong delay_ms)
+{
+	op->deadline = get_timer(0) + delay_ms;
+}
+
+void dm_async_poll(void)
+{
+	struct dm_async *op, *next;
+	uint changes;
+
+	if (async_polling)
+		return;
+
+	/*
+	 * A poll function may finish or cancel other operations, so stop
+	 * when the list changes. The rest get their turn next time.
+	 */
+	list_for_each_entry_safe(op, next, &async_list, node) {
+		changes = async_changes;
+		async_run(op);
+		if (async_changes != changes)
+			break;
+	}
+}
+
+int dm_async_wait(struct dm_async *op)
+{
+	while (dm_async_pending(op)) {
+		/* A poll function waiting for another operation */
+		if (async_polling)
+			async_run(op);
+		else
+			dm_async_poll();
+	}
+
+	return op->ret;
+}
+
+void dm_async_wait_all(void)
+{
+	while (!list_empty(&async_list))
+		dm_async_wait(list_first_entry(&async_list, struct dm_async,
+					       node));
+}
+
+void dm_async_cancel(struct dm_async *op)
+{
+	if (!dm_async_pending(op))
+		return;
+
+	list_del(&op->node);
+	async_changes++;
+	op->ret = -ECANCELED;
+}
+
+void dm_async_cancel_dev(struct udevice *dev)
+{
+	struct dm_async *op, *next;
+
+	list_for_each_entry_safe(op, next, &async_list, node) {
+		if (op->dev == dev)
+			dm_async_cancel(op);
+	}
+}
@@ -12,6 +12,7 @@
 #include <common.h>
 #include <errno.h>
 #include <malloc.h>
+#include <dm/async.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/uclass.h>
@@ -187,6 +188,8 @@ int device_remove(struct udevice *dev, uint flags)
 	 * Remove the device if called with the "normal" remove flag set,
 	 * or if the remove flag matches any of the drivers remove flags
 	 */
+	if (flags_remove(flags, drv->flags))
+		dm_async_cancel_dev(dev);
 	if (drv->remove && flags_remove(flags, drv->flags)) {
 		ret = drv->remove(dev);
 		if (ret)
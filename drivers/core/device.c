@@ -15,6 +15,7 @@
 #include <fdtdec.h>
 #include <fdt_support.h>
 #include <malloc.h>
+#include <dm/async.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -308,6 +309,10 @@ int device_probe(struct udevice *dev)
 	if (dev->flags & DM_FLAG_ACTIVATED)
 		return 0;
 
+	/* Let background operations move along while devices are probed */
+	if (gd->flags & GD_FLG_RELOC)
+		dm_async_poll();
+
 	drv = dev->driver;
 	assert(drv);
 
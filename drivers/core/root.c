@@ -12,6 +12,7 @@
 #include <fdtdec.h>
 #include <malloc.h>
 #include <linux/libfdt.h>
+#include <dm/async.h>
 #include <dm/device.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -195,6 +196,8 @@ int dm_uninit(void)
 #if CONFIG_IS_ENABLED(DM_DEVICE_REMOVE)
 int dm_remove_devices_flags(uint flags)
 {
+	/* Leave the hardware settled, not half-way through an operation */
+	dm_async_wait_all();
 	device_remove(dm_root(), flags);
 
 	return 0;
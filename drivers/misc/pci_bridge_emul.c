@@ -0,0 +1,109 @@
+/*
+ * PCI emulation device for a PCI-to-PCI bridge
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <errno.h>
+#include <pci.h>
+#include <asm/test.h>
+
+/**
+ * struct pci_bridge_emul_platdata - platform data for this device
+ *
+ * @config:	Configuration space, up to and including the bridge control
+ *		register. Only the writable registers are kept here, the rest
+ *		reads as fixed values or zero. There are no BARs or ROM.
+ */
+struct pci_bridge_emul_platdata {
+	u8 config[PCI_BRIDGE_CONTROL + 2];
+};
+
+static bool pci_bridge_emul_writable(uint pos)
+{
+	switch (pos) {
+	case PCI_COMMAND:
+	case PCI_COMMAND + 1:
+	case PCI_CACHE_LINE_SIZE:
+	case PCI_LATENCY_TIMER:
+	case PCI_INTERRUPT_LINE:
+	case PCI_BRIDGE_CONTROL:
+	case PCI_BRIDGE_CONTROL + 1:
+		return true;
+	}
+
+	/* Bus numbers, windows and their upper halves */
+	return pos >= PCI_PRIMARY_BUS && pos < PCI_CAPABILITY_LIST;
+}
+
+static u8 pci_bridge_emul_read_byte(struct pci_bridge_emul_platdata *plat,
+				    uint pos)
+{
+	switch (pos) {
+	case PCI_VENDOR_ID:
+	case PCI_VENDOR_ID + 1:
+		return SANDBOX_PCI_VENDOR_ID >> (pos - PCI_VENDOR_ID) * 8;
+	case PCI_DEVICE_ID:
+	case PCI_DEVICE_ID + 1:
+		return SANDBOX_PCI_BRIDGE_DEVICE_ID >>
+			(pos - PCI_DEVICE_ID) * 8;
+	case PCI_CLASS_DEVICE:
+	case PCI_CLASS_DEVICE + 1:
+		return PCI_CLASS_BRIDGE_PCI >> (pos - PCI_CLASS_DEVICE) * 8;
+	case PCI_HEADER_TYPE:
+		return PCI_HEADER_TYPE_BRIDGE;
+	case PCI_IO_BASE:
+	case PCI_IO_LIMIT:
+		return (plat->config[pos] & PCI_IO_RANGE_MASK) |
+			PCI_IO_RANGE_TYPE_32;
+	}
+
+	return pos < sizeof(plat->config) ? plat->config[pos] : 0;
+}
+
+static int pci_bridge_emul_read_config(struct udevice *emul, uint offset,
+				       ulong *valuep, enum pci_size_t size)
+{
+	struct pci_bridge_emul_platdata *plat = dev_get_platdata(emul);
+	int i;
+
+	*valuep = 0;
+	for (i = 0; i < 1 << size; i++)
+		*valuep |= pci_bridge_emul_read_byte(plat, offset + i) << i * 8;
+
+	return 0;
+}
+
+static int pci_bridge_emul_write_config(struct udevice *emul, uint offset,
+					ulong value, enum pci_size_t size)
+{
+	struct pci_bridge_emul_platdata *plat = dev_get_platdata(emul);
+	int i;
+
+	for (i = 0; i < 1 << size; i++) {
+		if (pci_bridge_emul_writable(offset + i))
+			plat->config[offset + i] = value >> i * 8;
+	}
+
+	return 0;
+}
+
+static struct dm_pci_emul_ops pci_bridge_emul_ops = {
+	.read_config = pci_bridge_emul_read_config,
+	.write_config = pci_bridge_emul_write_config,
+};
+
+static const struct udevice_id pci_bridge_emul_ids[] = {
+	{ .compatible = "sandbox,pci-bridge" },
+	{ }
+};
+
+U_BOOT_DRIVER(sandbox_pci_bridge_emul) = {
+	.name		= "sandbox_pci_bridge_emul",
+	.id		= UCLASS_PCI_EMUL,
+	.of_match	= pci_bridge_emul_ids,
+	.ops		= &pci_bridge_emul_ops,
+	.platdata_auto_alloc_size = sizeof(struct pci_bridge_emul_platdata),
+};
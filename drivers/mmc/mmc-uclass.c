@@ -245,6 +245,9 @@ void mmc_do_preinit(void)
 #ifdef CONFIG_FSL_ESDHC_ADAPTER_IDENT
 		mmc_set_preinit(m, 1);
 #endif
+		/* Cards power up in the background, so start them all */
+		if (CONFIG_IS_ENABLED(MMC_ASYNC_INIT) && mmc_getcd(m))
+			mmc_set_preinit(m, 1);
 		if (m->preinit)
 			mmc_start_init(m);
 	}
@@ -554,55 +554,54 @@ static int mmc_switch_voltage(struct mmc *mmc, int signal_voltage)
 }
 #endif
 
-static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
+static int sd_send_op_cond_iter(struct mmc *mmc, bool uhs_en)
 {
-	int timeout = 1000;
-	int err;
 	struct mmc_cmd cmd;
+	int err;
 
-	while (1) {
-		cmd.cmdidx = MMC_CMD_APP_CMD;
-		cmd.resp_type = MMC_RSP_R1;
-		cmd.cmdarg = 0;
-
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	cmd.cmdidx = MMC_CMD_APP_CMD;
+	cmd.resp_type = MMC_RSP_R1;
+	cmd.cmdarg = 0;
 
-		if (err)
-			return err;
+	err = mmc_send_cmd(mmc, &cmd, NULL);
 
-		cmd.cmdidx = SD_CMD_APP_SEND_OP_COND;
-		cmd.resp_type = MMC_RSP_R3;
+	if (err)
+		return err;
 
-		/*
-		 * Most cards do not answer if some reserved bits
-		 * in the ocr are set. However, Some controller
-		 * can set bit 7 (reserved for low voltages), but
-		 * how to manage low voltages SD card is not yet
-		 * specified.
-		 */
-		cmd.cmdarg = mmc_host_is_spi(mmc) ? 0 :
-			(mmc->cfg->voltages & 0xff8000);
+	cmd.cmdidx = SD_CMD_APP_SEND_OP_COND;
+	cmd.resp_type = MMC_RSP_R3;
 
-		if (mmc->version == SD_VERSION_2)
-			cmd.cmdarg |= OCR_HCS;
+	/*
+	 * Most cards do not answer if some reserved bits
+	 * in the ocr are set. However, Some controller
+	 * can set bit 7 (reserved for low voltages), but
+	 * how to manage low voltages SD card is not yet
+	 * specified.
+	 */
+	cmd.cmdarg = mmc_host_is_spi(mmc) ? 0 :
+		(mmc->cfg->voltages & 0xff8000);
 
-		if (uhs_en)
-			cmd.cmdarg |= OCR_S18R;
+	if (mmc->version == SD_VERSION_2)
+		cmd.cmdarg |= OCR_HCS;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	if (uhs_en)
+		cmd.cmdarg |= OCR_S18R;
 
-		if (err)
-			return err;
+	err = mmc_send_cmd(mmc, &cmd, NULL);
 
-		if (cmd.response[0] & OCR_BUSY)
-			break;
+	if (err)
+		return err;
 
-		if (timeout-- <= 0)
-			return -EOPNOTSUPP;
+	mmc->ocr = cmd.response[0];
+	return 0;
+}
 
-		udelay(1000);
-	}
+static int sd_complete_op_cond(struct mmc *mmc, bool uhs_en)
+{
+	struct mmc_cmd cmd;
+	int err;
 
+	mmc->sd_op_cond_pending = 0;
 	if (mmc->version != SD_VERSION_2)
 		mmc->version = SD_VERSION_1_0;
 
@@ -615,12 +614,12 @@ static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
 
 		if (err)
 			return err;
-	}
 
-	mmc->ocr = cmd.response[0];
+		mmc->ocr = cmd.response[0];
+	}
 
 #if CONFIG_IS_ENABLED(MMC_UHS_SUPPORT)
-	if (uhs_en && !(mmc_host_is_spi(mmc)) && (cmd.response[0] & 0x41000000)
+	if (uhs_en && !(mmc_host_is_spi(mmc)) && (mmc->ocr & 0x41000000)
 	    == 0x41000000) {
 		err = mmc_switch_voltage(mmc, MMC_SIGNAL_VOLTAGE_180);
 		if (err)
@@ -634,6 +633,52 @@ static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
 	return 0;
 }
 
+static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
+{
+	int timeout = 1000;
+	int err;
+
+	while (1) {
+		err = sd_send_op_cond_iter(mmc, uhs_en);
+		if (err)
+			return err;
+
+		if (mmc->ocr & OCR_BUSY)
+			break;
+
+		if (timeout-- <= 0)
+			return -EOPNOTSUPP;
+
+		udelay(1000);
+	}
+
+	return sd_complete_op_cond(mmc, uhs_en);
+}
+
+/*
+ * Check that an SD card answers, leaving the wait for it to power up to
+ * mmc_op_cond_poll() where possible
+ */
+static int sd_start_op_cond(struct mmc *mmc, bool uhs_en)
+{
+#if CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
+	int err;
+
+	/* UHS cards may need the retry in mmc_start_init() */
+	if (!uhs_en) {
+		err = sd_send_op_cond_iter(mmc, false);
+		if (err)
+			return err;
+		if (mmc->ocr & OCR_BUSY)
+			return sd_complete_op_cond(mmc, false);
+		mmc->sd_op_cond_pending = 1;
+
+		return 0;
+	}
+#endif
+	return sd_send_op_cond(mmc, uhs_en);
+}
+
 static int mmc_send_op_cond_iter(struct mmc *mmc, int use_arg)
 {
 	struct mmc_cmd cmd;
@@ -676,6 +721,46 @@ static int mmc_send_op_cond(struct mmc *mmc)
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
+static int mmc_op_cond_poll(struct dm_async *op)
+{
+	struct mmc *mmc = container_of(op, struct mmc, op_cond_poll);
+	int err;
+
+	if (mmc->sd_op_cond_pending)
+		err = sd_send_op_cond_iter(mmc, false);
+	else
+		err = mmc_send_op_cond_iter(mmc, 1);
+	if (err)
+		return err;
+	if (mmc->ocr & OCR_BUSY)
+		return 0;
+	if (get_timer(mmc->op_cond_start) > 1000)
+		return -EOPNOTSUPP;
+	dm_async_delay(op, 1);
+
+	return -EAGAIN;
+}
+
+/* Let the card power up in the background until mmc_complete_init() */
+static void mmc_start_op_cond_poll(struct mmc *mmc)
+{
+	struct dm_async *op = &mmc->op_cond_poll;
+
+	/* Forget about any earlier attempt */
+	dm_async_cancel(op);
+	op->ret = 0;
+
+	if (mmc->op_cond_pending && !(mmc->ocr & OCR_BUSY))
+		mmc_go_idle(mmc);	/* Some cards seem to need this */
+	else if (!mmc->sd_op_cond_pending)
+		return;
+
+	mmc->op_cond_start = get_timer(0);
+	dm_async_start(op, mmc->dev, "op_cond", mmc_op_cond_poll, 1);
+}
+#endif
+
 static int mmc_complete_op_cond(struct mmc *mmc)
 {
 	struct mmc_cmd cmd;
@@ -2545,6 +2630,7 @@ int mmc_start_init(struct mmc *mmc)
 		return err;
 #endif
 	mmc->ddr_mode = 0;
+	mmc->sd_op_cond_pending = 0;
 
 retry:
 	mmc_set_initial_state(mmc);
@@ -2563,7 +2649,7 @@ retry:
 	err = mmc_send_if_cond(mmc);
 
 	/* Now try to get the SD card's operating condition */
-	err = sd_send_op_cond(mmc, uhs_en);
+	err = sd_start_op_cond(mmc, uhs_en);
 	if (err && uhs_en) {
 		uhs_en = false;
 		mmc_power_cycle(mmc);
@@ -2582,8 +2668,12 @@ retry:
 		}
 	}
 
-	if (!err)
+	if (!err) {
 		mmc->init_in_progress = 1;
+#if CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
+		mmc_start_op_cond_poll(mmc);
+#endif
+	}
 
 	return err;
 }
@@ -2593,8 +2683,17 @@ static int mmc_complete_init(struct mmc *mmc)
 	int err = 0;
 
 	mmc->init_in_progress = 0;
-	if (mmc->op_cond_pending)
+#if CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
+	err = dm_async_wait(&mmc->op_cond_poll);
+#endif
+	if (err) {
+		mmc->op_cond_pending = 0;
+		mmc->sd_op_cond_pending = 0;
+	} else if (mmc->op_cond_pending) {
 		err = mmc_complete_op_cond(mmc);
+	} else if (mmc->sd_op_cond_pending) {
+		err = sd_complete_op_cond(mmc, false);
+	}
 
 	if (!err)
 		err = mmc_startup(mmc);
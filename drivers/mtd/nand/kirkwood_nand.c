@@ -76,7 +76,8 @@ void kw_nand_select_chip(struct mtd_info *mtd, int chip)
 
 int board_nand_init(struct nand_chip *nand)
 {
-	nand->options = NAND_COPYBACK | NAND_CACHEPRG | NAND_NO_PADDING;
+	nand->options = NAND_COPYBACK | NAND_CACHEPRG | NAND_CACHE_READ |
+			NAND_NO_PADDING;
 #if defined(CONFIG_SYS_NAND_NO_SUBPAGE_WRITE)
 	nand->options |= NAND_NO_SUBPAGE_WRITE;
 #endif
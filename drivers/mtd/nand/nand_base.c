@@ -1677,6 +1677,45 @@ static int nand_setup_read_retry(struct mtd_info *mtd, int retry_mode)
 	return chip->setup_read_retry(mtd, retry_mode);
 }
 
+/**
+ * nand_cache_read_start - [INTERN] Find the pages to read with cache reads
+ * @mtd: MTD device structure
+ * @realpage: page number, whose whole data is about to be read
+ * @readlen: number of bytes left to read, starting at @realpage
+ *
+ * With READ CACHE SEQUENTIAL, the chip reads the next page from the array
+ * while the previous one is transferred. Only whole pages are read this way
+ * and the sequence stops at the end of the eraseblock.
+ *
+ * Returns the last page (within the chip) of the sequence, or -1 if a cache
+ * read is not possible or not worth it.
+ */
+static int nand_cache_read_start(struct mtd_info *mtd, int realpage,
+				 uint32_t readlen)
+{
+	struct nand_chip *chip = mtd_to_nand(mtd);
+	int pages_per_block = 1 << (chip->phys_erase_shift - chip->page_shift);
+	int count = readlen >> chip->page_shift;
+	int page = realpage & chip->pagemask;
+	int last;
+
+	/* OOB-first ECC issues its own READOOB and READ0 for each page */
+	if (!NAND_HAS_CACHE_READ(chip) ||
+	    !nand_standard_page_accessors(&chip->ecc) ||
+	    chip->ecc.mode == NAND_ECC_HW_OOB_FIRST)
+		return -1;
+
+	last = min(page + count - 1, page | (pages_per_block - 1));
+	if (last <= page)
+		return -1;
+
+	/* The pages to come are read from the chip, not from the buffer */
+	if (chip->pagebuf > realpage && chip->pagebuf <= realpage + last - page)
+		chip->pagebuf = -1;
+
+	return last;
+}
+
 /**
  * nand_do_read_ops - [INTERN] Read data with ECC
  * @mtd: MTD device structure
@@ -1700,6 +1739,7 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 	unsigned int max_bitflips = 0;
 	int retry_mode = 0;
 	bool ecc_fail = false;
+	int cache_last = -1;
 
 	chipnr = (int)(from >> chip->chip_shift);
 	chip->select_chip(mtd, chipnr);
@@ -1737,8 +1777,23 @@ static int nand_do_read_ops(struct mtd_info *mtd, loff_t from,
 						 __func__, buf);
 
 read_retry:
-			if (nand_standard_page_accessors(&chip->ecc))
+			if (cache_last < 0 &&
+			    nand_standard_page_accessors(&chip->ecc)) {
 				chip->cmdfunc(mtd, NAND_CMD_READ0, 0x00, page);
+				if (aligned && !retry_mode)
+					cache_last = nand_cache_read_start(mtd,
+							realpage, readlen);
+			}
+
+			/* Move the page to the cache, go on with the next */
+			if (cache_last > page) {
+				chip->cmdfunc(mtd, NAND_CMD_READCACHESEQ,
+					      -1, -1);
+			} else if (cache_last == page) {
+				chip->cmdfunc(mtd, NAND_CMD_READCACHEEND,
+					      -1, -1);
+				cache_last = -1;
+			}
 
 			/*
 			 * Now read the page into the buffer.  Absent an error,
@@ -1799,6 +1854,13 @@ read_retry:
 
 			if (mtd->ecc_stats.failed - ecc_failures) {
 				if (retry_mode + 1 < chip->read_retries) {
+					/* Finish the cache read first */
+					if (cache_last >= 0) {
+						chip->cmdfunc(mtd,
+							NAND_CMD_READCACHEEND,
+							-1, -1);
+						cache_last = -1;
+					}
 					retry_mode++;
 					ret = nand_setup_read_retry(mtd,
 							retry_mode);
@@ -1848,6 +1910,9 @@ read_retry:
 			chip->select_chip(mtd, chipnr);
 		}
 	}
+	/* Leave the chip idle if the read stopped half-way */
+	if (cache_last >= 0)
+		chip->cmdfunc(mtd, NAND_CMD_READCACHEEND, -1, -1);
 	chip->select_chip(mtd, -1);
 
 	ops->retlen = ops->len - (size_t) readlen;
@@ -4614,6 +4679,11 @@ int nand_scan_tail(struct mtd_info *mtd)
 		break;
 	}
 
+	/* Cache reads need a large page chip which supports them */
+	if (chip->page_shift <= 9 ||
+	    !(onfi_opt_cmd(chip) & ONFI_OPT_CMD_READ_CACHE))
+		chip->options &= ~NAND_CACHE_READ;
+
 	/* Fill in remaining MTD driver data */
 	mtd->type = nand_is_slc(chip) ? MTD_NANDFLASH : MTD_MLCNANDFLASH;
 	mtd->flags = (chip->options & NAND_ROM) ? MTD_CAP_ROM :
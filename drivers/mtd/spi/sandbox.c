@@ -91,6 +91,8 @@ struct sandbox_spi_flash {
 	const struct spi_flash_info *data;
 	/* The file on disk to serv up data from */
 	int fd;
+	/* Operations performed, for tests */
+	struct sandbox_sf_stats stats;
 };
 
 struct sandbox_spi_flash_plat_data {
@@ -244,6 +246,22 @@ static void sandbox_spi_tristate(u8 *buf, uint len)
 	memset(buf, 0xff, len);
 }
 
+int sandbox_erase_part(struct sandbox_spi_flash *sbsf, int size)
+{
+	int todo;
+	int ret;
+
+	while (size > 0) {
+		todo = min(size, (int)sizeof(sandbox_sf_0xff));
+		ret = os_write(sbsf->fd, sandbox_sf_0xff, todo);
+		if (ret != todo)
+			return ret;
+		size -= todo;
+	}
+
+	return 0;
+}
+
 /* Figure out what command this stream is telling us to do */
 static int sandbox_sf_process_cmd(struct sandbox_spi_flash *sbsf, const u8 *rx,
 				  u8 *tx)
@@ -263,7 +281,10 @@ static int sandbox_sf_process_cmd(struct sandbox_spi_flash *sbsf, const u8 *rx,
 	case CMD_READ_ARRAY_FAST:
 		sbsf->pad_addr_bytes = 1;
 	case CMD_READ_ARRAY_SLOW:
+		sbsf->state = SF_ADDR;
+		break;
 	case CMD_PAGE_PROGRAM:
+		sbsf->stats.program++;
 		sbsf->state = SF_ADDR;
 		break;
 	case CMD_WRITE_DISABLE:
@@ -288,11 +309,23 @@ static int sandbox_sf_process_cmd(struct sandbox_spi_flash *sbsf, const u8 *rx,
 
 		/* we only support erase here */
 		if (sbsf->cmd == CMD_ERASE_CHIP) {
-			sbsf->erase_size = sbsf->data->sector_size *
-				sbsf->data->n_sectors;
+			/* This takes no address, so erase right away */
+			if (!(sbsf->status & STAT_WEL)) {
+				puts("sandbox_sf: write enable not set before erase\n");
+				break;
+			}
+			sbsf->status &= ~STAT_WEL;
+			sbsf->stats.erase_chip++;
+			if (os_lseek(sbsf->fd, 0, OS_SEEK_SET) < 0 ||
+			    sandbox_erase_part(sbsf, sbsf->data->sector_size *
+					       sbsf->data->n_sectors)) {
+				debug("sandbox_sf: Erase failed\n");
+				return -EIO;
+			}
+			break;
 		} else if (sbsf->cmd == CMD_ERASE_4K && (flags & SECT_4K)) {
 			sbsf->erase_size = 4 << 10;
-		} else if (sbsf->cmd == CMD_ERASE_64K && !(flags & SECT_4K)) {
+		} else if (sbsf->cmd == CMD_ERASE_64K) {
 			sbsf->erase_size = 64 << 10;
 		} else {
 			debug(" cmd unknown: %#x\n", sbsf->cmd);
@@ -310,22 +343,6 @@ static int sandbox_sf_process_cmd(struct sandbox_spi_flash *sbsf, const u8 *rx,
 	return 0;
 }
 
-int sandbox_erase_part(struct sandbox_spi_flash *sbsf, int size)
-{
-	int todo;
-	int ret;
-
-	while (size > 0) {
-		todo = min(size, (int)sizeof(sandbox_sf_0xff));
-		ret = os_write(sbsf->fd, sandbox_sf_0xff, todo);
-		if (ret != todo)
-			return ret;
-		size -= todo;
-	}
-
-	return 0;
-}
-
 static int sandbox_sf_xfer(struct udevice *dev, unsigned int bitlen,
 			   const void *rxp, void *txp, unsigned long flags)
 {
@@ -492,6 +509,10 @@ static int sandbox_sf_xfer(struct udevice *dev, unsigned int bitlen,
 			 * TODO(vapier@gentoo.org): latch WIP in status, and
 			 * delay before clearing it ?
 			 */
+			if (sbsf->erase_size == 4 << 10)
+				sbsf->stats.erase_4k++;
+			else
+				sbsf->stats.erase_64k++;
 			ret = sandbox_erase_part(sbsf, sbsf->erase_size);
 			sbsf->status &= ~STAT_WEL;
 			if (ret) {
@@ -558,7 +579,7 @@ static int sandbox_cmdline_cb_spi_sf(struct sandbox_state *state,
 SANDBOX_CMDLINE_OPT(spi_sf, 1, "connect a SPI flash: <bus>:<cs>:<id>:<file>");
 
 int sandbox_sf_bind_emul(struct sandbox_state *state, int busnum, int cs,
-			 struct udevice *bus, int of_offset, const char *spec)
+			 struct udevice *bus, ofnode node, const char *spec)
 {
 	struct udevice *emul;
 	char name[20], *str;
@@ -577,7 +598,7 @@ int sandbox_sf_bind_emul(struct sandbox_state *state, int busnum, int cs,
 		puts("Cannot find sandbox_sf_emul driver\n");
 		return -ENOENT;
 	}
-	ret = device_bind(bus, drv, str, NULL, of_offset, &emul);
+	ret = device_bind_with_driver_data(bus, drv, str, 0, node, &emul);
 	if (ret) {
 		printf("Cannot create emul device for spec '%s' (err=%d)\n",
 		       spec, ret);
@@ -588,6 +609,20 @@ int sandbox_sf_bind_emul(struct sandbox_state *state, int busnum, int cs,
 	return 0;
 }
 
+int sandbox_sf_get_stats(struct sandbox_state *state, int busnum, int cs,
+			 struct sandbox_sf_stats *stats)
+{
+	struct udevice *dev = state->spi[busnum][cs].emul;
+	struct sandbox_spi_flash *sbsf;
+
+	if (!dev || !device_active(dev))
+		return -ENODEV;
+	sbsf = dev_get_priv(dev);
+	*stats = sbsf->stats;
+
+	return 0;
+}
+
 void sandbox_sf_unbind_emul(struct sandbox_state *state, int busnum, int cs)
 {
 	struct udevice *dev;
@@ -621,7 +656,8 @@ static int sandbox_sf_bind_bus_cs(struct sandbox_state *state, int busnum,
 	if (ret)
 		return ret;
 
-	return sandbox_sf_bind_emul(state, busnum, cs, bus, -1, spec);
+	return sandbox_sf_bind_emul(state, busnum, cs, bus, ofnode_null(),
+				   spec);
 }
 
 int sandbox_spi_get_emul(struct sandbox_state *state,
@@ -639,7 +675,7 @@ int sandbox_spi_get_emul(struct sandbox_state *state,
 		debug("%s: busnum=%u, cs=%u: binding SPI flash emulation: ",
 		      __func__, busnum, cs);
 		ret = sandbox_sf_bind_emul(state, busnum, cs, bus,
-					   dev_of_offset(slave), slave->name);
+					   dev_ofnode(slave), slave->name);
 		if (ret) {
 			debug("failed (err=%d)\n", ret);
 			return ret;
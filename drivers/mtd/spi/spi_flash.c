@@ -312,9 +312,43 @@ int spi_flash_write_common(struct spi_flash *flash, const u8 *cmd,
 	return ret;
 }
 
+static int spi_flash_erase_chip(struct spi_flash *flash)
+{
+	struct spi_slave *spi = flash->spi;
+	u8 cmd = CMD_ERASE_CHIP;
+	int ret;
+
+	ret = spi_claim_bus(spi);
+	if (ret) {
+		debug("SF: unable to claim SPI bus\n");
+		return ret;
+	}
+
+	ret = spi_flash_cmd_write_enable(flash);
+	if (ret < 0) {
+		debug("SF: enabling write failed\n");
+		goto release;
+	}
+
+	ret = spi_flash_cmd_write(spi, &cmd, sizeof(cmd), NULL, 0);
+	if (ret < 0) {
+		debug("SF: chip erase cmd failed\n");
+		goto release;
+	}
+
+	ret = spi_flash_wait_till_ready(flash, SPI_FLASH_CHIP_ERASE_TIMEOUT);
+	if (ret < 0)
+		debug("SF: chip erase timed out\n");
+
+release:
+	spi_release_bus(spi);
+
+	return ret;
+}
+
 int spi_flash_cmd_erase_ops(struct spi_flash *flash, u32 offset, size_t len)
 {
-	u32 erase_size, erase_addr;
+	u32 erase_size, erase_addr, block_size;
 	u8 cmd[SPI_FLASH_CMD_LEN];
 	int ret = -1;
 
@@ -332,10 +366,24 @@ int spi_flash_cmd_erase_ops(struct spi_flash *flash, u32 offset, size_t len)
 		}
 	}
 
-	cmd[0] = flash->erase_cmd;
+	/* Erasing the whole of a single chip is much faster in one go */
+	if (!offset && len == flash->size &&
+	    flash->dual_flash == SF_SINGLE_FLASH)
+		return spi_flash_erase_chip(flash);
+
+	block_size = SPI_FLASH_64K_BLOCK << flash->shift;
 	while (len) {
 		erase_addr = offset;
 
+		/* Use a 64KiB block erase where the range covers a block */
+		cmd[0] = flash->erase_cmd;
+		erase_size = flash->erase_size;
+		if ((flash->flags & SNOR_F_ERASE_64K) &&
+		    !(offset % block_size) && len >= block_size) {
+			cmd[0] = CMD_ERASE_64K;
+			erase_size = block_size;
+		}
+
 #ifdef CONFIG_SF_DUAL_FLASH
 		if (flash->dual_flash > SF_SINGLE_FLASH)
 			spi_flash_dual(flash, &erase_addr);
@@ -465,6 +513,60 @@ void __weak spi_flash_copy_mmap(void *data, void *offset, size_t len)
 	memcpy(data, offset, len);
 }
 
+#ifdef CONFIG_DM_SPI
+/*
+ * Offer a read to the SPI controller, for controllers that can perform it
+ * with DMA, a memory-mapped window or a quad/octal read engine
+ */
+static int spi_flash_mem_read(struct spi_flash *flash, u32 addr,
+			      void *data, size_t len)
+{
+	struct spi_slave *spi = flash->spi;
+	struct spi_mem_read_op op = {
+		.opcode		= flash->read_cmd,
+		/* Bits above the 16MiB boundary are selected by the BAR */
+		.addr		= addr & (SPI_FLASH_16MB_BOUN - 1),
+		.addr_len	= SPI_FLASH_3B_ADDR_LEN,
+		.cmd_width	= 1,
+		.addr_width	= 1,
+		.data_width	= 1,
+		.buf		= data,
+		.len		= len,
+	};
+	int ret;
+
+	switch (flash->read_cmd) {
+	case CMD_READ_DUAL_IO_FAST:
+		op.addr_width = 2;
+		/* fall through */
+	case CMD_READ_DUAL_OUTPUT_FAST:
+		op.data_width = 2;
+		break;
+	case CMD_READ_QUAD_IO_FAST:
+		op.addr_width = 4;
+		/* fall through */
+	case CMD_READ_QUAD_OUTPUT_FAST:
+		op.data_width = 4;
+		break;
+	case CMD_READ_OCTAL_OUTPUT_FAST:
+		op.data_width = 8;
+		break;
+	}
+	/* dummy_byte counts the bytes sent on the address lines */
+	op.dummy_cycles = flash->dummy_byte * 8 / op.addr_width;
+
+	ret = spi_claim_bus(spi);
+	if (ret) {
+		debug("SF: unable to claim SPI bus\n");
+		return ret;
+	}
+	ret = spi_mem_read(spi, &op);
+	spi_release_bus(spi);
+
+	return ret;
+}
+#endif
+
 int spi_flash_cmd_read_ops(struct spi_flash *flash, u32 offset,
 		size_t len, void *data)
 {
@@ -516,12 +618,27 @@ int spi_flash_cmd_read_ops(struct spi_flash *flash, u32 offset,
 		else
 			read_len = remain_len;
 
-		if (spi->max_read_size)
-			read_len = min(read_len, spi->max_read_size);
-
-		spi_flash_addr(read_addr, cmd);
+		ret = -ENOSYS;
+#ifdef CONFIG_DM_SPI
+		/*
+		 * Prefer the controller's own read path, if it has one.
+		 * -ENOTSUPP only rules out this particular read.
+		 */
+		if (!(flash->flags & SNOR_F_NO_MEM_READ)) {
+			ret = spi_flash_mem_read(flash, read_addr, data,
+						 read_len);
+			if (ret == -ENOSYS)
+				flash->flags |= SNOR_F_NO_MEM_READ;
+		}
+#endif
+		if (ret == -ENOSYS || ret == -ENOTSUPP) {
+			if (spi->max_read_size)
+				read_len = min(read_len, spi->max_read_size);
 
-		ret = spi_flash_read_common(flash, cmd, cmdsz, data, read_len);
+			spi_flash_addr(read_addr, cmd);
+			ret = spi_flash_read_common(flash, cmd, cmdsz, data,
+						    read_len);
+		}
 		if (ret < 0) {
 			debug("SF: read failed\n");
 			break;
@@ -1060,6 +1177,10 @@ int spi_flash_scan(struct spi_flash *flash)
 	if (info->flags & SECT_4K) {
 		flash->erase_cmd = CMD_ERASE_4K;
 		flash->erase_size = 4096 << flash->shift;
+		/* SST26 parts have non-uniform blocks, so leave them alone */
+		if (info->sector_size == SPI_FLASH_64K_BLOCK &&
+		    JEDEC_MFR(info) != SPI_FLASH_CFI_MFR_SST)
+			flash->flags |= SNOR_F_ERASE_64K;
 	} else
 #endif
 	{
@@ -1074,6 +1195,8 @@ int spi_flash_scan(struct spi_flash *flash)
 	flash->read_cmd = CMD_READ_ARRAY_FAST;
 	if (spi->mode & SPI_RX_SLOW)
 		flash->read_cmd = CMD_READ_ARRAY_SLOW;
+	else if (spi->mode & SPI_RX_OCTAL && info->flags & RD_OCTAL)
+		flash->read_cmd = CMD_READ_OCTAL_OUTPUT_FAST;
 	else if (spi->mode & SPI_RX_QUAD && info->flags & RD_QUAD)
 		flash->read_cmd = CMD_READ_QUAD_OUTPUT_FAST;
 	else if (spi->mode & SPI_RX_DUAL && info->flags & RD_DUAL)
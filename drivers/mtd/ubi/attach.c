@@ -829,6 +829,9 @@ static int scan_peb(struct ubi_device *ubi, struct ubi_attach_info *ai,
 		return 0;
 	}
 
+	ubi->attach_scanned += 1;
+	ubi_io_prefetch_hdrs(ubi, pnum);
+
 	err = ubi_io_read_ec_hdr(ubi, pnum, ech, 0);
 	if (err < 0)
 		return err;
@@ -1398,11 +1401,24 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 {
 	int err;
 	struct ubi_attach_info *ai;
+	unsigned long start;
 
 	ai = alloc_ai();
 	if (!ai)
 		return -ENOMEM;
 
+	/*
+	 * If both headers fit into one min. I/O unit, fetch them with a
+	 * single read while scanning, see 'ubi_io_prefetch_hdrs()'.
+	 */
+	if (ubi->vid_hdr_aloffset + ubi->vid_hdr_alsize <= ubi->min_io_size) {
+		ubi->hdr_buf = kmalloc(ubi->vid_hdr_aloffset +
+				       ubi->vid_hdr_alsize, GFP_KERNEL);
+		ubi->hdr_buf_pnum = -1;
+	}
+	ubi->attach_scanned = 0;
+	start = get_timer(0);
+
 #ifdef CONFIG_MTD_UBI_FASTMAP
 	/* On small flash devices we disable fastmap in any case. */
 	if ((int)mtd_div_by_eb(ubi->mtd->size, ubi->mtd) <= UBI_FM_MAX_START) {
@@ -1430,9 +1446,14 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 #else
 	err = scan_all(ubi, ai, 0);
 #endif
+	kfree(ubi->hdr_buf);
+	ubi->hdr_buf = NULL;
 	if (err)
 		goto out_ai;
 
+	ubi->attach_fastmap = !!ubi->fm;
+	ubi->attach_scan_ms = get_timer(start);
+
 	ubi->bad_peb_count = ai->bad_peb_count;
 	ubi->good_peb_count = ubi->peb_count - ubi->bad_peb_count;
 	ubi->corr_peb_count = ai->corr_peb_count;
@@ -1440,17 +1461,23 @@ int ubi_attach(struct ubi_device *ubi, int force_scan)
 	ubi->mean_ec = ai->mean_ec;
 	dbg_gen("max. sequence number:       %llu", ai->max_sqnum);
 
+	start = get_timer(0);
 	err = ubi_read_volume_table(ubi, ai);
 	if (err)
 		goto out_ai;
+	ubi->attach_vtbl_ms = get_timer(start);
 
+	start = get_timer(0);
 	err = ubi_wl_init(ubi, ai);
 	if (err)
 		goto out_vtbl;
+	ubi->attach_wl_ms = get_timer(start);
 
+	start = get_timer(0);
 	err = ubi_eba_init(ubi, ai);
 	if (err)
 		goto out_wl;
+	ubi->attach_eba_ms = get_timer(start);
 
 #ifdef CONFIG_MTD_UBI_FASTMAP
 	if (ubi->fm && ubi_dbg_chk_fastmap(ubi)) {
@@ -1065,6 +1065,25 @@ int ubi_attach_mtd_dev(struct mtd_info *mtd, int ubi_num,
 
 	spin_unlock(&ubi->wl_lock);
 
+#ifdef CONFIG_MTD_UBI_FASTMAP
+	/*
+	 * Attaching by scanning is slow on large devices, so write a fastmap
+	 * right away instead of waiting for the detach, which may never come
+	 * before the next power cycle. This needs
+	 * CONFIG_MTD_UBI_FASTMAP_AUTOCONVERT, which is what keeps the fastmap
+	 * up to date on a device attached by scanning. A single fastmap that
+	 * is not updated afterwards would be stale by the next attach.
+	 */
+	if (!ubi->attach_fastmap && !ubi->fm_disabled && !ubi->ro_mode) {
+		unsigned long start = get_timer(0);
+
+		err = ubi_update_fastmap(ubi);
+		if (err)
+			ubi_msg(ubi, "Unable to write a new fastmap: %i", err);
+		ubi->attach_fm_ms = get_timer(start);
+	}
+#endif
+
 	ubi_devices[ubi_num] = ubi;
 	ubi_notify_all(ubi, UBI_VOLUME_ADDED, NULL);
 	return ubi_num;
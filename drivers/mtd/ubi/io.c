@@ -93,6 +93,11 @@ static int self_check_vid_hdr(const struct ubi_device *ubi, int pnum,
 static int self_check_write(struct ubi_device *ubi, const void *buf, int pnum,
 			    int offset, int len);
 
+static bool hdrs_prefetched(const struct ubi_device *ubi, int pnum)
+{
+	return ubi->hdr_buf && ubi->hdr_buf_pnum == pnum;
+}
+
 /**
  * ubi_io_read - read data from a physical eraseblock.
  * @ubi: UBI device description object
@@ -247,6 +252,9 @@ int ubi_io_write(struct ubi_device *ubi, const void *buf, int pnum, int offset,
 	if (err)
 		return err;
 
+	if (hdrs_prefetched(ubi, pnum))
+		ubi->hdr_buf_pnum = -1;
+
 	/* The area we are writing to has to contain all 0xFF bytes */
 	err = ubi_self_check_all_ff(ubi, pnum, offset, len);
 	if (err)
@@ -572,6 +580,9 @@ int ubi_io_sync_erase(struct ubi_device *ubi, int pnum, int torture)
 		return -EROFS;
 	}
 
+	if (hdrs_prefetched(ubi, pnum))
+		ubi->hdr_buf_pnum = -1;
+
 	if (ubi->nor_flash) {
 		err = nor_erase_prepare(ubi, pnum);
 		if (err)
@@ -699,6 +710,28 @@ bad:
 	return 1;
 }
 
+/**
+ * ubi_io_prefetch_hdrs - read both UBI headers of a PEB at once.
+ * @ubi: UBI device description object
+ * @pnum: physical eraseblock to read from
+ *
+ * When the EC and VID headers share one min. I/O unit (NAND with sub-pages),
+ * reading them separately costs two flash read commands per PEB. While
+ * attaching, this function reads both headers with a single command into
+ * @ubi->hdr_buf, and 'ubi_io_read_ec_hdr()' and 'ubi_io_read_vid_hdr()' take
+ * them from there. Does nothing if @ubi->hdr_buf was not allocated.
+ */
+void ubi_io_prefetch_hdrs(struct ubi_device *ubi, int pnum)
+{
+	if (!ubi->hdr_buf)
+		return;
+
+	ubi->hdr_buf_err = ubi_io_read(ubi, ubi->hdr_buf, pnum, 0,
+				       ubi->vid_hdr_aloffset +
+				       ubi->vid_hdr_alsize);
+	ubi->hdr_buf_pnum = pnum;
+}
+
 /**
  * ubi_io_read_ec_hdr - read and check an erase counter header.
  * @ubi: UBI device description object
@@ -730,7 +763,12 @@ int ubi_io_read_ec_hdr(struct ubi_device *ubi, int pnum,
 	dbg_io("read EC header from PEB %d", pnum);
 	ubi_assert(pnum >= 0 && pnum < ubi->peb_count);
 
-	read_err = ubi_io_read(ubi, ec_hdr, pnum, 0, UBI_EC_HDR_SIZE);
+	if (hdrs_prefetched(ubi, pnum)) {
+		memcpy(ec_hdr, ubi->hdr_buf, UBI_EC_HDR_SIZE);
+		read_err = ubi->hdr_buf_err;
+	} else {
+		read_err = ubi_io_read(ubi, ec_hdr, pnum, 0, UBI_EC_HDR_SIZE);
+	}
 	if (read_err) {
 		if (read_err != UBI_IO_BITFLIPS && !mtd_is_eccerr(read_err))
 			return read_err;
@@ -1005,8 +1043,14 @@ int ubi_io_read_vid_hdr(struct ubi_device *ubi, int pnum,
 	ubi_assert(pnum >= 0 &&  pnum < ubi->peb_count);
 
 	p = (char *)vid_hdr - ubi->vid_hdr_shift;
-	read_err = ubi_io_read(ubi, p, pnum, ubi->vid_hdr_aloffset,
-			  ubi->vid_hdr_alsize);
+	if (hdrs_prefetched(ubi, pnum)) {
+		memcpy(p, ubi->hdr_buf + ubi->vid_hdr_aloffset,
+		       ubi->vid_hdr_alsize);
+		read_err = ubi->hdr_buf_err;
+	} else {
+		read_err = ubi_io_read(ubi, p, pnum, ubi->vid_hdr_aloffset,
+				       ubi->vid_hdr_alsize);
+	}
 	if (read_err && read_err != UBI_IO_BITFLIPS && !mtd_is_eccerr(read_err))
 		return read_err;
 
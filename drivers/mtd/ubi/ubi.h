@@ -525,6 +525,19 @@ struct ubi_debug_info {
  * @buf_mutex: protects @peb_buf
  * @ckvol_mutex: serializes static volume checking when opening
  *
+ * @hdr_buf: buffer holding the EC and VID headers of one PEB while attaching,
+ *           %NULL if both headers do not fit into one min. I/O unit
+ * @hdr_buf_pnum: PEB whose headers are held in @hdr_buf, or %-1
+ * @hdr_buf_err: result of the read which filled @hdr_buf
+ *
+ * @attach_fastmap: non-zero if the device was attached from a fastmap
+ * @attach_scanned: how many PEBs had their headers read while attaching
+ * @attach_scan_ms: time spent scanning PEBs or reading the fastmap (ms)
+ * @attach_vtbl_ms: time spent reading the volume table (ms)
+ * @attach_wl_ms: time spent initializing the wear-leveling sub-system (ms)
+ * @attach_eba_ms: time spent building the EBA tables (ms)
+ * @attach_fm_ms: time spent writing a fastmap after a full scan (ms)
+ *
  * @dbg: debugging information for this UBI device
  */
 struct ubi_device {
@@ -624,6 +637,18 @@ struct ubi_device {
 	struct mutex buf_mutex;
 	struct mutex ckvol_mutex;
 
+	void *hdr_buf;
+	int hdr_buf_pnum;
+	int hdr_buf_err;
+
+	unsigned int attach_fastmap:1;
+	int attach_scanned;
+	unsigned long attach_scan_ms;
+	unsigned long attach_vtbl_ms;
+	unsigned long attach_wl_ms;
+	unsigned long attach_eba_ms;
+	unsigned long attach_fm_ms;
+
 	struct ubi_debug_info dbg;
 };
 
@@ -887,6 +912,7 @@ int ubi_io_write(struct ubi_device *ubi, const void *buf, int pnum, int offset,
 int ubi_io_sync_erase(struct ubi_device *ubi, int pnum, int torture);
 int ubi_io_is_bad(const struct ubi_device *ubi, int pnum);
 int ubi_io_mark_bad(const struct ubi_device *ubi, int pnum);
+void ubi_io_prefetch_hdrs(struct ubi_device *ubi, int pnum);
 int ubi_io_read_ec_hdr(struct ubi_device *ubi, int pnum,
 		       struct ubi_ec_hdr *ec_hdr, int verbose);
 int ubi_io_write_ec_hdr(struct ubi_device *ubi, int pnum,
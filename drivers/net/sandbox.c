@@ -15,22 +15,34 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+/* Number of receive buffers, which are lent to the network stack */
+#define SB_ETH_RX_BUFS		2
+
 /**
  * struct eth_sandbox_priv - memory for sandbox mock driver
  *
  * fake_host_hwaddr: MAC address of mocked machine
  * fake_host_ipaddr: IP address of mocked machine
- * recv_packet_buffer: buffer of the packet returned as received
- * recv_packet_length: length of the packet returned as received
+ * rx_buf: buffers of the packets returned as received
+ * rx_len: length of the packet in each buffer, 0 if the buffer is free
+ * rx_flags: ETH_RX_... flags of the packet in each buffer
+ * rx_head: next buffer to hand to the network stack
+ * rx_tail: next buffer to fill with a reply
+ * rx_pending: number of replies not handed to the network stack yet
  */
 struct eth_sandbox_priv {
 	uchar fake_host_hwaddr[ARP_HLEN];
 	struct in_addr fake_host_ipaddr;
-	uchar *recv_packet_buffer;
-	int recv_packet_length;
+	uchar rx_buf[SB_ETH_RX_BUFS][PKTSIZE_ALIGN];
+	int rx_len[SB_ETH_RX_BUFS];
+	int rx_flags[SB_ETH_RX_BUFS];
+	int rx_head;
+	int rx_tail;
+	int rx_pending;
 };
 
 static bool disabled[8] = {false};
+static bool damage_ip_sum[8] = {false};
 static bool skip_timeout;
 
 /*
@@ -44,6 +56,18 @@ void sandbox_eth_disable_response(int index, bool disable)
 	disabled[index] = disable;
 }
 
+/*
+ * sandbox_eth_damage_ip_sum()
+ *
+ * index - The alias index (also DM seq number)
+ * damage - If non-zero, spoil the IP header checksum of replies after the
+ *	    emulated MAC has checked it, to tell whether the stack checks again
+ */
+void sandbox_eth_damage_ip_sum(int index, bool damage)
+{
+	damage_ip_sum[index] = damage;
+}
+
 /*
  * sandbox_eth_skip_timeout()
  *
@@ -63,10 +87,57 @@ static int sb_eth_start(struct udevice *dev)
 	fdtdec_get_byte_array(gd->fdt_blob, dev_of_offset(dev),
 			      "fake-host-hwaddr", priv->fake_host_hwaddr,
 			      ARP_HLEN);
-	priv->recv_packet_buffer = net_rx_packets[0];
+	memset(priv->rx_len, '\0', sizeof(priv->rx_len));
+	priv->rx_head = 0;
+	priv->rx_tail = 0;
+	priv->rx_pending = 0;
 	return 0;
 }
 
+/*
+ * Get a free buffer for a reply. Like a real MAC whose receive ring is full,
+ * drop the reply if all buffers are still waiting or lent to the stack.
+ */
+static uchar *sb_eth_rx_buf(struct udevice *dev)
+{
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+
+	if (priv->rx_len[priv->rx_tail]) {
+		eth_get_stats(dev)->rx_dropped++;
+		return NULL;
+	}
+
+	return priv->rx_buf[priv->rx_tail];
+}
+
+/*
+ * Queue the reply built in the buffer from sb_eth_rx_buf(). With ETH_CSUM_RX
+ * the MAC checks the IP header checksum, as it would on the wire. It does not
+ * check UDP checksums, so UDP packets are left for the stack to check.
+ */
+static void sb_eth_rx_queue(struct udevice *dev, int length)
+{
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+	struct eth_pdata *pdata = dev_get_platdata(dev);
+	struct ethernet_hdr *eth = (void *)priv->rx_buf[priv->rx_tail];
+	struct ip_udp_hdr *ip = (void *)eth + ETHER_HDR_SIZE;
+	int flags = 0;
+
+	if (ntohs(eth->et_protlen) == PROT_IP) {
+		if ((pdata->csum_offload & ETH_CSUM_RX) &&
+		    ip->ip_p != IPPROTO_UDP && ip_checksum_ok(ip, IP_HDR_SIZE))
+			flags |= ETH_RX_CSUM_OK;
+		if (dev->seq >= 0 && dev->seq < ARRAY_SIZE(damage_ip_sum) &&
+		    damage_ip_sum[dev->seq])
+			ip->ip_sum ^= htons(0x0101);
+	}
+
+	priv->rx_flags[priv->rx_tail] = flags;
+	priv->rx_len[priv->rx_tail] = length;
+	priv->rx_tail = (priv->rx_tail + 1) % SB_ETH_RX_BUFS;
+	priv->rx_pending++;
+}
+
 static int sb_eth_send(struct udevice *dev, void *packet, int length)
 {
 	struct eth_sandbox_priv *priv = dev_get_priv(dev);
@@ -88,14 +159,15 @@ static int sb_eth_send(struct udevice *dev, void *packet, int length)
 			/* store this as the assumed IP of the fake host */
 			priv->fake_host_ipaddr = net_read_ip(&arp->ar_tpa);
 			/* Formulate a fake response */
-			eth_recv = (void *)priv->recv_packet_buffer;
+			eth_recv = (void *)sb_eth_rx_buf(dev);
+			if (!eth_recv)
+				return 0;
 			memcpy(eth_recv->et_dest, eth->et_src, ARP_HLEN);
 			memcpy(eth_recv->et_src, priv->fake_host_hwaddr,
 			       ARP_HLEN);
 			eth_recv->et_protlen = htons(PROT_ARP);
 
-			arp_recv = (void *)priv->recv_packet_buffer +
-				ETHER_HDR_SIZE;
+			arp_recv = (void *)eth_recv + ETHER_HDR_SIZE;
 			arp_recv->ar_hrd = htons(ARP_ETHER);
 			arp_recv->ar_pro = htons(PROT_IP);
 			arp_recv->ar_hln = ARP_HLEN;
@@ -107,8 +179,7 @@ static int sb_eth_send(struct udevice *dev, void *packet, int length)
 			memcpy(&arp_recv->ar_tha, &arp->ar_sha, ARP_HLEN);
 			net_copy_ip(&arp_recv->ar_tpa, &arp->ar_spa);
 
-			priv->recv_packet_length = ETHER_HDR_SIZE +
-				ARP_HDR_SIZE;
+			sb_eth_rx_queue(dev, ETHER_HDR_SIZE + ARP_HDR_SIZE);
 		}
 	} else if (ntohs(eth->et_protlen) == PROT_IP) {
 		struct ip_udp_hdr *ip = packet + ETHER_HDR_SIZE;
@@ -122,11 +193,11 @@ static int sb_eth_send(struct udevice *dev, void *packet, int length)
 				struct icmp_hdr *icmpr;
 
 				/* reply to the ping */
-				memcpy(priv->recv_packet_buffer, packet,
-				       length);
-				eth_recv = (void *)priv->recv_packet_buffer;
-				ipr = (void *)priv->recv_packet_buffer +
-					ETHER_HDR_SIZE;
+				eth_recv = (void *)sb_eth_rx_buf(dev);
+				if (!eth_recv)
+					return 0;
+				memcpy(eth_recv, packet, length);
+				ipr = (void *)eth_recv + ETHER_HDR_SIZE;
 				icmpr = (struct icmp_hdr *)&ipr->udp_src;
 				memcpy(eth_recv->et_dest, eth->et_src,
 				       ARP_HLEN);
@@ -145,7 +216,7 @@ static int sb_eth_send(struct udevice *dev, void *packet, int length)
 				icmpr->checksum = compute_ip_checksum(icmpr,
 					ICMP_HDR_SIZE);
 
-				priv->recv_packet_length = length;
+				sb_eth_rx_queue(dev, length);
 			}
 		}
 	}
@@ -156,21 +227,57 @@ static int sb_eth_send(struct udevice *dev, void *packet, int length)
 static int sb_eth_recv(struct udevice *dev, int flags, uchar **packetp)
 {
 	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+	int length;
 
 	if (skip_timeout) {
 		sandbox_timer_add_offset(11000UL);
 		skip_timeout = false;
 	}
 
-	if (priv->recv_packet_length) {
-		int lcl_recv_packet_length = priv->recv_packet_length;
+	if (!priv->rx_pending)
+		return 0;
 
-		debug("eth_sandbox: received packet %d\n",
-		      priv->recv_packet_length);
-		priv->recv_packet_length = 0;
-		*packetp = priv->recv_packet_buffer;
-		return lcl_recv_packet_length;
+	length = priv->rx_len[priv->rx_head];
+	debug("eth_sandbox: received packet %d\n", length);
+	*packetp = priv->rx_buf[priv->rx_head];
+	priv->rx_head = (priv->rx_head + 1) % SB_ETH_RX_BUFS;
+	priv->rx_pending--;
+
+	return length;
+}
+
+static int sb_eth_recv_batch(struct udevice *dev, int flags,
+			     struct eth_rx_desc *descs, int count)
+{
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+	int i, head, ret;
+
+	for (i = 0; i < count; i++) {
+		head = priv->rx_head;
+		ret = sb_eth_recv(dev, flags, &descs[i].packet);
+		if (!ret)
+			break;
+		descs[i].length = ret;
+		descs[i].flags = priv->rx_flags[head];
 	}
+
+	return i;
+}
+
+static int sb_eth_free_pkt(struct udevice *dev, uchar *packet, int length)
+{
+	struct eth_sandbox_priv *priv = dev_get_priv(dev);
+	int i;
+
+	/* Nothing was lent if recv() found no packet */
+	if (!length)
+		return 0;
+
+	for (i = 0; i < SB_ETH_RX_BUFS; i++) {
+		if (packet == priv->rx_buf[i])
+			priv->rx_len[i] = 0;
+	}
+
 	return 0;
 }
 
@@ -192,6 +299,8 @@ static const struct eth_ops sb_eth_ops = {
 	.start			= sb_eth_start,
 	.send			= sb_eth_send,
 	.recv			= sb_eth_recv,
+	.recv_batch		= sb_eth_recv_batch,
+	.free_pkt		= sb_eth_free_pkt,
 	.stop			= sb_eth_stop,
 	.write_hwaddr		= sb_eth_write_hwaddr,
 };
@@ -11,6 +11,7 @@
 #include <linux/libfdt.h>
 #include <pci.h>
 #include <dm/lists.h>
+#include <dm/uclass-internal.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -21,16 +22,36 @@ struct sandbox_pci_priv {
 int sandbox_pci_get_emul(struct udevice *bus, pci_dev_t find_devfn,
 			 struct udevice **emulp)
 {
+	struct ofnode_phandle_args args;
 	struct udevice *dev;
 	int ret;
 
-	ret = pci_bus_find_devfn(bus, find_devfn, &dev);
+	/* Devices behind a bridge are found on the bridge's bus */
+	if (PCI_BUS(find_devfn) != bus->seq) {
+		ret = uclass_find_device_by_seq(UCLASS_PCI,
+						PCI_BUS(find_devfn), false,
+						&bus);
+		if (ret)
+			return -ENODEV;
+	}
+
+	ret = pci_bus_find_devfn(bus, PCI_MASK_BUS(find_devfn), &dev);
 	if (ret) {
 		debug("%s: Could not find emulator for dev %x\n", __func__,
 		      find_devfn);
 		return ret;
 	}
 
+	/*
+	 * The emulator is either given by phandle or is the first child. A
+	 * bus device such as a bridge cannot have the emulator as a child,
+	 * since its children are the devices on the bus.
+	 */
+	if (!dev_read_phandle_with_args(dev, "sandbox,emul", NULL, 0, 0,
+					&args))
+		return uclass_find_device_by_ofnode(UCLASS_PCI_EMUL, args.node,
+						    emulp);
+
 	ret = device_find_first_child(dev, emulp);
 	if (ret)
 		return ret;
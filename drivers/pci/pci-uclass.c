@@ -20,6 +20,47 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+/**
+ * pci_is_lazy_bridge() - Check whether a bridge is set up when it is probed
+ *
+ * With CONFIG_PCI_LAZY_ENUM, bridges on the root bus of a controller are not
+ * touched when the controller is configured. Instead each is set up, and the
+ * buses behind it are scanned, when the bridge itself is probed.
+ *
+ * @dev:	Device to check
+ * @return true if @dev is such a bridge
+ */
+static bool pci_is_lazy_bridge(struct udevice *dev)
+{
+	return IS_ENABLED(CONFIG_PCI_LAZY_ENUM) &&
+	       device_get_uclass_id(dev) == UCLASS_PCI &&
+	       device_is_on_pci_bus(dev) && !device_is_on_pci_bus(dev->parent);
+}
+
+/**
+ * pci_probe_next_bus() - Probe the first PCI bus which is not probed yet
+ *
+ * Buses are numbered as they are probed, so this finds the next number.
+ *
+ * @return 0 if OK, -ENODEV if all buses are probed, other -ve on error
+ */
+static int pci_probe_next_bus(void)
+{
+	struct udevice *bus;
+	struct uclass *uc;
+	int ret;
+
+	ret = uclass_get(UCLASS_PCI, &uc);
+	if (ret)
+		return ret;
+	uclass_foreach_dev(bus, uc) {
+		if (!device_active(bus))
+			return device_probe(bus);
+	}
+
+	return -ENODEV;
+}
+
 int pci_get_bus(int busnum, struct udevice **busp)
 {
 	int ret;
@@ -34,6 +75,11 @@ int pci_get_bus(int busnum, struct udevice **busp)
 		ret = uclass_get_device_by_seq(UCLASS_PCI, busnum, busp);
 	}
 
+	/* Bridges left alone so far may lead to the bus */
+	while (IS_ENABLED(CONFIG_PCI_LAZY_ENUM) && ret == -ENODEV &&
+	       !pci_probe_next_bus())
+		ret = uclass_get_device_by_seq(UCLASS_PCI, busnum, busp);
+
 	return ret;
 }
 
@@ -502,6 +548,11 @@ int pci_auto_config_devices(struct udevice *bus)
 		unsigned int max_bus;
 		int ret;
 
+		if (pci_is_lazy_bridge(dev)) {
+			debug("%s: bridge %s left until probed\n", __func__,
+			      dev->name);
+			continue;
+		}
 		debug("%s: device %s\n", __func__, dev->name);
 		ret = dm_pciauto_config_device(dev);
 		if (ret < 0)
@@ -929,6 +980,9 @@ static int pci_uclass_pre_probe(struct udevice *bus)
 	hose->first_busno = bus->seq;
 	hose->last_busno = bus->seq;
 
+	if (pci_is_lazy_bridge(bus))
+		dm_pciauto_setup_lazy_bridge(bus);
+
 	return 0;
 }
 
@@ -945,6 +999,8 @@ static int pci_uclass_post_probe(struct udevice *bus)
 	ret = pci_auto_config_devices(bus);
 	if (ret < 0)
 		return ret;
+	if (pci_is_lazy_bridge(bus))
+		dm_pciauto_postscan_setup_bridge(bus, pci_get_bus_max());
 #endif
 
 #if defined(CONFIG_X86) && defined(CONFIG_HAVE_FSP)
@@ -1355,6 +1411,8 @@ void pci_init(void)
 	/*
 	 * Enumerate all known controller devices. Enumeration has the side-
 	 * effect of probing them, so PCIe devices will be enumerated too.
+	 * This includes bridges left alone so far with CONFIG_PCI_LAZY_ENUM,
+	 * since they are in the uclass too.
 	 */
 	for (uclass_first_device(UCLASS_PCI, &bus);
 	     bus;
@@ -299,6 +299,24 @@ void dm_pciauto_postscan_setup_bridge(struct udevice *dev, int sub_bus)
 	}
 }
 
+void dm_pciauto_setup_lazy_bridge(struct udevice *dev)
+{
+	struct udevice *ctlr = pci_get_controller(dev);
+	struct pci_controller *ctlr_hose = dev_get_uclass_priv(ctlr);
+	bool enum_only = false;
+
+#ifdef CONFIG_PCI_ENUM_ONLY
+	enum_only = true;
+#endif
+
+	debug("PCI Autoconfig: Setting up P2P bridge %s on bus %d\n",
+	      dev->name, dev->seq);
+	dm_pciauto_setup_device(dev, 2, ctlr_hose->pci_mem,
+				ctlr_hose->pci_prefetch, ctlr_hose->pci_io,
+				enum_only);
+	dm_pciauto_prescan_setup_bridge(dev, dev->seq);
+}
+
 /*
  * HJF: Changed this to return int. I think this is required
  * to get the correct result when scanning bridges
@@ -34,6 +34,19 @@ void dm_pciauto_prescan_setup_bridge(struct udevice *dev, int sub_bus);
  */
 void dm_pciauto_postscan_setup_bridge(struct udevice *dev, int sub_bus);
 
+/**
+ * dm_pciauto_setup_lazy_bridge() - Set up a bridge which was skipped so far
+ *
+ * With CONFIG_PCI_LAZY_ENUM, bridges on the root bus are skipped when their
+ * controller is configured. This assigns the bridge's own resources and gets
+ * it ready for scanning, as dm_pciauto_config_device() does before probing
+ * the bus. The bus number must already be allocated to @dev->seq. Once the
+ * scan is completed, dm_pciauto_postscan_setup_bridge() should be called.
+ *
+ * @dev:	Bridge device to be scanned
+ */
+void dm_pciauto_setup_lazy_bridge(struct udevice *dev);
+
 /**
  * dm_pciauto_config_device() - Configure a PCI device ready for use
  *
@@ -18,6 +18,7 @@
 #include <linux/errno.h>
 #include <asm/spi.h>
 #include <asm/state.h>
+#include <asm/test.h>
 #include <dm/device-internal.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -26,6 +27,17 @@ DECLARE_GLOBAL_DATA_PTR;
 # define CONFIG_SPI_IDLE_VAL 0xFF
 #endif
 
+/**
+ * struct sandbox_spi_priv - private data for the sandbox SPI bus
+ *
+ * @mem_read_err:	Error to return from mem_read(), 0 to perform the read
+ * @mem_read_count:	Number of reads performed by mem_read()
+ */
+struct sandbox_spi_priv {
+	int mem_read_err;
+	uint mem_read_count;
+};
+
 const char *sandbox_spi_parse_spec(const char *arg, unsigned long *bus,
 				   unsigned long *cs)
 {
@@ -124,6 +136,56 @@ static int sandbox_spi_xfer(struct udevice *slave, unsigned int bitlen,
 	return ret;
 }
 
+void sandbox_spi_set_mem_read_err(struct udevice *bus, int err)
+{
+	struct sandbox_spi_priv *priv = dev_get_priv(bus);
+
+	priv->mem_read_err = err;
+}
+
+uint sandbox_spi_get_mem_read_count(struct udevice *bus)
+{
+	struct sandbox_spi_priv *priv = dev_get_priv(bus);
+
+	return priv->mem_read_count;
+}
+
+/*
+ * Perform a whole flash read as one command transfer and one data transfer,
+ * regardless of length. Only single-wire reads with 3-byte addresses are
+ * supported, which is all the SPI flash emulator handles.
+ */
+static int sandbox_spi_mem_read(struct udevice *slave,
+				const struct spi_mem_read_op *op)
+{
+	struct sandbox_spi_priv *priv = dev_get_priv(slave->parent);
+	u8 cmd[16];
+	uint cmd_len;
+	int ret;
+
+	if (priv->mem_read_err)
+		return priv->mem_read_err;
+	cmd_len = 1 + op->addr_len + op->dummy_cycles * op->addr_width / 8;
+	if (op->cmd_width != 1 || op->addr_width != 1 ||
+	    op->data_width != 1 || op->addr_len != 3 || cmd_len > sizeof(cmd))
+		return -ENOTSUPP;
+
+	memset(cmd, '\0', sizeof(cmd));
+	cmd[0] = op->opcode;
+	cmd[1] = op->addr >> 16;
+	cmd[2] = op->addr >> 8;
+	cmd[3] = op->addr;
+	ret = sandbox_spi_xfer(slave, cmd_len * 8, cmd, NULL, SPI_XFER_BEGIN);
+	if (!ret)
+		ret = sandbox_spi_xfer(slave, op->len * 8, NULL, op->buf,
+				       SPI_XFER_END);
+	if (ret)
+		return ret;
+	priv->mem_read_count++;
+
+	return 0;
+}
+
 static int sandbox_spi_set_speed(struct udevice *bus, uint speed)
 {
 	return 0;
@@ -149,6 +211,7 @@ static const struct dm_spi_ops sandbox_spi_ops = {
 	.set_speed	= sandbox_spi_set_speed,
 	.set_mode	= sandbox_spi_set_mode,
 	.cs_info	= sandbox_cs_info,
+	.mem_read	= sandbox_spi_mem_read,
 };
 
 static const struct udevice_id sandbox_spi_ids[] = {
@@ -161,4 +224,5 @@ U_BOOT_DRIVER(spi_sandbox) = {
 	.id	= UCLASS_SPI,
 	.of_match = sandbox_spi_ids,
 	.ops	= &sandbox_spi_ops,
+	.priv_auto_alloc_size = sizeof(struct sandbox_spi_priv),
 };
@@ -14,6 +14,7 @@ DECLARE_GLOBAL_DATA_PTR;
 
 struct sandbox_usb_ctrl {
 	int rootdev;
+	struct list_head requests;
 };
 
 static void usbmon_trace(struct udevice *bus, ulong pipe,
@@ -118,6 +119,60 @@ static int sandbox_submit_int(struct udevice *bus, struct usb_device *udev,
 	return ret;
 }
 
+static int sandbox_submit_request(struct udevice *bus, struct usb_request *req)
+{
+	struct sandbox_usb_ctrl *ctrl = dev_get_priv(bus);
+
+	/* The transfer is carried out when the request is polled */
+	list_add_tail(&req->node, &ctrl->requests);
+
+	return 0;
+}
+
+static bool sandbox_same_endpoint(struct usb_request *req,
+				  struct usb_request *other)
+{
+	return req->udev == other->udev &&
+		usb_pipeendpoint(req->pipe) == usb_pipeendpoint(other->pipe) &&
+		usb_pipein(req->pipe) == usb_pipein(other->pipe);
+}
+
+static int sandbox_poll_request(struct udevice *bus, struct usb_request *req)
+{
+	struct sandbox_usb_ctrl *ctrl = dev_get_priv(bus);
+	struct usb_request *cur, *next;
+	int ret;
+
+	/* Complete the requests on this endpoint in order, up to @req */
+	list_for_each_entry_safe(cur, next, &ctrl->requests, node) {
+		if (!sandbox_same_endpoint(cur, req))
+			continue;
+		list_del(&cur->node);
+		if (usb_pipeint(cur->pipe)) {
+			ret = sandbox_submit_int(bus, cur->udev, cur->pipe,
+						 cur->buffer, cur->length,
+						 cur->interval);
+			cur->act_len = ret < 0 ? 0 : cur->length;
+		} else {
+			ret = sandbox_submit_bulk(bus, cur->udev, cur->pipe,
+						  cur->buffer, cur->length);
+			cur->act_len = cur->udev->act_len;
+		}
+		cur->status = ret < 0 ? ret : 0;
+		if (cur == req)
+			break;
+	}
+
+	return 0;
+}
+
+static int sandbox_cancel_request(struct udevice *bus, struct usb_request *req)
+{
+	list_del(&req->node);
+
+	return 0;
+}
+
 static int sandbox_alloc_device(struct udevice *dev, struct usb_device *udev)
 {
 	struct sandbox_usb_ctrl *ctrl = dev_get_priv(dev);
@@ -135,6 +190,10 @@ static int sandbox_alloc_device(struct udevice *dev, struct usb_device *udev)
 
 static int sandbox_usb_probe(struct udevice *dev)
 {
+	struct sandbox_usb_ctrl *ctrl = dev_get_priv(dev);
+
+	INIT_LIST_HEAD(&ctrl->requests);
+
 	return 0;
 }
 
@@ -142,6 +201,9 @@ static const struct dm_usb_ops sandbox_usb_ops = {
 	.control	= sandbox_submit_control,
 	.bulk		= sandbox_submit_bulk,
 	.interrupt	= sandbox_submit_int,
+	.submit_request	= sandbox_submit_request,
+	.poll_request	= sandbox_poll_request,
+	.cancel_request	= sandbox_cancel_request,
 	.alloc_device	= sandbox_alloc_device,
 };
 
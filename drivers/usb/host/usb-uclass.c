@@ -116,6 +116,119 @@ int destroy_int_queue(struct usb_device *udev, struct int_queue *queue)
 	return ops->destroy_int_queue(bus, udev, queue);
 }
 
+int usb_submit_request(struct usb_request *req)
+{
+	struct usb_device *udev = req->udev;
+	struct udevice *bus = udev->controller_dev;
+	struct dm_usb_ops *ops = usb_get_ops(bus);
+	int ret;
+
+	if (!usb_pipebulk(req->pipe) && !usb_pipeint(req->pipe))
+		return -EINVAL;
+
+	req->status = -EINPROGRESS;
+	req->act_len = 0;
+	req->hcpriv = NULL;
+	if (ops->submit_request) {
+		ret = ops->submit_request(bus, req);
+		if (ret)
+			req->status = ret;
+		return ret;
+	}
+
+	/* Interrupt queues keep the transfer on the controller too */
+	if (usb_pipeint(req->pipe) && ops->create_int_queue &&
+	    req->length <= usb_maxpacket(udev, req->pipe)) {
+		req->hcpriv = create_int_queue(udev, req->pipe, 1, req->length,
+					       req->buffer, req->interval);
+		if (req->hcpriv)
+			return 0;
+	}
+
+	/* Otherwise do the transfer now, the caller polls for the result */
+	if (usb_pipeint(req->pipe))
+		ret = submit_int_msg(udev, req->pipe, req->buffer, req->length,
+				     req->interval);
+	else
+		ret = submit_bulk_msg(udev, req->pipe, req->buffer,
+				      req->length);
+	if (!ret && udev->status)
+		ret = -EIO;
+	req->act_len = ret ? 0 : udev->act_len;
+	req->status = ret;
+
+	return 0;
+}
+
+int usb_poll_request(struct usb_request *req)
+{
+	struct usb_device *udev = req->udev;
+	struct udevice *bus = udev->controller_dev;
+	struct dm_usb_ops *ops = usb_get_ops(bus);
+	int ret;
+
+	if (req->status != -EINPROGRESS)
+		return req->status;
+
+	if (ops->submit_request) {
+		ret = ops->poll_request(bus, req);
+		if (ret)
+			return ret;
+	} else if (poll_int_queue(udev, req->hcpriv)) {
+		/* The queue does not report short packets */
+		destroy_int_queue(udev, req->hcpriv);
+		req->hcpriv = NULL;
+		req->act_len = req->length;
+		req->status = 0;
+	}
+
+	return req->status;
+}
+
+int usb_wait_request(struct usb_request *req, ulong timeout_ms)
+{
+	ulong start = get_timer(0);
+	int ret;
+
+	do {
+		ret = usb_poll_request(req);
+		if (ret != -EINPROGRESS)
+			return ret;
+	} while (get_timer(start) < timeout_ms);
+
+	ret = usb_cancel_request(req);
+	if (ret)
+		return ret;
+
+	return req->status == -ECONNRESET ? -ETIMEDOUT : req->status;
+}
+
+int usb_cancel_request(struct usb_request *req)
+{
+	struct usb_device *udev = req->udev;
+	struct udevice *bus = udev->controller_dev;
+	struct dm_usb_ops *ops = usb_get_ops(bus);
+	int ret;
+
+	if (req->status != -EINPROGRESS)
+		return 0;
+
+	if (ops->submit_request) {
+		if (!ops->cancel_request)
+			return -ENOSYS;
+		ret = ops->cancel_request(bus, req);
+		if (ret)
+			return ret;
+	} else {
+		destroy_int_queue(udev, req->hcpriv);
+		req->hcpriv = NULL;
+	}
+	if (req->status == -EINPROGRESS)
+		req->status = -ECONNRESET;
+
+	return 0;
+}
+
 int usb_alloc_device(struct usb_device *udev)
 {
 	struct udevice *bus = udev->controller_dev;
@@ -423,9 +423,53 @@ static int event_ready(struct xhci_ctrl *ctrl)
 	return 1;
 }
 
+/**
+ * Completes the oldest request in flight on the endpoint of a transfer event.
+ * TDs on an endpoint complete in the order they were queued, so that is the
+ * request the event belongs to.
+ *
+ * @param ctrl	Host controller data structure
+ * @param event	transfer event TRB
+ * @return true if the event belonged to a request, false if it is for a
+ *	   synchronous transfer
+ */
+static bool complete_request(struct xhci_ctrl *ctrl, union xhci_trb *event)
+{
+	u32 field = le32_to_cpu(event->trans_event.flags);
+	u32 len_field = le32_to_cpu(event->trans_event.transfer_len);
+	struct usb_request *req;
+
+	list_for_each_entry(req, &ctrl->requests, node) {
+		if (req->udev->slot_id != TRB_TO_SLOT_ID(field) ||
+		    usb_pipe_ep_index(req->pipe) != TRB_TO_EP_INDEX(field))
+			continue;
+
+		list_del(&req->node);
+		req->act_len = min(req->length,
+				   req->length - (int)EVENT_TRB_LEN(len_field));
+		switch (GET_COMP_CODE(len_field)) {
+		case COMP_SUCCESS:
+		case COMP_SHORT_TX:
+			req->status = 0;
+			break;
+		case COMP_STALL:
+			req->status = -EPIPE;
+			break;
+		default:
+			req->status = -EIO;
+		}
+		xhci_inval_cache((uintptr_t)req->buffer, req->length);
+
+		return true;
+	}
+
+	return false;
+}
+
 /**
  * Waits for a specific type of event and returns it. Discards unexpected
- * events. Caller *must* call xhci_acknowledge_event() after it is finished
+ * events. Transfer events of requests in flight complete those requests.
+ * Caller *must* call xhci_acknowledge_event() after it is finished
  * processing the event, and must not access the returned pointer afterwards.
  *
  * @param ctrl		Host controller data structure
@@ -444,6 +488,10 @@ union xhci_trb *xhci_wait_for_event(struct xhci_ctrl *ctrl, trb_type expected)
 			continue;
 
 		type = TRB_FIELD_TO_TYPE(le32_to_cpu(event->event_cmd.flags));
+		if (type == TRB_TRANSFER && complete_request(ctrl, event)) {
+			xhci_acknowledge_event(ctrl);
+			continue;
+		}
 		if (type == expected)
 			return event;
 
@@ -544,18 +592,54 @@ static void record_transfer_result(struct usb_device *udev,
 
 /**** Bulk and Control transfer methods ****/
 /**
- * Queues up the BULK Request
+ * Counts the TRBs needed for a BULK Request. Data buffers referenced by
+ * transfer TRBs shall not span 64KB boundaries (TABLE 49 and 6.4.1 section
+ * of XHCI Spec), so the buffer is split at each of them.
+ *
+ * @param buffer	buffer to be read/written
+ * @param length	length of the buffer
+ * @return number of TRBs
+ */
+static int bulk_num_trbs(void *buffer, int length)
+{
+	int running_total;
+	int num_trbs = 0;
+
+	running_total = TRB_MAX_BUFF_SIZE -
+			(lower_32_bits((uintptr_t)buffer) &
+			 (TRB_MAX_BUFF_SIZE - 1));
+	running_total &= TRB_MAX_BUFF_SIZE - 1;
+
+	/*
+	 * If there's some data on this 64KB chunk, or we have to send a
+	 * zero-length transfer, we need at least one TRB
+	 */
+	if (running_total != 0 || length == 0)
+		num_trbs++;
+
+	/* How many more 64KB chunks to transfer, how many more TRBs? */
+	while (running_total < length) {
+		num_trbs++;
+		running_total += TRB_MAX_BUFF_SIZE;
+	}
+
+	return num_trbs;
+}
+
+/**
+ * Queues up the TRBs of a BULK Request and rings the doorbell, without
+ * waiting for the transfer
  *
  * @param udev		pointer to the USB device structure
  * @param pipe		contains the DIR_IN or OUT , devnum
  * @param length	length of the buffer
  * @param buffer	buffer to be read/written based on the request
- * @return returns 0 if successful else -1 on failure
+ * @return 0 if queued, else error code
  */
-int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
-			int length, void *buffer)
+static int queue_bulk_tx(struct usb_device *udev, unsigned long pipe,
+			 int length, void *buffer)
 {
-	int num_trbs = 0;
+	int num_trbs;
 	struct xhci_generic_trb *start_trb;
 	bool first_trb = false;
 	int start_cycle;
@@ -567,7 +651,6 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	struct xhci_virt_device *virt_dev;
 	struct xhci_ep_ctx *ep_ctx;
 	struct xhci_ring *ring;		/* EP transfer ring */
-	union xhci_trb *event;
 
 	int running_total, trb_buff_len;
 	unsigned int total_packet_count;
@@ -595,23 +678,9 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	 * that the buffer should not span 64KB boundary. if so
 	 * we send request in more than 1 TRB by chaining them.
 	 */
-	running_total = TRB_MAX_BUFF_SIZE -
+	trb_buff_len = TRB_MAX_BUFF_SIZE -
 			(lower_32_bits(val_64) & (TRB_MAX_BUFF_SIZE - 1));
-	trb_buff_len = running_total;
-	running_total &= TRB_MAX_BUFF_SIZE - 1;
-
-	/*
-	 * If there's some data on this 64KB chunk, or we have to send a
-	 * zero-length transfer, we need at least one TRB
-	 */
-	if (running_total != 0 || length == 0)
-		num_trbs++;
-
-	/* How many more 64KB chunks to transfer, how many more TRBs? */
-	while (running_total < length) {
-		num_trbs++;
-		running_total += TRB_MAX_BUFF_SIZE;
-	}
+	num_trbs = bulk_num_trbs(buffer, length);
 
 	/*
 	 * XXX: Calling routine prepare_ring() called in place of
@@ -712,6 +781,32 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 
 	giveback_first_trb(udev, ep_index, start_cycle, start_trb);
 
+	return 0;
+}
+
+/**
+ * Queues up the BULK Request and waits for it
+ *
+ * @param udev		pointer to the USB device structure
+ * @param pipe		contains the DIR_IN or OUT , devnum
+ * @param length	length of the buffer
+ * @param buffer	buffer to be read/written based on the request
+ * @return returns 0 if successful else -1 on failure
+ */
+int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
+			int length, void *buffer)
+{
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	int slot_id = udev->slot_id;
+	int ep_index = usb_pipe_ep_index(pipe);
+	union xhci_trb *event;
+	u32 field;
+	int ret;
+
+	ret = queue_bulk_tx(udev, pipe, length, buffer);
+	if (ret)
+		return ret;
+
 	event = xhci_wait_for_event(ctrl, TRB_TRANSFER);
 	if (!event) {
 		debug("XHCI bulk transfer timed out, aborting...\n");
@@ -734,6 +829,99 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 	return (udev->status != USB_ST_NOT_PROC) ? 0 : -1;
 }
 
+/**
+ * Queues up a BULK or INTERRUPT Request without waiting for it. Its transfer
+ * event is picked up by xhci_poll_events() or, while a synchronous transfer
+ * is waiting, by xhci_wait_for_event().
+ *
+ * @param req	request to queue
+ * @return 0 if queued, -ENOSPC if the endpoint ring is full, other error code
+ *	   on failure
+ */
+int xhci_request_tx(struct usb_request *req)
+{
+	struct usb_device *udev = req->udev;
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	int ep_index = usb_pipe_ep_index(req->pipe);
+	struct usb_request *cur;
+	int num_trbs;
+	int ret;
+
+	/*
+	 * Each endpoint ring is one segment whose last TRB is the link, and
+	 * the enqueue pointer must not catch up with the TRBs in flight
+	 */
+	num_trbs = bulk_num_trbs(req->buffer, req->length);
+	list_for_each_entry(cur, &ctrl->requests, node) {
+		if (cur->udev == udev &&
+		    usb_pipe_ep_index(cur->pipe) == ep_index)
+			num_trbs += bulk_num_trbs(cur->buffer, cur->length);
+	}
+	if (num_trbs > TRBS_PER_SEGMENT - 2)
+		return -ENOSPC;
+
+	ret = queue_bulk_tx(udev, req->pipe, req->length, req->buffer);
+	if (ret)
+		return ret;
+	list_add_tail(&req->node, &ctrl->requests);
+
+	return 0;
+}
+
+/**
+ * Handles the events on the event ring without waiting for any, which
+ * completes the requests they belong to
+ *
+ * @param ctrl	Host controller data structure
+ * @return none
+ */
+void xhci_poll_events(struct xhci_ctrl *ctrl)
+{
+	union xhci_trb *event;
+	trb_type type;
+
+	while (event_ready(ctrl)) {
+		event = ctrl->event_ring->dequeue;
+		type = TRB_FIELD_TO_TYPE(le32_to_cpu(event->event_cmd.flags));
+		if (type != TRB_TRANSFER || !complete_request(ctrl, event))
+			debug("Unexpected XHCI event TRB, skipping... "
+			      "(%08x %08x %08x %08x)\n",
+			      le32_to_cpu(event->generic.field[0]),
+			      le32_to_cpu(event->generic.field[1]),
+			      le32_to_cpu(event->generic.field[2]),
+			      le32_to_cpu(event->generic.field[3]));
+		xhci_acknowledge_event(ctrl);
+	}
+}
+
+/**
+ * Cancels a request in flight. Stopping the endpoint throws away all of its
+ * TDs, so every request on the endpoint is cancelled.
+ *
+ * @param req	request to cancel
+ * @return none
+ */
+void xhci_abort_request(struct usb_request *req)
+{
+	struct usb_device *udev = req->udev;
+	struct xhci_ctrl *ctrl = xhci_get_ctrl(udev);
+	int ep_index = usb_pipe_ep_index(req->pipe);
+	struct usb_request *cur, *next;
+
+	xhci_poll_events(ctrl);
+	if (req->status != -EINPROGRESS)
+		return;
+
+	list_for_each_entry_safe(cur, next, &ctrl->requests, node) {
+		if (cur->udev == udev &&
+		    usb_pipe_ep_index(cur->pipe) == ep_index) {
+			list_del(&cur->node);
+			cur->status = -ECONNRESET;
+		}
+	}
+	abort_td(udev, ep_index);
+}
+
 /**
  * Queues up the Control Transfer Request
  *
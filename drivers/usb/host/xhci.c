@@ -1393,6 +1393,28 @@ static int xhci_submit_int_msg(struct udevice *dev, struct usb_device *udev,
 	return _xhci_submit_int_msg(udev, pipe, buffer, length, interval);
 }
 
+static int xhci_submit_request(struct udevice *dev, struct usb_request *req)
+{
+	debug("%s: dev='%s', udev=%p\n", __func__, dev->name, req->udev);
+	/* xHCI uses normal TRBs for both bulk and interrupt */
+	return xhci_request_tx(req);
+}
+
+static int xhci_poll_request(struct udevice *dev, struct usb_request *req)
+{
+	xhci_poll_events(dev_get_priv(dev));
+
+	return 0;
+}
+
+static int xhci_cancel_request(struct udevice *dev, struct usb_request *req)
+{
+	debug("%s: dev='%s', udev=%p\n", __func__, dev->name, req->udev);
+	xhci_abort_request(req);
+
+	return 0;
+}
+
 static int xhci_alloc_device(struct udevice *dev, struct usb_device *udev)
 {
 	debug("%s: dev='%s', udev=%p\n", __func__, dev->name, udev);
@@ -1522,6 +1544,9 @@ struct dm_usb_ops xhci_usb_ops = {
 	.control = xhci_submit_control_msg,
 	.bulk = xhci_submit_bulk_msg,
 	.interrupt = xhci_submit_int_msg,
+	.submit_request = xhci_submit_request,
+	.poll_request = xhci_poll_request,
+	.cancel_request = xhci_cancel_request,
 	.alloc_device = xhci_alloc_device,
 	.update_hub_device = xhci_update_hub_device,
 	.get_max_xfer_size  = xhci_get_max_xfer_size,
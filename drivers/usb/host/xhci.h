@@ -1231,6 +1231,7 @@ struct xhci_ctrl {
 	struct xhci_scratchpad *scratchpad;
 	struct xhci_virt_device *devs[MAX_HC_SLOTS];
 	int rootdev;
+	struct list_head requests;	/* usb_request in flight, in order */
 };
 
 unsigned long trb_addr(struct xhci_segment *seg, union xhci_trb *trb);
@@ -1258,6 +1259,9 @@ int xhci_bulk_tx(struct usb_device *udev, unsigned long pipe,
 		 int length, void *buffer);
 int xhci_ctrl_tx(struct usb_device *udev, unsigned long pipe,
 		 struct devrequest *req, int length, void *buffer);
+int xhci_request_tx(struct usb_request *req);
+void xhci_poll_events(struct xhci_ctrl *ctrl);
+void xhci_abort_request(struct usb_request *req);
 int xhci_check_maxpacket(struct usb_device *udev);
 void xhci_flush_cache(uintptr_t addr, u32 type_len);
 void xhci_inval_cache(uintptr_t addr, u32 type_len);
@@ -17,58 +17,19 @@
 static int console_normal_set_row(struct udevice *dev, uint row, int clr)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *line;
-	int pixels = VIDEO_FONT_HEIGHT * vid_priv->xsize;
-	int i;
 
-	line = vid_priv->fb + row * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-	case VIDEO_BPP8: {
-		uint8_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-	case VIDEO_BPP16: {
-		uint16_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-	case VIDEO_BPP32: {
-		uint32_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-	default:
-		return -ENOSYS;
-	}
-
-	return 0;
+	return video_fill_rect(dev->parent, 0, row * VIDEO_FONT_HEIGHT,
+			       vid_priv->xsize, VIDEO_FONT_HEIGHT, clr);
 }
 
 static int console_normal_move_rows(struct udevice *dev, uint rowdst,
 				     uint rowsrc, uint count)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
 
-	dst = vid_priv->fb + rowdst * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	src = vid_priv->fb + rowsrc * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	memmove(dst, src, VIDEO_FONT_HEIGHT * vid_priv->line_length * count);
-
-	return 0;
+	return video_copy_rect(dev->parent, 0, rowdst * VIDEO_FONT_HEIGHT,
+			       0, rowsrc * VIDEO_FONT_HEIGHT, vid_priv->xsize,
+			       VIDEO_FONT_HEIGHT * count);
 }
 
 static int console_normal_putc_xy(struct udevice *dev, uint x_frac, uint y,
@@ -129,6 +90,8 @@ static int console_normal_putc_xy(struct udevice *dev, uint x_frac, uint y,
 		}
 		line += vid_priv->line_length;
 	}
+	video_damage(vid, VID_TO_PIXEL(x_frac), y, VIDEO_FONT_WIDTH,
+		     VIDEO_FONT_HEIGHT);
 
 	return VID_TO_POS(VIDEO_FONT_WIDTH);
 }
@@ -15,71 +15,22 @@
 static int console_set_row_1(struct udevice *dev, uint row, int clr)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	int pbytes = VNBYTES(vid_priv->bpix);
-	void *line;
-	int i, j;
-
-	line = vid_priv->fb + vid_priv->line_length -
-		(row + 1) * VIDEO_FONT_HEIGHT * pbytes;
-	for (j = 0; j < vid_priv->ysize; j++) {
-		switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-		case VIDEO_BPP8: {
-			uint8_t *dst = line;
 
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-		case VIDEO_BPP16: {
-			uint16_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-		case VIDEO_BPP32: {
-			uint32_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-		default:
-			return -ENOSYS;
-		}
-		line += vid_priv->line_length;
-	}
-
-	return 0;
+	return video_fill_rect(dev->parent,
+			       vid_priv->xsize - (row + 1) * VIDEO_FONT_HEIGHT,
+			       0, VIDEO_FONT_HEIGHT, vid_priv->ysize, clr);
 }
 
 static int console_move_rows_1(struct udevice *dev, uint rowdst, uint rowsrc,
 			       uint count)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
-	int pbytes = VNBYTES(vid_priv->bpix);
-	int j;
-
-	dst = vid_priv->fb + vid_priv->line_length -
-		(rowdst + count) * VIDEO_FONT_HEIGHT * pbytes;
-	src = vid_priv->fb + vid_priv->line_length -
-		(rowsrc + count) * VIDEO_FONT_HEIGHT * pbytes;
-
-	for (j = 0; j < vid_priv->ysize; j++) {
-		memmove(dst, src, VIDEO_FONT_HEIGHT * pbytes * count);
-		src += vid_priv->line_length;
-		dst += vid_priv->line_length;
-	}
+	int xend = vid_priv->xsize - count * VIDEO_FONT_HEIGHT;
 
-	return 0;
+	return video_copy_rect(dev->parent,
+			       xend - rowdst * VIDEO_FONT_HEIGHT, 0,
+			       xend - rowsrc * VIDEO_FONT_HEIGHT, 0,
+			       count * VIDEO_FONT_HEIGHT, vid_priv->ysize);
 }
 
 static int console_putc_xy_1(struct udevice *dev, uint x_frac, uint y, char ch)
@@ -139,6 +90,9 @@ static int console_putc_xy_1(struct udevice *dev, uint x_frac, uint y, char ch)
 		line += vid_priv->line_length;
 		mask >>= 1;
 	}
+	video_damage(vid, vid_priv->xsize - y - VIDEO_FONT_HEIGHT,
+		     VID_TO_PIXEL(x_frac), VIDEO_FONT_HEIGHT,
+		     VIDEO_FONT_HEIGHT);
 
 	return VID_TO_POS(VIDEO_FONT_WIDTH);
 }
@@ -147,63 +101,22 @@ static int console_putc_xy_1(struct udevice *dev, uint x_frac, uint y, char ch)
 static int console_set_row_2(struct udevice *dev, uint row, int clr)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *line;
-	int pixels = VIDEO_FONT_HEIGHT * vid_priv->xsize;
-	int i;
-
-	line = vid_priv->fb + vid_priv->ysize * vid_priv->line_length -
-		(row + 1) * VIDEO_FONT_HEIGHT * vid_priv->line_length;
-	switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-	case VIDEO_BPP8: {
-		uint8_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-	case VIDEO_BPP16: {
-		uint16_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-	case VIDEO_BPP32: {
-		uint32_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-	default:
-		return -ENOSYS;
-	}
 
-	return 0;
+	return video_fill_rect(dev->parent, 0,
+			       vid_priv->ysize - (row + 1) * VIDEO_FONT_HEIGHT,
+			       vid_priv->xsize, VIDEO_FONT_HEIGHT, clr);
 }
 
 static int console_move_rows_2(struct udevice *dev, uint rowdst, uint rowsrc,
 			       uint count)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
-	void *end;
-
-	end = vid_priv->fb + vid_priv->ysize * vid_priv->line_length;
-	dst = end - (rowdst + count) * VIDEO_FONT_HEIGHT *
-		vid_priv->line_length;
-	src = end - (rowsrc + count) * VIDEO_FONT_HEIGHT *
-		vid_priv->line_length;
-	memmove(dst, src, VIDEO_FONT_HEIGHT * vid_priv->line_length * count);
+	int yend = vid_priv->ysize - count * VIDEO_FONT_HEIGHT;
 
-	return 0;
+	return video_copy_rect(dev->parent,
+			       0, yend - rowdst * VIDEO_FONT_HEIGHT,
+			       0, yend - rowsrc * VIDEO_FONT_HEIGHT,
+			       vid_priv->xsize, count * VIDEO_FONT_HEIGHT);
 }
 
 static int console_putc_xy_2(struct udevice *dev, uint x_frac, uint y, char ch)
@@ -267,6 +180,10 @@ static int console_putc_xy_2(struct udevice *dev, uint x_frac, uint y, char ch)
 		}
 		line -= vid_priv->line_length;
 	}
+	video_damage(vid, vid_priv->xsize - VID_TO_PIXEL(x_frac) -
+		     2 * VIDEO_FONT_WIDTH,
+		     vid_priv->ysize - y - VIDEO_FONT_HEIGHT, VIDEO_FONT_WIDTH,
+		     VIDEO_FONT_HEIGHT);
 
 	return VID_TO_POS(VIDEO_FONT_WIDTH);
 }
@@ -274,68 +191,19 @@ static int console_putc_xy_2(struct udevice *dev, uint x_frac, uint y, char ch)
 static int console_set_row_3(struct udevice *dev, uint row, int clr)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	int pbytes = VNBYTES(vid_priv->bpix);
-	void *line;
-	int i, j;
-
-	line = vid_priv->fb + row * VIDEO_FONT_HEIGHT * pbytes;
-	for (j = 0; j < vid_priv->ysize; j++) {
-		switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-		case VIDEO_BPP8: {
-			uint8_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-		case VIDEO_BPP16: {
-			uint16_t *dst = line;
 
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-		case VIDEO_BPP32: {
-			uint32_t *dst = line;
-
-			for (i = 0; i < VIDEO_FONT_HEIGHT; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-		default:
-			return -ENOSYS;
-		}
-		line += vid_priv->line_length;
-	}
-
-	return 0;
+	return video_fill_rect(dev->parent, row * VIDEO_FONT_HEIGHT, 0,
+			       VIDEO_FONT_HEIGHT, vid_priv->ysize, clr);
 }
 
 static int console_move_rows_3(struct udevice *dev, uint rowdst, uint rowsrc,
 			       uint count)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *dst;
-	void *src;
-	int pbytes = VNBYTES(vid_priv->bpix);
-	int j;
-
-	dst = vid_priv->fb + rowdst * VIDEO_FONT_HEIGHT * pbytes;
-	src = vid_priv->fb + rowsrc * VIDEO_FONT_HEIGHT * pbytes;
 
-	for (j = 0; j < vid_priv->ysize; j++) {
-		memmove(dst, src, VIDEO_FONT_HEIGHT * pbytes * count);
-		src += vid_priv->line_length;
-		dst += vid_priv->line_length;
-	}
-
-	return 0;
+	return video_copy_rect(dev->parent, rowdst * VIDEO_FONT_HEIGHT, 0,
+			       rowsrc * VIDEO_FONT_HEIGHT, 0,
+			       count * VIDEO_FONT_HEIGHT, vid_priv->ysize);
 }
 
 static int console_putc_xy_3(struct udevice *dev, uint x_frac, uint y, char ch)
@@ -395,6 +263,8 @@ static int console_putc_xy_3(struct udevice *dev, uint x_frac, uint y, char ch)
 		line -= vid_priv->line_length;
 		mask >>= 1;
 	}
+	video_damage(vid, y, vid_priv->ysize - VID_TO_PIXEL(x_frac) -
+		     VIDEO_FONT_HEIGHT, VIDEO_FONT_HEIGHT, VIDEO_FONT_HEIGHT);
 
 	return VID_TO_POS(VIDEO_FONT_WIDTH);
 }
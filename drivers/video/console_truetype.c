@@ -126,44 +126,9 @@ static int console_truetype_set_row(struct udevice *dev, uint row, int clr)
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
 	struct console_tt_priv *priv = dev_get_priv(dev);
-	void *line;
-	int pixels = priv->font_size * vid_priv->line_length;
-	int i;
-
-	line = vid_priv->fb + row * priv->font_size * vid_priv->line_length;
-	switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-	case VIDEO_BPP8: {
-		uint8_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-	case VIDEO_BPP16: {
-		uint16_t *dst = line;
-
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-	case VIDEO_BPP32: {
-		uint32_t *dst = line;
 
-		for (i = 0; i < pixels; i++)
-			*dst++ = clr;
-		break;
-	}
-#endif
-	default:
-		return -ENOSYS;
-	}
-
-	return 0;
+	return video_fill_rect(dev->parent, 0, row * priv->font_size,
+			       vid_priv->xsize, priv->font_size, clr);
 }
 
 static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
@@ -171,13 +136,13 @@ static int console_truetype_move_rows(struct udevice *dev, uint rowdst,
 {
 	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
 	struct console_tt_priv *priv = dev_get_priv(dev);
-	void *dst;
-	void *src;
-	int i, diff;
+	int i, diff, ret;
 
-	dst = vid_priv->fb + rowdst * priv->font_size * vid_priv->line_length;
-	src = vid_priv->fb + rowsrc * priv->font_size * vid_priv->line_length;
-	memmove(dst, src, priv->font_size * vid_priv->line_length * count);
+	ret = video_copy_rect(dev->parent, 0, rowdst * priv->font_size, 0,
+			      rowsrc * priv->font_size, vid_priv->xsize,
+			      priv->font_size * count);
+	if (ret)
+		return ret;
 
 	/* Scroll up our position history */
 	diff = (rowsrc - rowdst) * priv->font_size;
@@ -295,6 +260,8 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
 
 		line += vid_priv->line_length;
 	}
+	video_damage(vid, VID_TO_PIXEL(x) + xoff, y + max(linenum, 0), width,
+		     height);
 	free(data);
 
 	return width_frac;
@@ -312,54 +279,13 @@ static int console_truetype_putc_xy(struct udevice *dev, uint x, uint y,
  * @xend:	X end position in pixels from the left
  * @yend:	Y end position  in pixels from the top
  * @clr:	Value to write
- * @return 0 if OK, -ENOSYS if the display depth is not supported
+ * @return 0 if OK, -ve on error
  */
 static int console_truetype_erase(struct udevice *dev, int xstart, int ystart,
 				  int xend, int yend, int clr)
 {
-	struct video_priv *vid_priv = dev_get_uclass_priv(dev->parent);
-	void *line;
-	int pixels = xend - xstart;
-	int row, i;
-
-	line = vid_priv->fb + ystart * vid_priv->line_length;
-	line += xstart * VNBYTES(vid_priv->bpix);
-	for (row = ystart; row < yend; row++) {
-		switch (vid_priv->bpix) {
-#ifdef CONFIG_VIDEO_BPP8
-		case VIDEO_BPP8: {
-			uint8_t *dst = line;
-
-			for (i = 0; i < pixels; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP16
-		case VIDEO_BPP16: {
-			uint16_t *dst = line;
-
-			for (i = 0; i < pixels; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-#ifdef CONFIG_VIDEO_BPP32
-		case VIDEO_BPP32: {
-			uint32_t *dst = line;
-
-			for (i = 0; i < pixels; i++)
-				*dst++ = clr;
-			break;
-		}
-#endif
-		default:
-			return -ENOSYS;
-		}
-		line += vid_priv->line_length;
-	}
-
-	return 0;
+	return video_fill_rect(dev->parent, xstart, ystart, xend - xstart,
+			       yend - ystart, clr);
 }
 
 /**
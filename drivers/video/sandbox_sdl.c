@@ -22,6 +22,7 @@ enum {
 
 static int sandbox_sdl_probe(struct udevice *dev)
 {
+	struct video_uc_platdata *uc_plat = dev_get_uclass_platdata(dev);
 	struct sandbox_sdl_plat *plat = dev_get_platdata(dev);
 	struct video_priv *uc_priv = dev_get_uclass_priv(dev);
 	int ret;
@@ -38,6 +39,10 @@ static int sandbox_sdl_probe(struct udevice *dev)
 	uc_priv->vidconsole_drv_name = plat->vidconsole_drv_name;
 	uc_priv->font_size = plat->font_size;
 
+	/* Pretend that the top half of our memory is the hardware's */
+	if (IS_ENABLED(CONFIG_VIDEO_COPY))
+		uc_plat->copy_base = uc_plat->base + uc_plat->size / 2;
+
 	return 0;
 }
 
@@ -53,6 +58,8 @@ static int sandbox_sdl_bind(struct udevice *dev)
 	plat->yres = fdtdec_get_int(blob, node, "yres", LCD_MAX_HEIGHT);
 	plat->bpix = VIDEO_BPP16;
 	uc_plat->size = plat->xres * plat->yres * (1 << plat->bpix) / 8;
+	if (IS_ENABLED(CONFIG_VIDEO_COPY))
+		uc_plat->size *= 2;
 	debug("%s: Frame buffer size %x\n", __func__, uc_plat->size);
 
 	return ret;
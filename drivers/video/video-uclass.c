@@ -39,6 +39,14 @@
  * video_post_probe(). This function also clears the frame buffer and
  * allocates a suitable text console device. This can then be used to write
  * text to the video device.
+ *
+ * Drawing is done by the CPU into the frame buffer, or by the driver's 2D
+ * engine through struct video_ops, and the area drawn is recorded with
+ * video_damage(). video_sync() then flushes only that area from the cache.
+ * If the hardware frame buffer is slow for the CPU to access (e.g. uncached
+ * or write-combined) a driver can set plat->copy_base to it in its probe()
+ * method. The memory at plat->base is then used as a cached shadow which
+ * video_sync() copies to the hardware in bulk.
  */
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -87,33 +95,150 @@ int video_reserve(ulong *addrp)
 	return 0;
 }
 
-void video_clear(struct udevice *dev)
+void video_damage(struct udevice *dev, int x, int y, int width, int height)
 {
 	struct video_priv *priv = dev_get_uclass_priv(dev);
+	int xend = min(x + width, (int)priv->xsize);
+	int yend = min(y + height, (int)priv->ysize);
+
+	x = max(x, 0);
+	y = max(y, 0);
+	if (x >= xend || y >= yend)
+		return;
+
+	if (priv->damage.xend) {
+		priv->damage.xstart = min(priv->damage.xstart, x);
+		priv->damage.ystart = min(priv->damage.ystart, y);
+		priv->damage.xend = max(priv->damage.xend, xend);
+		priv->damage.yend = max(priv->damage.yend, yend);
+	} else {
+		priv->damage.xstart = x;
+		priv->damage.ystart = y;
+		priv->damage.xend = xend;
+		priv->damage.yend = yend;
+	}
+}
 
-	switch (priv->bpix) {
+/* Fill @count pixels starting at @dst with @colour */
+static void video_fill_pixels(void *dst, enum video_log2_bpp bpix, u32 colour,
+			      int count)
+{
+	switch (bpix) {
 	case VIDEO_BPP16: {
-		u16 *ppix = priv->fb;
-		u16 *end = priv->fb + priv->fb_size;
+		u16 *ppix = dst;
+		u16 *end = ppix + count;
 
 		while (ppix < end)
-			*ppix++ = priv->colour_bg;
+			*ppix++ = colour;
 		break;
 	}
 	case VIDEO_BPP32: {
-		u32 *ppix = priv->fb;
-		u32 *end = priv->fb + priv->fb_size;
+		u32 *ppix = dst;
+		u32 *end = ppix + count;
 
 		while (ppix < end)
-			*ppix++ = priv->colour_bg;
+			*ppix++ = colour;
 		break;
 	}
 	default:
-		memset(priv->fb, priv->colour_bg, priv->fb_size);
+		memset(dst, colour, count * VNBITS(bpix) / 8);
 		break;
 	}
 }
 
+/*
+ * Get the operations of the device's 2D engine, if it can be used. The
+ * engine writes to the frame buffer behind the CPU's back, so whatever the
+ * CPU has drawn is synced first. With a shadow frame buffer the engine is
+ * not used, since it would not update the shadow.
+ */
+static struct video_ops *video_engine_ops(struct udevice *dev)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_ops *ops = video_get_ops(dev);
+
+	if (!ops || (!ops->fill_rect && !ops->copy_rect) || priv->copy_fb)
+		return NULL;
+	video_sync(dev);
+
+	return ops;
+}
+
+int video_fill_rect(struct udevice *dev, int x, int y, int width, int height,
+		    u32 colour)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_ops *ops = video_engine_ops(dev);
+	void *line;
+	int i, ret;
+
+	if (ops && ops->fill_rect) {
+		ret = ops->fill_rect(dev, x, y, width, height, colour);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	line = priv->fb + y * priv->line_length + x * VNBITS(priv->bpix) / 8;
+	if (width == priv->xsize) {
+		/* Whole lines are contiguous, so fill them in one go */
+		video_fill_pixels(line, priv->bpix, colour, width * height);
+	} else {
+		for (i = 0; i < height; i++) {
+			video_fill_pixels(line, priv->bpix, colour, width);
+			line += priv->line_length;
+		}
+	}
+	video_damage(dev, x, y, width, height);
+
+	return 0;
+}
+
+int video_copy_rect(struct udevice *dev, int dst_x, int dst_y, int src_x,
+		    int src_y, int width, int height)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+	struct video_ops *ops = video_engine_ops(dev);
+	int pbits = VNBITS(priv->bpix);
+	int line_length = priv->line_length;
+	void *dst, *src;
+	int i, ret;
+
+	if (ops && ops->copy_rect) {
+		ret = ops->copy_rect(dev, dst_x, dst_y, src_x, src_y, width,
+				     height);
+		if (ret != -ENOSYS)
+			return ret;
+	}
+
+	dst = priv->fb + dst_y * line_length + dst_x * pbits / 8;
+	src = priv->fb + src_y * line_length + src_x * pbits / 8;
+	if (width == priv->xsize) {
+		memmove(dst, src, line_length * height);
+	} else {
+		/* Go from the bottom up if the rectangle moves down */
+		if (dst_y > src_y) {
+			dst += (height - 1) * line_length;
+			src += (height - 1) * line_length;
+			line_length = -line_length;
+		}
+		for (i = 0; i < height; i++) {
+			memmove(dst, src, width * pbits / 8);
+			dst += line_length;
+			src += line_length;
+		}
+	}
+	video_damage(dev, dst_x, dst_y, width, height);
+
+	return 0;
+}
+
+void video_clear(struct udevice *dev)
+{
+	struct video_priv *priv = dev_get_uclass_priv(dev);
+
+	video_fill_rect(dev, 0, 0, priv->xsize, priv->ysize, priv->colour_bg);
+}
+
 void video_set_default_colors(struct video_priv *priv)
 {
 #ifdef CONFIG_SYS_WHITE_ON_BLACK
@@ -128,28 +253,66 @@ void video_set_default_colors(struct video_priv *priv)
 #endif
 }
 
+/* Copy the changed part of the shadow frame buffer to the hardware one */
+static void video_sync_copy(struct video_priv *priv, int xstart, int ystart,
+			    int xend, int yend)
+{
+	int pbits = VNBITS(priv->bpix);
+	ulong offset = ystart * priv->line_length + xstart * pbits / 8;
+	int len = DIV_ROUND_UP(xend * pbits, 8) - xstart * pbits / 8;
+	int y;
+
+	if (len == priv->line_length) {
+		memcpy(priv->copy_fb + offset, priv->fb + offset,
+		       len * (yend - ystart));
+		return;
+	}
+	for (y = ystart; y < yend; y++) {
+		memcpy(priv->copy_fb + offset, priv->fb + offset, len);
+		offset += priv->line_length;
+	}
+}
+
 /* Flush video activity to the caches */
 void video_sync(struct udevice *vid)
 {
+	struct video_priv *priv = dev_get_uclass_priv(vid);
+	int xstart = 0, ystart = 0;
+	int xend = priv->xsize, yend = priv->ysize;
+
+	if (IS_ENABLED(CONFIG_VIDEO_DAMAGE)) {
+		xstart = priv->damage.xstart;
+		ystart = priv->damage.ystart;
+		xend = priv->damage.xend;
+		yend = priv->damage.yend;
+	}
+	priv->damage.xend = 0;
+
+	if (xstart < xend && priv->copy_fb)
+		video_sync_copy(priv, xstart, ystart, xend, yend);
+
 	/*
 	 * flush_dcache_range() is declared in common.h but it seems that some
 	 * architectures do not actually implement it. Is there a way to find
 	 * out whether it exists? For now, ARM is safe.
 	 */
 #if defined(CONFIG_ARM) && !defined(CONFIG_SYS_DCACHE_OFF)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
-
-	if (priv->flush_dcache) {
-		flush_dcache_range((ulong)priv->fb,
-				   ALIGN((ulong)priv->fb + priv->fb_size,
-					 CONFIG_SYS_CACHELINE_SIZE));
+	if (xstart < xend && priv->flush_dcache) {
+		ulong fb = (ulong)(priv->copy_fb ? priv->copy_fb : priv->fb);
+		ulong start, end;
+
+		start = fb + ystart * priv->line_length +
+			xstart * VNBITS(priv->bpix) / 8;
+		end = fb + (yend - 1) * priv->line_length +
+			DIV_ROUND_UP(xend * VNBITS(priv->bpix), 8);
+		flush_dcache_range(start & ~(CONFIG_SYS_CACHELINE_SIZE - 1),
+				   ALIGN(end, CONFIG_SYS_CACHELINE_SIZE));
 	}
 #elif defined(CONFIG_VIDEO_SANDBOX_SDL)
-	struct video_priv *priv = dev_get_uclass_priv(vid);
 	static ulong last_sync;
 
 	if (get_timer(last_sync) > 10) {
-		sandbox_sdl_sync(priv->fb);
+		sandbox_sdl_sync(priv->copy_fb ? priv->copy_fb : priv->fb);
 		last_sync = get_timer(0);
 	}
 #endif
@@ -216,12 +379,16 @@ static int video_post_probe(struct udevice *dev)
 	priv->fb = map_sysmem(plat->base, plat->size);
 	priv->line_length = priv->xsize * VNBYTES(priv->bpix);
 	priv->fb_size = priv->line_length * priv->ysize;
+	if (IS_ENABLED(CONFIG_VIDEO_COPY) && plat->copy_base)
+		priv->copy_fb = map_sysmem(plat->copy_base, priv->fb_size);
 
 	/* Set up colors  */
 	video_set_default_colors(priv);
 
 	if (!CONFIG_IS_ENABLED(NO_FB_CLEAR))
 		video_clear(dev);
+	else if (priv->copy_fb)
+		memcpy(priv->fb, priv->copy_fb, priv->fb_size);
 
 	/*
 	 * Create a text console device. For now we always do this, although
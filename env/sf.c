@@ -12,6 +12,7 @@
 #include <common.h>
 #include <dm.h>
 #include <environment.h>
+#include <env_sf_log.h>
 #include <malloc.h>
 #include <spi.h>
 #include <spi_flash.h>
@@ -37,7 +38,7 @@
 #define INITENV
 #endif
 
-#ifdef CONFIG_ENV_OFFSET_REDUND
+#if defined(CONFIG_ENV_OFFSET_REDUND) && !defined(CONFIG_ENV_SF_LOG)
 #ifdef CMD_SAVEENV
 static ulong env_offset		= CONFIG_ENV_OFFSET;
 static ulong env_new_offset	= CONFIG_ENV_OFFSET_REDUND;
@@ -81,7 +82,59 @@ static int setup_flash_device(void)
 	return 0;
 }
 
-#if defined(CONFIG_ENV_OFFSET_REDUND)
+#if defined(CONFIG_ENV_SF_LOG)
+static struct env_sf_log env_log = {
+	.offset		= {
+		CONFIG_ENV_OFFSET,
+#ifdef CONFIG_ENV_OFFSET_REDUND
+		CONFIG_ENV_OFFSET_REDUND,
+#endif
+	},
+#ifdef CONFIG_ENV_OFFSET_REDUND
+	.num_areas	= 2,
+#else
+	.num_areas	= 1,
+#endif
+	.area_size	= DIV_ROUND_UP(CONFIG_ENV_SIZE, CONFIG_ENV_SECT_SIZE) *
+			  CONFIG_ENV_SECT_SIZE,
+	.full		= true,
+};
+
+#ifdef CMD_SAVEENV
+static int env_sf_save(void)
+{
+	int ret;
+
+	ret = setup_flash_device();
+	if (ret)
+		return ret;
+	env_log.flash = env_flash;
+
+	return env_sf_log_save(&env_log);
+}
+#endif /* CMD_SAVEENV */
+
+static int env_sf_load(void)
+{
+	int ret;
+
+	ret = setup_flash_device();
+	if (ret)
+		return ret;
+	env_log.flash = env_flash;
+
+	ret = env_sf_log_load(&env_log);
+	if (ret)
+		set_default_env("!bad env area");
+	else
+		gd->env_valid = ENV_VALID;
+
+	spi_flash_free(env_flash);
+	env_flash = NULL;
+
+	return ret;
+}
+#elif defined(CONFIG_ENV_OFFSET_REDUND)
 #ifdef CMD_SAVEENV
 static int env_sf_save(void)
 {
@@ -0,0 +1,361 @@
+/*
+ * Log-structured environment in SPI flash
+ *
+ * Each environment area holds a journal of records. The first record in an
+ * area is a snapshot of the whole environment and each following record
+ * holds only the variables changed by one saveenv: "name=value" to set a
+ * variable and "name=" to delete it. Records are appended to the erased part
+ * of the area, so a typical save costs a page program rather than a sector
+ * erase. When the area is full the log is compacted by writing a new
+ * snapshot, into the other area if there are two so that an interrupted
+ * compaction leaves the previous log intact.
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <environment.h>
+#include <env_sf_log.h>
+#include <errno.h>
+#include <malloc.h>
+#include <search.h>
+#include <spi_flash.h>
+
+#define ENV_LOG_MAGIC		0x4c564e45	/* "ENVL" */
+#define ENV_LOG_ALIGN		16
+
+enum env_log_type {
+	ENV_LOG_FULL		= 1,
+	ENV_LOG_DELTA,
+};
+
+/**
+ * struct env_log_rec - header of a record in the environment log
+ *
+ * @magic: ENV_LOG_MAGIC
+ * @type: Record type (enum env_log_type)
+ * @gen: Generation of the area, incremented each time the log is compacted
+ * @len: Number of data bytes following the header
+ * @crc: CRC32 of the header fields above followed by the data
+ */
+struct env_log_rec {
+	uint32_t magic;
+	uint32_t type;
+	uint32_t gen;
+	uint32_t len;
+	uint32_t crc;
+};
+
+static uint32_t env_log_crc(const struct env_log_rec *rec)
+{
+	uint32_t crc;
+
+	crc = crc32(0, (const uchar *)rec, offsetof(struct env_log_rec, crc));
+
+	return crc32(crc, (const uchar *)(rec + 1), rec->len);
+}
+
+/*
+ * Check the record at offset @pos of an area read into @buf. Returns the
+ * space it occupies in the area, or 0 if there is no valid record there.
+ */
+static ulong env_log_check(struct env_sf_log *log, const char *buf,
+			   ulong pos, uint32_t gen)
+{
+	const struct env_log_rec *rec = (const void *)(buf + pos);
+
+	if (pos + sizeof(*rec) > log->area_size)
+		return 0;
+	if (rec->magic != ENV_LOG_MAGIC || rec->gen != gen ||
+	    rec->len > log->area_size - pos - sizeof(*rec))
+		return 0;
+	if (env_log_crc(rec) != rec->crc)
+		return 0;
+
+	return ALIGN(sizeof(*rec) + rec->len, ENV_LOG_ALIGN);
+}
+
+/* Import the snapshot at the start of @buf and replay the records after it */
+static int env_log_replay(struct env_sf_log *log, const char *buf)
+{
+	const struct env_log_rec *rec = (const void *)buf;
+	env_t *env;
+	ulong pos, len;
+	int ret;
+
+	if (rec->type != ENV_LOG_FULL || rec->len > ENV_SIZE)
+		return -EINVAL;
+
+	env = memalign(ARCH_DMA_MINALIGN, CONFIG_ENV_SIZE);
+	if (!env)
+		return -ENOMEM;
+	memset(env, '\0', CONFIG_ENV_SIZE);
+	memcpy(env->data, rec + 1, rec->len);
+	ret = env_import((char *)env, 0);
+	free(env);
+	if (ret)
+		return ret;
+
+	pos = env_log_check(log, buf, 0, log->gen);
+	while ((len = env_log_check(log, buf, pos, log->gen))) {
+		rec = (const void *)(buf + pos);
+		if (rec->type != ENV_LOG_DELTA)
+			break;
+		if (!himport_r(&env_htab, (const char *)(rec + 1), rec->len,
+			       '\0', H_NOCLEAR | H_FORCE, 0, 0, NULL)) {
+			pr_err("Cannot import environment: errno = %d\n",
+			       errno);
+			break;
+		}
+		pos += len;
+	}
+	log->pos = pos;
+
+	/* A torn write leaves programmed bytes which we cannot append to */
+	log->full = false;
+	for (; pos < log->area_size; pos++) {
+		if ((uchar)buf[pos] != 0xff) {
+			log->full = true;
+			break;
+		}
+	}
+
+	return 0;
+}
+
+#ifndef CONFIG_SPL_BUILD
+/* Compare variable names in two hexport_r() entries ("name=value") */
+static int env_log_keycmp(const char *a, const char *b)
+{
+	for (; *a != '=' && *a == *b; a++, b++)
+		;
+
+	return (*a == '=' ? 0 : (uchar)*a) - (*b == '=' ? 0 : (uchar)*b);
+}
+
+/*
+ * Write the differences between two sorted exports into @out: "name=value"
+ * for each new or changed variable and "name=" for each deleted one. Returns
+ * the number of bytes used, including the terminating empty entry.
+ */
+static ulong env_log_diff(const char *old, const char *new, char *out)
+{
+	char *p = out;
+	int cmp;
+
+	while (*old || *new) {
+		if (!*new)
+			cmp = -1;
+		else if (!*old)
+			cmp = 1;
+		else
+			cmp = env_log_keycmp(old, new);
+
+		if (cmp < 0) {
+			while (*old != '=')
+				*p++ = *old++;
+			*p++ = '=';
+			*p++ = '\0';
+		} else if (cmp > 0 || strcmp(old, new)) {
+			strcpy(p, new);
+			p += strlen(new) + 1;
+		}
+		if (cmp <= 0)
+			old += strlen(old) + 1;
+		if (cmp >= 0)
+			new += strlen(new) + 1;
+	}
+	*p++ = '\0';
+
+	return p - out;
+}
+
+static int env_log_append(struct env_sf_log *log, enum env_log_type type,
+			  const char *data, ulong len)
+{
+	struct env_log_rec *rec;
+	ulong size;
+	int ret;
+
+	size = ALIGN(sizeof(*rec) + len, ENV_LOG_ALIGN);
+	rec = memalign(ARCH_DMA_MINALIGN, size);
+	if (!rec)
+		return -ENOMEM;
+
+	/* Leave the padding erased */
+	memset(rec, 0xff, size);
+	rec->magic = ENV_LOG_MAGIC;
+	rec->type = type;
+	rec->gen = log->gen;
+	rec->len = len;
+	memcpy(rec + 1, data, len);
+	rec->crc = env_log_crc(rec);
+
+	puts("Writing to SPI flash...");
+	ret = spi_flash_write(log->flash, log->offset[log->area] + log->pos,
+			      size, rec);
+	free(rec);
+	if (ret) {
+		log->full = true;
+		return ret;
+	}
+	log->pos += size;
+
+	return 0;
+}
+
+/* Start a new log with a snapshot of the environment */
+static int env_log_compact(struct env_sf_log *log, const char *data,
+			   ulong len)
+{
+	int ret;
+
+	log->area = (log->area + 1) % log->num_areas;
+	log->gen++;
+	log->pos = 0;
+	log->full = true;
+
+	puts("Erasing SPI flash...");
+	ret = spi_flash_erase(log->flash, log->offset[log->area],
+			      log->area_size);
+	if (ret)
+		return ret;
+
+	ret = env_log_append(log, ENV_LOG_FULL, data, len);
+	if (ret)
+		return ret;
+	log->full = false;
+
+	return 0;
+}
+
+int env_sf_log_save(struct env_sf_log *log)
+{
+	char *res = NULL, *delta = NULL;
+	ssize_t len;
+	ulong delta_len;
+	int ret = 0;
+
+	len = hexport_r(&env_htab, '\0', 0, &res, 0, 0, NULL);
+	if (len < 0) {
+		pr_err("Cannot export environment: errno = %d\n", errno);
+		return -EIO;
+	}
+	if (len > ENV_SIZE) {
+		printf("Environment too large: %zd bytes, max %d\n", len,
+		       (int)ENV_SIZE);
+		ret = -E2BIG;
+		goto done;
+	}
+
+	if (!log->full && log->base) {
+		delta = malloc(strlen(log->base) + 1 + len);
+		if (!delta) {
+			ret = -ENOMEM;
+			goto done;
+		}
+		delta_len = env_log_diff(log->base, res, delta);
+		if (delta_len == 1) {
+			puts("No changes...");
+		} else if (log->pos + sizeof(struct env_log_rec) +
+			   delta_len <= log->area_size) {
+			ret = env_log_append(log, ENV_LOG_DELTA, delta,
+					     delta_len);
+			if (ret)
+				printf("append failed (err=%d), compacting...",
+				       ret);
+		} else {
+			log->full = true;
+		}
+	} else {
+		log->full = true;
+	}
+
+	if (log->full)
+		ret = env_log_compact(log, res, len);
+	if (ret)
+		goto done;
+
+	puts("done\n");
+	free(log->base);
+	log->base = res;
+	res = NULL;
+
+ done:
+	free(delta);
+	free(res);
+
+	return ret;
+}
+
+/* Remember what is in flash so that the next save only writes changes */
+static void env_log_set_base(struct env_sf_log *log)
+{
+	char *res = NULL;
+
+	free(log->base);
+	log->base = NULL;
+	if (hexport_r(&env_htab, '\0', 0, &res, 0, 0, NULL) >= 0)
+		log->base = res;
+	else
+		log->full = true;
+}
+#endif /* !CONFIG_SPL_BUILD */
+
+int env_sf_log_load(struct env_sf_log *log)
+{
+	struct env_log_rec hdr[ENV_SF_LOG_MAX_AREAS];
+	int order[ENV_SF_LOG_MAX_AREAS];
+	char *buf;
+	int i, ret;
+
+	if (log->num_areas < 1 || log->num_areas > ENV_SF_LOG_MAX_AREAS)
+		return -EINVAL;
+	buf = memalign(ARCH_DMA_MINALIGN, log->area_size);
+	if (!buf)
+		return -ENOMEM;
+
+	/* Try the area with the newest generation first */
+	for (i = 0; i < log->num_areas; i++) {
+		order[i] = i;
+		if (spi_flash_read(log->flash, log->offset[i], sizeof(hdr[i]),
+				   &hdr[i]) ||
+		    hdr[i].magic != ENV_LOG_MAGIC)
+			hdr[i].magic = 0;
+	}
+	for (i = 1; i < log->num_areas; i++) {
+		int best = order[0];
+		int32_t newer = hdr[i].gen - hdr[best].gen;
+
+		if (hdr[i].magic && (!hdr[best].magic || newer > 0)) {
+			order[0] = i;
+			order[i] = best;
+		}
+	}
+
+	ret = -ENOENT;
+	for (i = 0; i < log->num_areas && ret; i++) {
+		int area = order[i];
+
+		if (!hdr[area].magic)
+			continue;
+		if (spi_flash_read(log->flash, log->offset[area],
+				   log->area_size, buf))
+			continue;
+		if (!env_log_check(log, buf, 0, hdr[area].gen))
+			continue;
+		log->area = area;
+		log->gen = hdr[area].gen;
+		ret = env_log_replay(log, buf);
+	}
+	free(buf);
+
+	if (ret)
+		log->full = true;
+#ifndef CONFIG_SPL_BUILD
+	if (!log->full)
+		env_log_set_base(log);
+#endif
+
+	return ret;
+}
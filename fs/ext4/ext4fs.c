@@ -24,6 +24,7 @@
 #include <common.h>
 #include <ext_common.h>
 #include <ext4fs.h>
+#include <fs.h>
 #include "ext4_common.h"
 #include <div64.h>
 
@@ -238,6 +239,80 @@ int ext4_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
 	return ext4fs_read(buf, offset, len, len_read);
 }
 
+/*
+ * An open ext4 file keeps its own copy of the mounted filesystem and the
+ * resolved inode, so reads need neither a new mount nor a path lookup.
+ */
+struct ext4_file {
+	struct fs_file parent;
+	struct ext_filesystem fs;
+	struct ext2_data *data;
+	struct ext2fs_node *node;
+};
+
+int ext4fs_openfile(const char *filename, struct fs_file **filep)
+{
+	struct ext4_file *file;
+	loff_t size;
+
+	file = calloc(1, sizeof(*file));
+	if (!file)
+		return -ENOMEM;
+
+	if (ext4fs_open(filename, &size) < 0) {
+		free(file);
+		return -ENOENT;
+	}
+
+	/* Take over the mount, fs_close() must not free it */
+	file->data = ext4fs_root;
+	file->node = ext4fs_file;
+	file->fs = *get_fs();
+	ext4fs_root = NULL;
+	ext4fs_file = NULL;
+
+	file->parent.size = size;
+	*filep = &file->parent;
+
+	return 0;
+}
+
+int ext4fs_pread(struct fs_file *filep, void *buf, loff_t offset, loff_t len,
+		 loff_t *actread)
+{
+	struct ext4_file *file = container_of(filep, struct ext4_file, parent);
+	struct ext2_data *saved_root = ext4fs_root;
+	struct ext2fs_node *saved_file = ext4fs_file;
+	struct ext_filesystem saved_fs = *get_fs();
+	int ret;
+
+	ext4fs_set_blk_dev(filep->desc, &filep->partition);
+	*get_fs() = file->fs;
+	ext4fs_root = file->data;
+	ext4fs_file = file->node;
+	ext4fs_reinit_global();
+
+	ret = ext4fs_read_file(file->node, offset, len, buf, actread);
+
+	/* The indirect block caches must not outlive this mount */
+	ext4fs_reinit_global();
+	*get_fs() = saved_fs;
+	ext4fs_root = saved_root;
+	ext4fs_file = saved_file;
+
+	return ret;
+}
+
+void ext4fs_closefile(struct fs_file *filep)
+{
+	struct ext4_file *file = container_of(filep, struct ext4_file, parent);
+
+	if (file->node != &file->data->diropen)
+		free(file->node);
+	free(file->data);
+	free(file);
+}
+
 int ext4fs_uuid(char *uuid_str)
 {
 	if (ext4fs_root == NULL)
@@ -309,14 +309,33 @@ get_cluster(fsdata *mydata, __u32 clustnum, __u8 *buffer, unsigned long size)
 __u8 get_contents_vfatname_block[MAX_CLUSTSIZE]
 	__aligned(ARCH_DMA_MINALIGN);
 
+/*
+ * Position in the cluster chain of an open file: the cluster that starts at
+ * file offset 'pos'. Lets sequential reads continue where the previous one
+ * stopped instead of walking the FAT from the first cluster again.
+ */
+struct fat_cursor {
+	__u32 clust;
+	loff_t pos;
+};
+
+static void set_cursor(struct fat_cursor *cursor, __u32 clust, loff_t pos)
+{
+	if (cursor) {
+		cursor->clust = clust;
+		cursor->pos = pos;
+	}
+}
+
 static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
-			__u8 *buffer, loff_t maxsize, loff_t *gotsize)
+			__u8 *buffer, loff_t maxsize, loff_t *gotsize,
+			struct fat_cursor *cursor)
 {
 	loff_t filesize = FAT2CPU32(dentptr->size);
 	unsigned int bytesperclust = mydata->clust_size * mydata->sect_size;
 	__u32 curclust = START(dentptr);
 	__u32 endclust, newclust;
-	loff_t actsize;
+	loff_t actsize, clustpos;
 
 	*gotsize = 0;
 	debug("Filesize: %llu bytes\n", filesize);
@@ -333,6 +352,12 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 
 	actsize = bytesperclust;
 
+	/* start from the cursor if it is not past pos */
+	if (cursor && cursor->clust && cursor->pos <= pos) {
+		curclust = cursor->clust;
+		actsize += cursor->pos;
+	}
+
 	/* go to cluster at pos */
 	while (actsize <= pos) {
 		curclust = get_fatent(mydata, curclust);
@@ -346,6 +371,7 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 
 	/* actsize > pos */
 	actsize -= bytesperclust;
+	clustpos = actsize;
 	filesize -= actsize;
 	pos -= actsize;
 
@@ -361,9 +387,12 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 		actsize -= pos;
 		memcpy(buffer, get_contents_vfatname_block + pos, actsize);
 		*gotsize += actsize;
-		if (!filesize)
+		if (!filesize) {
+			set_cursor(cursor, curclust, clustpos);
 			return 0;
+		}
 		buffer += actsize;
+		clustpos += bytesperclust;
 
 		curclust = get_fatent(mydata, curclust);
 		if (CHECK_CLUST(curclust, mydata->fatsize)) {
@@ -392,9 +421,11 @@ static int get_contents(fsdata *mydata, dir_entry *dentptr, loff_t pos,
 		}
 
 		/* get remaining bytes */
+		set_cursor(cursor, endclust, clustpos + actsize - bytesperclust);
 		actsize = filesize;
 		if (get_cluster(mydata, curclust, buffer, (int)actsize) != 0) {
 			printf("Error reading cluster\n");
+			set_cursor(cursor, 0, 0);
 			return -1;
 		}
 		*gotsize += actsize;
@@ -407,6 +438,7 @@ getit:
 		*gotsize += (int)actsize;
 		filesize -= actsize;
 		buffer += actsize;
+		clustpos += actsize;
 
 		curclust = get_fatent(mydata, endclust);
 		if (CHECK_CLUST(curclust, mydata->fatsize)) {
@@ -1097,7 +1129,8 @@ int file_fat_read_at(const char *filename, loff_t pos, void *buffer,
 		goto out_free_both;
 
 	debug("reading %s\n", filename);
-	ret = get_contents(&fsdata, itr->dent, pos, buffer, maxsize, actread);
+	ret = get_contents(&fsdata, itr->dent, pos, buffer, maxsize, actread,
+			   NULL);
 
 out_free_both:
 	free(fsdata.fatbuf);
@@ -1195,6 +1228,75 @@ void fat_closedir(struct fs_dir_stream *dirs)
 	free(dir);
 }
 
+typedef struct {
+	struct fs_file parent;
+	fsdata fsdata;
+	dir_entry dent;
+	struct fat_cursor cursor;
+} fat_file;
+
+int fat_openfile(const char *filename, struct fs_file **filep)
+{
+	fat_file *file;
+	fat_itr *itr;
+	int ret;
+
+	itr = malloc_cache_aligned(sizeof(fat_itr));
+	if (!itr)
+		return -ENOMEM;
+	file = malloc(sizeof(*file));
+	if (!file) {
+		ret = -ENOMEM;
+		goto out_free_itr;
+	}
+	memset(file, 0, sizeof(*file));
+
+	ret = fat_itr_root(itr, &file->fsdata);
+	if (ret)
+		goto out_free_file;
+
+	ret = fat_itr_resolve(itr, filename, TYPE_FILE);
+	if (ret) {
+		free(file->fsdata.fatbuf);
+		goto out_free_file;
+	}
+
+	file->dent = *itr->dent;
+	file->parent.size = FAT2CPU32(file->dent.size);
+	*filep = &file->parent;
+	free(itr);
+
+	return 0;
+
+out_free_file:
+	free(file);
+out_free_itr:
+	free(itr);
+	return ret;
+}
+
+int fat_pread(struct fs_file *filep, void *buf, loff_t offset, loff_t len,
+	      loff_t *actread)
+{
+	fat_file *file = (fat_file *)filep;
+
+	cur_dev = filep->desc;
+	cur_part_info = filep->partition;
+	/* The FAT may have been changed since the last read */
+	file->fsdata.fatbufnum = -1;
+
+	return get_contents(&file->fsdata, &file->dent, offset, buf, len,
+			    actread, &file->cursor);
+}
+
+void fat_closefile(struct fs_file *filep)
+{
+	fat_file *file = (fat_file *)filep;
+
+	free(file->fsdata.fatbuf);
+	free(file);
+}
+
 void fat_close(void)
 {
 }
@@ -7,6 +7,7 @@
 #include <config.h>
 #include <errno.h>
 #include <common.h>
+#include <malloc.h>
 #include <mapmem.h>
 #include <part.h>
 #include <ext4fs.h>
@@ -106,6 +107,33 @@ static inline int fs_opendir_unsupported(const char *filename,
 	return -EACCES;
 }
 
+static inline int fs_openfile_unsupported(const char *filename,
+					  struct fs_file **filep)
+{
+	return -EACCES;
+}
+
+/*
+ * Generic open file for filesystems without native support: remember the
+ * path and re-resolve it on every read. Only the filesystem type the file
+ * was opened with is probed again, on the partition recorded in the file.
+ */
+struct fs_generic_file {
+	struct fs_file parent;
+	char name[0];
+};
+
+static int __maybe_unused fs_openfile_generic(const char *filename,
+					      struct fs_file **filep);
+static int __maybe_unused fs_pread_generic(struct fs_file *file, void *buf,
+					   loff_t offset, loff_t len,
+					   loff_t *actread);
+
+static void __maybe_unused fs_closefile_generic(struct fs_file *file)
+{
+	free(file);
+}
+
 struct fstype_info {
 	int fstype;
 	char *name;
@@ -143,6 +171,21 @@ struct fstype_info {
 	int (*readdir)(struct fs_dir_stream *dirs, struct fs_dirent **dentp);
 	/* see fs_closedir() */
 	void (*closedir)(struct fs_dir_stream *dirs);
+	/*
+	 * Open a file.  On success return 0 and the open file via 'filep',
+	 * with its size filled in.  On error, return -errno.  See
+	 * fs_openfile().
+	 */
+	int (*openfile)(const char *filename, struct fs_file **filep);
+	/*
+	 * Read from an open file.  Called without the partition being set,
+	 * the filesystem must access the device through the fields of
+	 * 'file'.  See fs_pread().
+	 */
+	int (*pread)(struct fs_file *file, void *buf, loff_t offset,
+		     loff_t len, loff_t *actread);
+	/* see fs_closefile() */
+	void (*closefile)(struct fs_file *file);
 };
 
 static struct fstype_info fstypes[] = {
@@ -166,6 +209,9 @@ static struct fstype_info fstypes[] = {
 		.opendir = fat_opendir,
 		.readdir = fat_readdir,
 		.closedir = fat_closedir,
+		.openfile = fat_openfile,
+		.pread = fat_pread,
+		.closefile = fat_closefile,
 	},
 #endif
 #ifdef CONFIG_FS_EXT4
@@ -186,6 +232,9 @@ static struct fstype_info fstypes[] = {
 #endif
 		.uuid = ext4fs_uuid,
 		.opendir = fs_opendir_unsupported,
+		.openfile = ext4fs_openfile,
+		.pread = ext4fs_pread,
+		.closefile = ext4fs_closefile,
 	},
 #endif
 #ifdef CONFIG_SANDBOX
@@ -202,6 +251,9 @@ static struct fstype_info fstypes[] = {
 		.write = fs_write_sandbox,
 		.uuid = fs_uuid_unsupported,
 		.opendir = fs_opendir_unsupported,
+		.openfile = fs_openfile_generic,
+		.pread = fs_pread_generic,
+		.closefile = fs_closefile_generic,
 	},
 #endif
 #ifdef CONFIG_CMD_UBIFS
@@ -218,6 +270,9 @@ static struct fstype_info fstypes[] = {
 		.write = fs_write_unsupported,
 		.uuid = fs_uuid_unsupported,
 		.opendir = fs_opendir_unsupported,
+		.openfile = fs_openfile_generic,
+		.pread = fs_pread_generic,
+		.closefile = fs_closefile_generic,
 	},
 #endif
 #ifdef CONFIG_FS_BTRFS
@@ -234,6 +289,9 @@ static struct fstype_info fstypes[] = {
 		.write = fs_write_unsupported,
 		.uuid = btrfs_uuid,
 		.opendir = fs_opendir_unsupported,
+		.openfile = fs_openfile_generic,
+		.pread = fs_pread_generic,
+		.closefile = fs_closefile_generic,
 	},
 #endif
 	{
@@ -249,6 +307,7 @@ static struct fstype_info fstypes[] = {
 		.write = fs_write_unsupported,
 		.uuid = fs_uuid_unsupported,
 		.opendir = fs_opendir_unsupported,
+		.openfile = fs_openfile_unsupported,
 	},
 };
 
@@ -323,6 +382,7 @@ int fs_set_blk_dev_with_part(struct blk_desc *desc, int part)
 	if (ret)
 		return ret;
 	fs_dev_desc = desc;
+	fs_dev_part = part;
 
 	for (i = 0, info = fstypes; i < ARRAY_SIZE(fstypes); i++, info++) {
 		if (!info->probe(fs_dev_desc, &fs_partition)) {
@@ -485,6 +545,100 @@ void fs_closedir(struct fs_dir_stream *dirs)
 	fs_close();
 }
 
+static int fs_openfile_generic(const char *filename, struct fs_file **filep)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_generic_file *file;
+	loff_t size;
+
+	if (info->size(filename, &size))
+		return -ENOENT;
+
+	file = malloc(sizeof(*file) + strlen(filename) + 1);
+	if (!file)
+		return -ENOMEM;
+	strcpy(file->name, filename);
+	file->parent.size = size;
+
+	*filep = &file->parent;
+
+	return 0;
+}
+
+static int fs_pread_generic(struct fs_file *file, void *buf, loff_t offset,
+			    loff_t len, loff_t *actread)
+{
+	struct fs_generic_file *gfile;
+	struct fstype_info *info;
+	int ret;
+
+	gfile = container_of(file, struct fs_generic_file, parent);
+	info = fs_get_info(file->fstype);
+
+	/*
+	 * Set up the partition the file was opened on. Backends such as
+	 * hostfs have no block device, so there is nothing to look up.
+	 */
+	fs_dev_desc = file->desc;
+	fs_dev_part = file->part;
+	fs_partition = file->partition;
+	if (info->probe(fs_dev_desc, &fs_partition))
+		return -EIO;
+	fs_type = file->fstype;
+
+	ret = info->read(gfile->name, buf, offset, len, actread);
+	fs_close();
+
+	return ret;
+}
+
+struct fs_file *fs_openfile(const char *filename)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file *file = NULL;
+	int ret;
+
+	ret = info->openfile(filename, &file);
+	if (!ret) {
+		file->desc = fs_dev_desc;
+		file->part = fs_dev_part;
+		file->partition = fs_partition;
+		file->fstype = fs_type;
+	}
+	fs_close();
+	if (ret) {
+		errno = -ret;
+		return NULL;
+	}
+
+	return file;
+}
+
+int fs_pread(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+	     loff_t *actread)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+
+	*actread = 0;
+	if (offset >= file->size || !len)
+		return 0;
+	if (len > file->size - offset)
+		len = file->size - offset;
+
+	return info->pread(file, buf, offset, len, actread);
+}
+
+void fs_closefile(struct fs_file *file)
+{
+	struct fstype_info *info;
+
+	if (!file)
+		return;
+
+	info = fs_get_info(file->fstype);
+	info->closefile(file);
+}
+
 
 int do_size(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[],
 		int fstype)
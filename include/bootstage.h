@@ -200,6 +200,7 @@ enum bootstage_id {
 	BOOTSTATE_ID_ACCUM_DM_SPL,
 	BOOTSTATE_ID_ACCUM_DM_F,
 	BOOTSTATE_ID_ACCUM_DM_R,
+	BOOTSTAGE_ID_BOOTM_PLACE,
 
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
@@ -17,6 +17,33 @@ extern int u_boot_hush_start(void);
 extern int parse_string_outer(const char *, int);
 extern int parse_file_outer(void);
 
+#ifdef CONFIG_HUSH_PARSE_CACHE
+/**
+ * parse_string_cached() - run an environment variable holding a script
+ *
+ * Like parse_string_outer(), but keeps the parsed script and runs it again
+ * without parsing for as long as the variable holds the same text.
+ *
+ * @name:	name of the environment variable
+ * @s:		its value
+ * @flag:	FLAG_... parser flags
+ * @return 0 on success, 1 on failure
+ */
+int parse_string_cached(const char *name, const char *s, int flag);
+
+/**
+ * hush_cache_flush() - drop all parsed scripts that are not running
+ */
+void hush_cache_flush(void);
+
+/**
+ * hush_cache_enable() - turn the cache of parsed scripts on or off
+ *
+ * @enable:	0 to flush the cache and always parse scripts again
+ */
+void hush_cache_enable(int enable);
+#endif
+
 int set_local_var(const char *s, int flg_export);
 void unset_local_var(const char *name);
 char *get_local_var(const char *s);
@@ -104,7 +104,7 @@
 					"ipaddr=1.2.3.4\0"
 
 #define MEM_LAYOUT_ENV_SETTINGS \
-	"bootm_size=0x10000000\0" \
+	"bootm_size=0x8000000\0" \
 	"kernel_addr_r=0x1000000\0" \
 	"fdt_addr_r=0xc00000\0" \
 	"ramdisk_addr_r=0x2000000\0" \
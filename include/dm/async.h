@@ -0,0 +1,155 @@
+/*
+ * Operations started by drivers which complete in the background
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef _DM_ASYNC_H
+#define _DM_ASYNC_H
+
+#include <linux/errno.h>
+#include <linux/list.h>
+#include <linux/types.h>
+
+struct udevice;
+struct dm_async;
+
+/**
+ * dm_async_poll_t - Move an operation along
+ *
+ * This is called once the deadline of the operation has passed. It must not
+ * wait for the hardware: if the operation is not finished, it should call
+ * dm_async_delay() to set when to be called next and return -EAGAIN.
+ *
+ * @op:		Operation to move along
+ * @return -EAGAIN if not finished, else the result of the operation (0 if
+ *	OK, -ve on error)
+ */
+typedef int (*dm_async_poll_t)(struct dm_async *op);
+
+/**
+ * struct dm_async - an operation which completes in the background
+ *
+ * Probing is strictly sequential, so a driver waiting for its hardware to
+ * settle (a card powering up, a PHY negotiating its link) holds up
+ * everything after it. Instead, the driver can embed one of these in its
+ * private data and start it with dm_async_start(). The operation is then
+ * moved along by dm_async_poll(), which is called each time a device is
+ * probed and while the console waits for input. Nothing polls while an
+ * image is loaded. When the driver needs the result, dm_async_wait()
+ * finishes the operation. Any operations still in progress are finished
+ * before all devices are removed to boot an OS.
+ *
+ * All fields are set up by dm_async_start().
+ *
+ * @dev:	Device the operation belongs to, or NULL. Operations of a
+ *		device are cancelled when it is removed
+ * @name:	Name of the operation, for debugging
+ * @poll:	Function to move the operation along
+ * @deadline:	Time (in ms, see get_timer()) to call @poll next
+ * @ret:	-EINPROGRESS until the operation is finished, then its result
+ * @node:	Node in the list of operations in progress
+ */
+struct dm_async {
+	struct udevice *dev;
+	const char *name;
+	dm_async_poll_t poll;
+	ulong deadline;
+	int ret;
+	struct list_head node;
+};
+
+/**
+ * dm_async_pending() - Check whether an operation is still in progress
+ *
+ * @op:		Operation to check
+ * @return true if in progress, false if finished, cancelled or never started
+ */
+static inline bool dm_async_pending(struct dm_async *op)
+{
+	return op->ret == -EINPROGRESS;
+}
+
+#if CONFIG_IS_ENABLED(DM_ASYNC)
+
+/**
+ * dm_async_start() - Start an operation
+ *
+ * @op:		Operation to start, which must stay valid until it finishes
+ * @dev:	Device the operation belongs to, or NULL
+ * @name:	Name of the operation, for debugging
+ * @poll:	Function to move the operation along
+ * @delay_ms:	Time to wait before calling @poll the first time
+ * @return 0 if OK, -EBUSY if the operation is already in progress
+ */
+int dm_async_start(struct dm_async *op, struct udevice *dev, const char *name,
+		   dm_async_poll_t poll, ulong delay_ms);
+
+/**
+ * dm_async_delay() - Set when to move an operation along next
+ *
+ * @op:		Operation to update
+ * @delay_ms:	Time from now to call its poll function
+ */
+void dm_async_delay(struct dm_async *op, ulong delay_ms);
+
+/**
+ * dm_async_poll() - Move along all operations whose deadline has passed
+ *
+ * This does not wait and does nothing when called from a poll function.
+ */
+void dm_async_poll(void);
+
+/**
+ * dm_async_wait() - Wait for an operation to finish
+ *
+ * Other operations carry on meanwhile.
+ *
+ * @op:		Operation to wait for
+ * @return result of the operation (0 if OK, -ve on error), -ECANCELED if it
+ *	was cancelled
+ */
+int dm_async_wait(struct dm_async *op);
+
+/**
+ * dm_async_wait_all() - Wait for all operations to finish
+ *
+ * This is called before all devices are removed, e.g. to boot an OS.
+ */
+void dm_async_wait_all(void);
+
+/**
+ * dm_async_cancel() - Cancel an operation
+ *
+ * Its poll function is not called again and its result is -ECANCELED.
+ *
+ * @op:		Operation to cancel. Nothing happens if it is not in progress
+ */
+void dm_async_cancel(struct dm_async *op);
+
+/**
+ * dm_async_cancel_dev() - Cancel all operations of a device
+ *
+ * This is called when the device is removed.
+ *
+ * @dev:	Device whose operations to cancel
+ */
+void dm_async_cancel_dev(struct udevice *dev);
+
+#else
+
+static inline void dm_async_poll(void)
+{
+}
+
+static inline void dm_async_wait_all(void)
+{
+}
+
+static inline void dm_async_cancel_dev(struct udevice *dev)
+{
+}
+
+#endif
+
+#endif
@@ -238,9 +238,9 @@ struct efi_runtime_services {
 			u32 reset_type);
 	efi_status_t (EFIAPI *query_variable_info)(
 			u32 attributes,
-			u64 maximum_variable_storage_size,
-			u64 remaining_variable_storage_size,
-			u64 maximum_variable_size);
+			u64 *maximum_variable_storage_size,
+			u64 *remaining_variable_storage_size,
+			u64 *maximum_variable_size);
 };
 
 /* EFI Configuration Table and GUID definitions */
@@ -477,6 +477,47 @@ struct efi_block_io {
 	efi_status_t (EFIAPI *flush_blocks)(struct efi_block_io *this);
 };
 
+#define BLOCK_IO2_GUID \
+	EFI_GUID(0xa77b2472, 0xe282, 0x4e9f, \
+		 0xa2, 0x45, 0xc2, 0xc0, 0xe2, 0x7b, 0xbc, 0xc1)
+
+struct efi_block_io2_token {
+	struct efi_event *event;
+	efi_status_t transaction_status;
+};
+
+struct efi_block_io2 {
+	struct efi_block_io_media *media;
+	efi_status_t (EFIAPI *reset)(struct efi_block_io2 *this,
+			bool extended_verification);
+	efi_status_t (EFIAPI *read_blocks_ex)(struct efi_block_io2 *this,
+			u32 media_id, u64 lba,
+			struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer);
+	efi_status_t (EFIAPI *write_blocks_ex)(struct efi_block_io2 *this,
+			u32 media_id, u64 lba,
+			struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer);
+	efi_status_t (EFIAPI *flush_blocks_ex)(struct efi_block_io2 *this,
+			struct efi_block_io2_token *token);
+};
+
+#define DISK_IO_GUID \
+	EFI_GUID(0xce345171, 0xba0b, 0x11d2, \
+		 0x8e, 0x4f, 0x00, 0xa0, 0xc9, 0x69, 0x72, 0x3b)
+
+#define EFI_DISK_IO_PROTOCOL_REVISION	0x00010000
+
+struct efi_disk_io {
+	u64 revision;
+	efi_status_t (EFIAPI *read_disk)(struct efi_disk_io *this,
+			u32 media_id, u64 offset, efi_uintn_t buffer_size,
+			void *buffer);
+	efi_status_t (EFIAPI *write_disk)(struct efi_disk_io *this,
+			u32 media_id, u64 offset, efi_uintn_t buffer_size,
+			void *buffer);
+};
+
 struct simple_text_output_mode {
 	s32 max_mode;
 	s32 mode;
@@ -13,6 +13,34 @@
 #include <part_efi.h>
 #include <efi_api.h>
 
+/* The memory map is also built on its own by sandbox, for testing */
+#if defined(CONFIG_EFI_MEMORY_MAP) && !defined(CONFIG_SPL_BUILD)
+/* More specific EFI memory allocator, called by EFI payloads */
+efi_status_t efi_allocate_pages(int type, int memory_type, efi_uintn_t pages,
+				uint64_t *memory);
+/* EFI memory free function. */
+efi_status_t efi_free_pages(uint64_t memory, efi_uintn_t pages);
+/* Returns the EFI memory map */
+efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
+				struct efi_mem_desc *memory_map,
+				efi_uintn_t *map_key,
+				efi_uintn_t *descriptor_size,
+				uint32_t *descriptor_version);
+/* Adds a range into the EFI memory map */
+uint64_t efi_add_memory_map(uint64_t start, uint64_t pages, int memory_type,
+			    bool overlap_only_ram);
+
+/*
+ * Check a memory type passed by a payload. Values from EFI_MAX_MEMORY_TYPE
+ * up to the OEM range at 0x70000000 are reserved. The OEM and OS ranges
+ * above are allowed, the latter wraps to negative values in an int.
+ */
+static inline bool efi_memory_type_valid(int memory_type)
+{
+	return memory_type < EFI_MAX_MEMORY_TYPE || memory_type >= 0x70000000;
+}
+#endif
+
 /* No need for efi loader support in SPL */
 #if defined(CONFIG_EFI_LOADER) && !defined(CONFIG_SPL_BUILD)
 
@@ -88,6 +116,10 @@ uint16_t *efi_dp_str(struct efi_device_path *dp);
 
 /* GUID of the EFI_BLOCK_IO_PROTOCOL */
 extern const efi_guid_t efi_block_io_guid;
+/* GUID of the EFI_BLOCK_IO2_PROTOCOL */
+extern const efi_guid_t efi_block_io2_guid;
+/* GUID of the EFI_DISK_IO_PROTOCOL */
+extern const efi_guid_t efi_disk_io_guid;
 extern const efi_guid_t efi_global_variable_guid;
 extern const efi_guid_t efi_guid_console_control;
 extern const efi_guid_t efi_guid_device_path;
@@ -151,6 +183,9 @@ struct efi_object {
  * @nofify_function:	Function to call when the event is triggered
  * @notify_context:	Data to be passed to the notify function
  * @trigger_type:	Type of timer, see efi_set_timer
+ * @timer_index:	Position in the heap of armed timers, negative if the
+ *			timer is not armed
+ * @queue_link:		Link in the queue of pending notifications
  * @queued:		The notification function is queued
  * @signaled:		The event occurred. The event is in the signaled state.
  */
@@ -162,6 +197,8 @@ struct efi_event {
 	u64 trigger_next;
 	u64 trigger_time;
 	enum efi_timer_delay trigger_type;
+	int timer_index;
+	struct list_head queue_link;
 	bool is_queued;
 	bool is_signaled;
 };
@@ -174,6 +211,12 @@ extern struct list_head efi_obj_list;
 int efi_console_register(void);
 /* Called by bootefi to make all disk storage accessible as EFI objects */
 efi_status_t efi_disk_register(void);
+/* Drop cached disk contents after the disk was written behind our back */
+#ifdef CONFIG_PARTITIONS
+void efi_disk_invalidate_cache(struct blk_desc *desc);
+#else
+static inline void efi_disk_invalidate_cache(struct blk_desc *desc) { }
+#endif
 /* Create handles and protocols for the partitions of a block device */
 int efi_disk_create_partitions(efi_handle_t parent, struct blk_desc *desc,
 			       const char *if_typename, int diskid,
@@ -197,6 +240,8 @@ efi_status_t efi_set_watchdog(unsigned long timeout);
 
 /* Called from places to check whether a timer expired */
 void efi_timer_check(void);
+/* Called to wait for the given time when there is nothing to do */
+void efi_cpu_idle(ulong usec);
 /* PE loader implementation */
 void *efi_load_pe(void *efi, struct efi_loaded_image *loaded_image_info);
 /* Called once to store the pristine gd pointer */
@@ -252,25 +297,11 @@ struct efi_file_handle *efi_file_from_path(struct efi_device_path *fp);
 
 /* Generic EFI memory allocator, call this to get memory */
 void *efi_alloc(uint64_t len, int memory_type);
-/* More specific EFI memory allocator, called by EFI payloads */
-efi_status_t efi_allocate_pages(int type, int memory_type, efi_uintn_t pages,
-				uint64_t *memory);
-/* EFI memory free function. */
-efi_status_t efi_free_pages(uint64_t memory, efi_uintn_t pages);
 /* EFI memory allocator for small allocations */
 efi_status_t efi_allocate_pool(int pool_type, efi_uintn_t size,
 			       void **buffer);
 /* EFI pool memory free function. */
 efi_status_t efi_free_pool(void *buffer);
-/* Returns the EFI memory map */
-efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
-				struct efi_mem_desc *memory_map,
-				efi_uintn_t *map_key,
-				efi_uintn_t *descriptor_size,
-				uint32_t *descriptor_version);
-/* Adds a range into the EFI memory map */
-uint64_t efi_add_memory_map(uint64_t start, uint64_t pages, int memory_type,
-			    bool overlap_only_ram);
 /* Called by board init to initialize the EFI drivers */
 efi_status_t efi_driver_init(void);
 /* Called by board init to initialize the EFI memory map */
@@ -337,6 +368,11 @@ static inline int guidcmp(const efi_guid_t *g1, const efi_guid_t *g2)
 	return memcmp(g1, g2, sizeof(efi_guid_t));
 }
 
+static inline void guidcpy(efi_guid_t *dst, const efi_guid_t *src)
+{
+	memcpy(dst, src, sizeof(efi_guid_t));
+}
+
 /*
  * Use these to indicate that your code / data should go into the EFI runtime
  * section and thus still be available when the OS is running
@@ -379,6 +415,15 @@ efi_status_t EFIAPI efi_get_next_variable(
 efi_status_t EFIAPI efi_set_variable(s16 *variable_name,
 		efi_guid_t *vendor, u32 attributes,
 		unsigned long data_size, void *data);
+efi_status_t EFIAPI efi_query_variable_info(
+		u32 attributes,
+		u64 *maximum_variable_storage_size,
+		u64 *remaining_variable_storage_size,
+		u64 *maximum_variable_size);
+/* Write changed EFI variables to the environment */
+void efi_variables_flush(void);
+/* Re-read EFI variables from the environment */
+void efi_variables_reload(void);
 
 void *efi_bootmgr_load(struct efi_device_path **device_path,
 		       struct efi_device_path **file_path);
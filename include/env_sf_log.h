@@ -0,0 +1,65 @@
+/*
+ * Log-structured environment in SPI flash
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#ifndef __ENV_SF_LOG_H__
+#define __ENV_SF_LOG_H__
+
+struct spi_flash;
+
+#define ENV_SF_LOG_MAX_AREAS	2
+
+/**
+ * struct env_sf_log - a log-structured environment in SPI flash
+ *
+ * The first four fields describe the layout and are set up by the caller,
+ * the rest tracks the log and is maintained by env_sf_log_load() and
+ * env_sf_log_save(). Start with @full set to true.
+ *
+ * @flash: SPI flash holding the log
+ * @offset: Offset of each area in the flash, aligned to an erase sector
+ * @num_areas: Number of entries in @offset (1 or 2)
+ * @area_size: Size of each area, a multiple of the erase sector size
+ * @area: Index of the active area in @offset
+ * @gen: Generation of the active area
+ * @pos: Offset of the first free byte in the active area
+ * @full: true if the next save must compact the log
+ * @base: The environment as stored in flash, in hexport_r() format
+ */
+struct env_sf_log {
+	struct spi_flash *flash;
+	ulong offset[ENV_SF_LOG_MAX_AREAS];
+	int num_areas;
+	ulong area_size;
+	int area;
+	uint32_t gen;
+	ulong pos;
+	bool full;
+	char *base;
+};
+
+/**
+ * env_sf_log_load() - Import the environment from a log in SPI flash
+ *
+ * The environment is only changed if a valid log is found.
+ *
+ * @log: Log to load
+ * @return 0 if OK, -ENOENT if there is no valid log, other -ve on error
+ */
+int env_sf_log_load(struct env_sf_log *log);
+
+/**
+ * env_sf_log_save() - Write the environment changes to a log in SPI flash
+ *
+ * This appends a record holding the changes since the last load or save,
+ * or starts a new log if there is no room or nothing is known about the
+ * current contents.
+ *
+ * @log: Log to update
+ * @return 0 if OK, -ve on error
+ */
+int env_sf_log_save(struct env_sf_log *log);
+
+#endif /* __ENV_SF_LOG_H__ */
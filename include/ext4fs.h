@@ -143,6 +143,11 @@ int ext4fs_ls(const char *dirname);
 int ext4fs_exists(const char *filename);
 int ext4fs_size(const char *filename, loff_t *size);
 void ext4fs_free_node(struct ext2fs_node *node, struct ext2fs_node *currroot);
+struct fs_file;
+int ext4fs_openfile(const char *filename, struct fs_file **filep);
+int ext4fs_pread(struct fs_file *filep, void *buf, loff_t offset, loff_t len,
+		 loff_t *actread);
+void ext4fs_closefile(struct fs_file *filep);
 int ext4fs_devread(lbaint_t sector, int byte_offset, int byte_len, char *buf);
 void ext4fs_set_blk_dev(struct blk_desc *rbdd, disk_partition_t *info);
 long int read_allocated_block(struct ext2_inode *inode, int fileblock);
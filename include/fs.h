@@ -146,6 +146,58 @@ struct fs_dirent *fs_readdir(struct fs_dir_stream *dirs);
  */
 void fs_closedir(struct fs_dir_stream *dirs);
 
+/*
+ * An open file, returned by fs_openfile(). Apart from @size it should be
+ * treated as opaque to the user of the fs layer. Filesystems may embed it
+ * in a larger structure holding the resolved inode and read position, so
+ * that reads do not have to look up the path again.
+ */
+struct fs_file {
+	loff_t size;         /* size in bytes */
+	/* private to fs. layer: */
+	struct blk_desc *desc;
+	int part;
+	disk_partition_t partition;
+	int fstype;
+};
+
+/*
+ * fs_openfile - Open a file on the partition previously set by
+ * fs_set_blk_dev() or fs_set_blk_dev_with_part()
+ *
+ * The file remains open across later calls to fs_set_blk_dev(), reads
+ * through it do not need the partition to be set again.
+ *
+ * @filename: the path to the file to open
+ * @return a pointer to the open file or NULL on error and errno
+ *    set appropriately
+ */
+struct fs_file *fs_openfile(const char *filename);
+
+/*
+ * fs_pread - Read from an open file
+ *
+ * Reads with increasing offsets, as done when loading a file in chunks,
+ * continue from the position reached by the previous read.
+ *
+ * @file: the open file
+ * @buf: buffer to read into
+ * @offset: the offset in the file to read from
+ * @len: the number of bytes to read
+ * @actread: returns the actual number of bytes read, which is less than
+ *    @len only at the end of the file
+ * @return 0 if ok with valid *actread, negative on error
+ */
+int fs_pread(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+	     loff_t *actread);
+
+/*
+ * fs_closefile - Close an open file
+ *
+ * @file: the open file
+ */
+void fs_closefile(struct fs_file *file);
+
 /*
  * Common implementation for various filesystem commands, optionally limited
  * to a specific filesystem type via the fstype parameter.
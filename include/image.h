@@ -691,10 +691,21 @@ int boot_get_fdt(int flag, int argc, char * const argv[], uint8_t arch,
 		 bootm_headers_t *images,
 		 char **of_flat_tree, ulong *of_size);
 void boot_fdt_add_mem_rsv_regions(struct lmb *lmb, void *fdt_blob);
+void boot_fdt_reserve_container(bootm_headers_t *images);
 int boot_relocate_fdt(struct lmb *lmb, char **of_flat_tree, ulong *of_size);
 
 int boot_ramdisk_high(struct lmb *lmb, ulong rd_data, ulong rd_len,
 		  ulong *initrd_start, ulong *initrd_end);
+
+#ifdef CONFIG_LMB
+ulong boot_place_image(struct lmb *lmb, ulong addr, ulong size, ulong align,
+		       ulong max_addr);
+void boot_place_count(ulong moved);
+void boot_place_report(void);
+#else
+static inline void boot_place_count(ulong moved) { }
+static inline void boot_place_report(void) { }
+#endif
 int boot_get_cmdline(struct lmb *lmb, ulong *cmd_start, ulong *cmd_end);
 #ifdef CONFIG_SYS_BOOT_GET_KBD
 int boot_get_kbd(struct lmb *lmb, bd_t **kbd);
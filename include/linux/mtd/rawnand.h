@@ -94,6 +94,8 @@ void nand_wait_ready(struct mtd_info *mtd);
 #define NAND_CMD_READSTART	0x30
 #define NAND_CMD_RNDOUTSTART	0xE0
 #define NAND_CMD_CACHEDPROG	0x15
+#define NAND_CMD_READCACHESEQ	0x31
+#define NAND_CMD_READCACHEEND	0x3f
 
 /* Extended commands for AG-AND device */
 /*
@@ -213,6 +215,7 @@ typedef enum {
 #define NAND_HAS_CACHEPROG(chip) ((chip->options & NAND_CACHEPRG))
 #define NAND_HAS_SUBPAGE_READ(chip) ((chip->options & NAND_SUBPAGE_READ))
 #define NAND_HAS_SUBPAGE_WRITE(chip) !((chip)->options & NAND_NO_SUBPAGE_WRITE)
+#define NAND_HAS_CACHE_READ(chip) ((chip)->options & NAND_CACHE_READ)
 
 /* Non chip related options */
 /* This option skips the bbt scan during initialization. */
@@ -236,6 +239,14 @@ typedef enum {
  * kmap'ed, vmalloc'ed highmem buffers being passed from upper layers
  */
 #define NAND_USE_BOUNCE_BUFFER	0x00100000
+/*
+ * Controller driver can issue READ CACHE SEQUENTIAL and READ CACHE END
+ * through cmdfunc, so that the chip reads the next page while the previous
+ * one is transferred. Without dev_ready, chip_delay must cover the cache
+ * busy time as it covers tR. nand_scan_tail() clears this if the chip does
+ * not support cache reads.
+ */
+#define NAND_CACHE_READ		0x00200000
 
 /* Options set by nand scan */
 /* bbt has already been read */
@@ -273,6 +284,9 @@ struct nand_chip;
 /* ONFI subfeature parameters length */
 #define ONFI_SUBFEATURE_PARAM_LEN	4
 
+/* ONFI optional commands READ CACHE supported? */
+#define ONFI_OPT_CMD_READ_CACHE		(1 << 1)
+
 /* ONFI optional commands SET/GET FEATURES supported? */
 #define ONFI_OPT_CMD_SET_GET_FEATURES	(1 << 2)
 
@@ -1184,6 +1198,12 @@ static inline int onfi_get_sync_timing_mode(struct nand_chip *chip)
 		return ONFI_TIMING_MODE_UNKNOWN;
 	return le16_to_cpu(chip->onfi_params.src_sync_timing_mode);
 }
+
+/* return the supported optional commands. */
+static inline int onfi_opt_cmd(struct nand_chip *chip)
+{
+	return chip->onfi_version ? le16_to_cpu(chip->onfi_params.opt_cmd) : 0;
+}
 #else
 static inline int onfi_feature(struct nand_chip *chip)
 {
@@ -1199,6 +1219,11 @@ static inline int onfi_get_sync_timing_mode(struct nand_chip *chip)
 {
 	return ONFI_TIMING_MODE_UNKNOWN;
 }
+
+static inline int onfi_opt_cmd(struct nand_chip *chip)
+{
+	return 0;
+}
 #endif
 
 int onfi_init_data_interface(struct nand_chip *chip,
@@ -14,6 +14,7 @@
 #include <linux/sizes.h>
 #include <linux/compiler.h>
 #include <part.h>
+#include <dm/async.h>
 
 #if CONFIG_IS_ENABLED(MMC_HS200_SUPPORT)
 #define MMC_SUPPORTS_TUNING
@@ -609,11 +610,16 @@ struct mmc {
 	struct blk_desc block_dev;
 #endif
 	char op_cond_pending;	/* 1 if we are waiting on an op_cond command */
+	char sd_op_cond_pending; /* 1 if we are waiting on an SD op_cond */
 	char init_in_progress;	/* 1 if we have done mmc_start_init() */
 	char preinit;		/* start init as early as possible */
 	int ddr_mode;
 #if CONFIG_IS_ENABLED(DM_MMC)
 	struct udevice *dev;	/* Device for this MMC controller */
+#if CONFIG_IS_ENABLED(MMC_ASYNC_INIT)
+	struct dm_async op_cond_poll;	/* waits for the card to power up */
+	ulong op_cond_start;	/* time op_cond_poll was started */
+#endif
 #if CONFIG_IS_ENABLED(DM_REGULATOR)
 	struct udevice *vmmc_supply;	/* Main voltage regulator (Vcc)*/
 	struct udevice *vqmmc_supply;	/* IO voltage regulator (Vccq)*/
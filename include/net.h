@@ -83,6 +83,17 @@ enum eth_state_t {
 	ETH_STATE_ACTIVE
 };
 
+/* Checksums handled by the hardware, see eth_get_csum_offload() */
+enum eth_csum_offload {
+	/*
+	 * The hardware verifies the IP header and UDP checksums of received
+	 * packets and recv_batch() sets ETH_RX_CSUM_OK for those it passed
+	 */
+	ETH_CSUM_RX			= 1 << 0,
+	/* The hardware fills in the IP header checksum of sent packets */
+	ETH_CSUM_TX			= 1 << 1,
+};
+
 #ifdef CONFIG_DM_ETH
 /**
  * struct eth_pdata - Platform data for Ethernet MAC controllers
@@ -91,12 +102,14 @@ enum eth_state_t {
  * @enetaddr: The Ethernet MAC address that is loaded from EEPROM or env
  * @phy_interface: PHY interface to use - see PHY_INTERFACE_MODE_...
  * @max_speed: Maximum speed of Ethernet connection supported by MAC
+ * @csum_offload: Checksums handled by the hardware - see enum eth_csum_offload
  */
 struct eth_pdata {
 	phys_addr_t iobase;
 	unsigned char enetaddr[ARP_HLEN];
 	int phy_interface;
 	int max_speed;
+	int csum_offload;
 };
 
 enum eth_recv_flags {
@@ -107,6 +120,50 @@ enum eth_recv_flags {
 	ETH_RECV_CHECK_DEVICE		= 1 << 0,
 };
 
+enum eth_rx_flags {
+	/* The hardware found the IP header and any UDP checksum correct */
+	ETH_RX_CSUM_OK			= 1 << 0,
+};
+
+/**
+ * struct eth_rx_desc - a received packet handed out by recv_batch()
+ *
+ * @packet: Pointer to the packet data (owned by the driver)
+ * @length: Length of the packet in bytes
+ * @flags: Flags for the packet - see enum eth_rx_flags. Only looked at if
+ *	   the device sets ETH_CSUM_RX in eth_pdata::csum_offload
+ */
+struct eth_rx_desc {
+	uchar *packet;
+	int length;
+	int flags;
+};
+
+/**
+ * struct eth_stats - per-interface traffic counters
+ *
+ * @rx_packets: Packets passed to the network stack
+ * @rx_bytes: Bytes passed to the network stack
+ * @rx_dropped: Received packets which never reached the network stack: those
+ *	       the driver had no buffer for, or returned with a negative length
+ * @rx_errors: Receive attempts which failed with an error
+ * @rx_copies: Packets which the driver copied into net_rx_packets[] rather
+ *	       than lending its own buffer
+ * @tx_packets: Packets sent successfully
+ * @tx_bytes: Bytes sent successfully
+ * @tx_errors: Packets which the driver failed to send
+ */
+struct eth_stats {
+	ulong rx_packets;
+	ulong rx_bytes;
+	ulong rx_dropped;
+	ulong rx_errors;
+	ulong rx_copies;
+	ulong tx_packets;
+	ulong tx_bytes;
+	ulong tx_errors;
+};
+
 /**
  * struct eth_ops - functions of Ethernet MAC controllers
  *
@@ -132,11 +189,25 @@ enum eth_recv_flags {
  *		    ROM on the board. This is how the driver should expose it
  *		    to the network stack. This function should fill in the
  *		    eth_pdata::enetaddr field - optional
+ * recv_batch: Like recv, but return up to "count" received packets at once in
+ *	       the "descs" array. Returns the number of descriptors filled in,
+ *	       0 if the receive FIFO is empty, or an error. A descriptor with a
+ *	       negative length reports a packet which the hardware dropped. If
+ *	       supplied, this is used in preference to recv - optional
+ *
+ * Packet buffers returned by recv and recv_batch are lent to the network
+ * stack, which processes them in place (protocol handlers such as TFTP and
+ * NFS copy the payload straight to its destination). Drivers should hand out
+ * pointers to their DMA buffers rather than copying into net_rx_packets[] and
+ * take the buffers back in free_pkt, which is called once for each packet
+ * after it has been processed.
  */
 struct eth_ops {
 	int (*start)(struct udevice *dev);
 	int (*send)(struct udevice *dev, void *packet, int length);
 	int (*recv)(struct udevice *dev, int flags, uchar **packetp);
+	int (*recv_batch)(struct udevice *dev, int flags,
+			  struct eth_rx_desc *descs, int count);
 	int (*free_pkt)(struct udevice *dev, uchar *packet, int length);
 	void (*stop)(struct udevice *dev);
 #ifdef CONFIG_MCAST_TFTP
@@ -156,6 +227,28 @@ struct udevice *eth_get_dev(void); /* get the current device */
 struct udevice *eth_get_dev_by_name(const char *devname);
 unsigned char *eth_get_ethaddr(void); /* get the current device MAC */
 
+/**
+ * eth_get_stats() - Get the traffic counters of an Ethernet device
+ *
+ * @dev:	Ethernet device to check
+ * @return pointer to the device's counters (NULL if dev is not probed)
+ */
+struct eth_stats *eth_get_stats(struct udevice *dev);
+
+/**
+ * eth_reset_stats() - Clear the traffic counters of an Ethernet device
+ *
+ * @dev:	Ethernet device to clear
+ */
+void eth_reset_stats(struct udevice *dev);
+
+/**
+ * eth_get_csum_offload() - Get the checksums handled by the current device
+ *
+ * @return ETH_CSUM_... flags of the current device (0 if there is none)
+ */
+int eth_get_csum_offload(void);
+
 /* Used only when NetConsole is enabled */
 int eth_is_active(struct udevice *dev); /* Test device for active state */
 int eth_init_state_only(void); /* Set active state */
@@ -203,6 +296,12 @@ static inline unsigned char *eth_get_ethaddr(void)
 	return NULL;
 }
 
+/* Legacy drivers do not offload checksums */
+static inline int eth_get_csum_offload(void)
+{
+	return 0;
+}
+
 /* Used only when NetConsole is enabled */
 int eth_is_active(struct eth_device *dev); /* Test device for active state */
 /* Set active state */
@@ -676,6 +775,17 @@ int net_send_udp_packet(uchar *ether, struct in_addr dest, int dport,
 /* Processes a received packet */
 void net_process_received_packet(uchar *in_packet, int len);
 
+/**
+ * net_process_received_packet_csum() - Process a received packet
+ *
+ * @in_packet:	Packet data, starting with the Ethernet header
+ * @len:	Length of the packet in bytes
+ * @csum_ok:	true if the hardware found the IP header checksum and any
+ *		UDP checksum correct, so they need not be checked again
+ */
+void net_process_received_packet_csum(uchar *in_packet, int len,
+				      bool csum_ok);
+
 #ifdef CONFIG_NETCONSOLE
 void nc_start(void);
 int nc_input_packet(uchar *pkt, struct in_addr src_ip, unsigned dest_port,
@@ -1440,10 +1440,12 @@ struct dm_pci_emul_ops {
 /**
  * sandbox_pci_get_emul() - Get the emulation device for a PCI device
  *
- * Searches for a suitable emulator for the given PCI bus device
+ * Searches for a suitable emulator for the given PCI bus device. This is
+ * the device's "sandbox,emul" phandle if it has one, else its first child.
  *
  * @bus:	PCI bus to search
- * @find_devfn:	PCI device and function address (PCI_DEVFN())
+ * @find_devfn:	PCI bus, device and function address (PCI_BDF()). Devices
+ *		on another bus than @bus are looked up on that bus
  * @emulp:	Returns emulated device if found
  * @return 0 if found, -ENODEV if not found
  */
@@ -29,6 +29,8 @@
 #define SPI_RX_SLOW	BIT(11)			/* receive with 1 wire slow */
 #define SPI_RX_DUAL	BIT(12)			/* receive with 2 wires */
 #define SPI_RX_QUAD	BIT(13)			/* receive with 4 wires */
+#define SPI_TX_OCTAL	BIT(14)			/* transmit with 8 wires */
+#define SPI_RX_OCTAL	BIT(15)			/* receive with 8 wires */
 
 /* Header byte that marks the start of the message */
 #define SPI_PREAMBLE_END_BYTE	0xec
@@ -116,6 +118,36 @@ struct spi_slave {
 #define SPI_XFER_MMAP_END	BIT(3)	/* Memory Mapped End */
 };
 
+/**
+ * struct spi_mem_read_op - A SPI flash read offered to the controller
+ *
+ * Controllers with special support for SPI flash (a DMA engine, a
+ * memory-mapped window or a quad/octal read engine) can perform a whole
+ * flash read in one go rather than having it broken up into spi_xfer()
+ * calls. See the mem_read() method in struct dm_spi_ops.
+ *
+ * @opcode:	Read command to send
+ * @addr:	Flash address to read from
+ * @addr_len:	Number of address bytes to send
+ * @dummy_cycles: Number of dummy clock cycles between address and data
+ * @cmd_width:	Bus width used for the command (1, 2, 4 or 8)
+ * @addr_width:	Bus width used for the address and dummy cycles
+ * @data_width:	Bus width used for the data
+ * @buf:	Buffer to read into (this may not be cache-aligned)
+ * @len:	Number of bytes to read
+ */
+struct spi_mem_read_op {
+	u8 opcode;
+	u32 addr;
+	u8 addr_len;
+	u8 dummy_cycles;
+	u8 cmd_width;
+	u8 addr_width;
+	u8 data_width;
+	void *buf;
+	size_t len;
+};
+
 /**
  * Initialization, must be called once on start up.
  *
@@ -257,6 +289,19 @@ int  spi_xfer(struct spi_slave *slave, unsigned int bitlen, const void *dout,
 /* Copy memory mapped data */
 void spi_flash_copy_mmap(void *data, void *offset, size_t len);
 
+/**
+ * spi_mem_read() - Read from a SPI flash using controller acceleration
+ *
+ * The bus must be claimed before calling this.
+ *
+ * @slave:	The SPI slave (a flash device)
+ * @op:		The read to perform
+ * @return 0 if OK, -ENOSYS if the controller has no such support,
+ *	   -ENOTSUPP if it cannot perform this particular read (in both cases
+ *	   the caller should fall back to spi_xfer()), other -ve on error
+ */
+int spi_mem_read(struct spi_slave *slave, const struct spi_mem_read_op *op);
+
 /**
  * Determine if a SPI chipselect is valid.
  * This function is provided by the board if the low-level SPI driver
@@ -439,6 +484,24 @@ struct dm_spi_ops {
 	 *	   is invalid, other -ve value on error
 	 */
 	int (*cs_info)(struct udevice *bus, uint cs, struct spi_cs_info *info);
+
+	/**
+	 * Read from a SPI flash using controller acceleration - optional
+	 *
+	 * Controllers which can execute a flash read themselves, e.g. by
+	 * DMA into @op->buf, by copying from a memory-mapped window or with
+	 * a dedicated quad/octal read engine, should implement this so that
+	 * SPI flash reads avoid the generic spi_xfer() path. The bus is
+	 * claimed by the caller.
+	 *
+	 * @dev:	The SPI slave (a flash device)
+	 * @op:		The read to perform
+	 * @return 0 if OK, -ENOTSUPP if the controller cannot perform this
+	 *	   particular read (e.g. bus width or length), -ENOSYS if it
+	 *	   cannot perform any reads for this device, other -ve value on
+	 *	   error
+	 */
+	int (*mem_read)(struct udevice *dev, const struct spi_mem_read_op *op);
 };
 
 struct dm_spi_emul_ops {
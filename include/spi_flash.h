@@ -186,10 +186,37 @@ static inline int spi_flash_erase(struct spi_flash *flash, u32 offset,
 struct sandbox_state;
 
 int sandbox_sf_bind_emul(struct sandbox_state *state, int busnum, int cs,
-			 struct udevice *bus, int of_offset, const char *spec);
+			 struct udevice *bus, ofnode node, const char *spec);
 
 void sandbox_sf_unbind_emul(struct sandbox_state *state, int busnum, int cs);
 
+/**
+ * struct sandbox_sf_stats - Operations seen by a sandbox SPI flash emulator
+ *
+ * @erase_4k:	Number of 4KiB sector erases
+ * @erase_64k:	Number of 64KiB block erases
+ * @erase_chip:	Number of chip erases
+ * @program:	Number of page program commands
+ */
+struct sandbox_sf_stats {
+	uint erase_4k;
+	uint erase_64k;
+	uint erase_chip;
+	uint program;
+};
+
+/**
+ * sandbox_sf_get_stats() - Get the operations seen by a flash emulator
+ *
+ * @state:	Sandbox state
+ * @busnum:	SPI bus number of the flash
+ * @cs:		Chip select of the flash
+ * @stats:	Returns the counts since the emulator was probed
+ * @return 0 if OK, -ENODEV if there is no active emulator there
+ */
+int sandbox_sf_get_stats(struct sandbox_state *state, int busnum, int cs,
+			 struct sandbox_sf_stats *stats);
+
 #else
 struct spi_flash *spi_flash_probe(unsigned int bus, unsigned int cs,
 		unsigned int max_hz, unsigned int spi_mode);
@@ -16,6 +16,7 @@
 #include <usb_defs.h>
 #include <linux/usb/ch9.h>
 #include <asm/cache.h>
+#include <linux/list.h>
 #include <part.h>
 
 /*
@@ -664,6 +665,40 @@ struct usb_emul_platdata {
 	int port1;	/* Port number (numbered from 1) */
 };
 
+/**
+ * struct usb_request - a transfer which completes in the background
+ *
+ * A request is queued with usb_submit_request() and its completion is
+ * picked up later with usb_poll_request(), so callers can keep several
+ * transfers in flight and carry on with other work meanwhile. Requests on
+ * the same endpoint complete in the order they were submitted.
+ *
+ * The caller fills in the fields up to @interval and must keep the request
+ * and its buffer around until the request has completed or was cancelled.
+ *
+ * @udev:	USB device to talk to
+ * @pipe:	Bulk or interrupt pipe to use, see create_pipe()
+ * @buffer:	Buffer to send or receive, which should be DMA-aligned
+ * @length:	Buffer length in bytes
+ * @interval:	Interrupt interval, for interrupt pipes
+ * @status:	-EINPROGRESS while the request is in flight, then 0 if OK or
+ *		a -ve error code
+ * @act_len:	Number of bytes transferred, once the request is complete
+ * @node:	Used by the controller to keep track of the request
+ * @hcpriv:	Private data for the controller
+ */
+struct usb_request {
+	struct usb_device *udev;
+	unsigned long pipe;
+	void *buffer;
+	int length;
+	int interval;
+	int status;
+	int act_len;
+	struct list_head node;
+	void *hcpriv;
+};
+
 /**
  * struct dm_usb_ops - USB controller operations
  *
@@ -756,6 +791,44 @@ struct dm_usb_ops {
 	int (*destroy_int_queue)(struct udevice *bus, struct usb_device *udev,
 				 struct int_queue *queue);
 
+	/**
+	 * submit_request() - Queue a transfer without waiting for it
+	 *
+	 * The request stays in flight until poll_request() finds it
+	 * complete, or until it is cancelled. Its status is already set to
+	 * -EINPROGRESS. A controller providing this must also provide
+	 * poll_request() and cancel_request().
+	 *
+	 * @req: request to queue (bulk or interrupt)
+	 *
+	 * @return 0 if queued, -ENOSPC if there is no room for it at
+	 *         present, other -ve on error
+	 */
+	int (*submit_request)(struct udevice *bus, struct usb_request *req);
+
+	/**
+	 * poll_request() - Check whether a request has completed
+	 *
+	 * This must not wait for the transfer. When the request has
+	 * completed, its status and act_len are updated. Other requests may
+	 * be completed at the same time.
+	 *
+	 * @req: request to check
+	 *
+	 * @return 0 if OK (whether or not the request completed), -ve on error
+	 */
+	int (*poll_request)(struct udevice *bus, struct usb_request *req);
+
+	/**
+	 * cancel_request() - Take a request off the controller
+	 *
+	 * @req: request to cancel. If it has completed meanwhile, its status
+	 *       shows the result and is left alone
+	 *
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*cancel_request)(struct udevice *bus, struct usb_request *req);
+
 	/**
 	 * alloc_device() - Allocate a new device context (XHCI)
 	 *
@@ -791,6 +864,53 @@ struct dm_usb_ops {
 #define usb_get_ops(dev)	((struct dm_usb_ops *)(dev)->driver->ops)
 #define usb_get_emul_ops(dev)	((struct dm_usb_ops *)(dev)->driver->ops)
 
+/**
+ * usb_submit_request() - Queue a transfer without waiting for it
+ *
+ * If the controller cannot queue transfers, interrupt requests fall back to
+ * a one-entry interrupt queue (see create_int_queue()) and anything else is
+ * carried out at once, so the request is complete on return. Either way the
+ * result is picked up with usb_poll_request().
+ *
+ * @req:	Request to queue, see struct usb_request
+ * @return 0 if queued, -ENOSPC if the controller has no room for it at
+ * present, other -ve on error
+ */
+int usb_submit_request(struct usb_request *req);
+
+/**
+ * usb_poll_request() - Check whether a request has completed
+ *
+ * This does not wait, so it is cheap enough to call from a tstc() handler.
+ *
+ * @req:	Request to check
+ * @return -EINPROGRESS if still in flight, else the request status (0 if
+ * OK, -ve on error)
+ */
+int usb_poll_request(struct usb_request *req);
+
+/**
+ * usb_wait_request() - Wait for a request to complete
+ *
+ * @req:	Request to wait for
+ * @timeout_ms:	Time to wait in milliseconds. The request is cancelled if
+ *		it does not complete in this time
+ * @return the request status (0 if OK, -ve on error), -ETIMEDOUT on timeout
+ */
+int usb_wait_request(struct usb_request *req, ulong timeout_ms);
+
+/**
+ * usb_cancel_request() - Cancel a request
+ *
+ * Controllers may need to cancel all requests on the endpoint together, in
+ * which case the others also end up with a status of -ECONNRESET.
+ *
+ * @req:	Request to cancel
+ * @return 0 if OK (the request status is -ECONNRESET unless it completed
+ * first), -ve on error
+ */
+int usb_cancel_request(struct usb_request *req);
+
 /**
  * usb_get_dev_index() - look up a device index number
  *
@@ -17,10 +17,23 @@
 
 #include <stdio_dev.h>
 
+/**
+ * struct video_uc_platdata - uclass platform data for a video device
+ *
+ * @align:	Frame-buffer alignment, 0 for the default of 1MB
+ * @size:	Frame-buffer size, in bytes
+ * @base:	Base address of the frame buffer that U-Boot draws into
+ * @copy_base:	Base address of the frame buffer that the hardware displays,
+ *		if it is not @base. With CONFIG_VIDEO_COPY the driver can set
+ *		this in its probe() method, so that @base becomes a cached
+ *		shadow frame buffer which video_sync() copies to @copy_base.
+ *		This is 0 if there is no copy.
+ */
 struct video_uc_platdata {
 	uint align;
 	uint size;
 	ulong base;
+	ulong copy_base;
 };
 
 enum video_polarity {
@@ -60,6 +73,8 @@ enum video_log2_bpp {
  *		select automatically
  * @font_size:	Font size in pixels (0 to use a default value)
  * @fb:		Frame buffer
+ * @copy_fb:	Frame buffer displayed by the hardware, which @fb is copied to
+ *		by video_sync(), or NULL if the hardware displays @fb
  * @fb_size:	Frame buffer size
  * @line_length:	Length of each frame buffer line, in bytes
  * @colour_fg:	Foreground colour (pixel value)
@@ -68,6 +83,8 @@ enum video_log2_bpp {
  *		the LCD is updated
  * @cmap:	Colour map for 8-bit-per-pixel displays
  * @fg_col_idx:	Foreground color code (bit 3 = bold, bit 0-2 = color)
+ * @damage:	Area of @fb changed since the last video_sync(), in pixels.
+ *		Nothing has changed if @damage.xend is 0.
  */
 struct video_priv {
 	/* Things set up by the driver: */
@@ -83,6 +100,7 @@ struct video_priv {
 	 * driver
 	 */
 	void *fb;
+	void *copy_fb;
 	int fb_size;
 	int line_length;
 	u32 colour_fg;
@@ -90,10 +108,54 @@ struct video_priv {
 	bool flush_dcache;
 	ushort *cmap;
 	u8 fg_col_idx;
+	struct {
+		int xstart;
+		int ystart;
+		int xend;
+		int yend;
+	} damage;
 };
 
-/* Placeholder - there are no video operations at present */
+/**
+ * struct video_ops - Video device operations
+ *
+ * These are all optional. They allow a driver with a 2D engine to accelerate
+ * the fills and copies used to clear the display and scroll the console.
+ * They act on the frame buffer at @fb in struct video_priv and must have
+ * completed when they return. They are not used when the uclass keeps a
+ * shadow frame buffer (see @copy_base in struct video_uc_platdata).
+ */
 struct video_ops {
+	/**
+	 * fill_rect() - Fill a rectangle with a colour
+	 *
+	 * @dev:	Video device
+	 * @x:		X position of the top left corner in pixels
+	 * @y:		Y position of the top left corner in pixels
+	 * @width:	Width of the rectangle in pixels
+	 * @height:	Height of the rectangle in pixels
+	 * @colour:	Pixel value to fill with
+	 * @return 0 if OK, -ENOSYS to have the CPU do it, other -ve on error
+	 */
+	int (*fill_rect)(struct udevice *dev, int x, int y, int width,
+			 int height, u32 colour);
+
+	/**
+	 * copy_rect() - Copy a rectangle within the frame buffer
+	 *
+	 * The source and destination may overlap.
+	 *
+	 * @dev:	Video device
+	 * @dst_x:	X position of the destination in pixels
+	 * @dst_y:	Y position of the destination in pixels
+	 * @src_x:	X position of the source in pixels
+	 * @src_y:	Y position of the source in pixels
+	 * @width:	Width of the rectangle in pixels
+	 * @height:	Height of the rectangle in pixels
+	 * @return 0 if OK, -ENOSYS to have the CPU do it, other -ve on error
+	 */
+	int (*copy_rect)(struct udevice *dev, int dst_x, int dst_y, int src_x,
+			 int src_y, int width, int height);
 };
 
 #define video_get_ops(dev)        ((struct video_ops *)(dev)->driver->ops)
@@ -123,12 +185,63 @@ int video_reserve(ulong *addrp);
  */
 void video_clear(struct udevice *dev);
 
+/**
+ * video_damage() - Record that part of a device's frame buffer has changed
+ *
+ * Anything that draws into the frame buffer must call this, so that
+ * video_sync() knows which part of it to flush or copy. The area is clipped
+ * to the display.
+ *
+ * @dev:	Device that was drawn on
+ * @x:		X position of the changed area in pixels from the left
+ * @y:		Y position of the changed area in pixels from the top
+ * @width:	Width of the changed area in pixels
+ * @height:	Height of the changed area in pixels
+ */
+void video_damage(struct udevice *dev, int x, int y, int width, int height);
+
+/**
+ * video_fill_rect() - Fill a rectangle of the frame buffer with a colour
+ *
+ * This uses the driver's fill_rect() operation if it has one, else the CPU.
+ * The rectangle must lie within the display.
+ *
+ * @dev:	Device to draw on
+ * @x:		X position of the top left corner in pixels
+ * @y:		Y position of the top left corner in pixels
+ * @width:	Width of the rectangle in pixels
+ * @height:	Height of the rectangle in pixels
+ * @colour:	Pixel value to fill with
+ * @return 0 if OK, -ve on error
+ */
+int video_fill_rect(struct udevice *dev, int x, int y, int width, int height,
+		    u32 colour);
+
+/**
+ * video_copy_rect() - Copy a rectangle within the frame buffer
+ *
+ * This uses the driver's copy_rect() operation if it has one, else the CPU.
+ * Both rectangles must lie within the display, and they may overlap.
+ *
+ * @dev:	Device to draw on
+ * @dst_x:	X position of the destination in pixels
+ * @dst_y:	Y position of the destination in pixels
+ * @src_x:	X position of the source in pixels
+ * @src_y:	Y position of the source in pixels
+ * @width:	Width of the rectangle in pixels
+ * @height:	Height of the rectangle in pixels
+ * @return 0 if OK, -ve on error
+ */
+int video_copy_rect(struct udevice *dev, int dst_x, int dst_y, int src_x,
+		    int src_y, int width, int height);
+
 /**
  * video_sync() - Sync a device's frame buffer with its hardware
  *
  * Some frame buffers are cached or have a secondary frame buffer. This
  * function syncs these up so that the current contents of the U-Boot frame
- * buffer are displayed to the user.
+ * buffer are displayed to the user. With CONFIG_VIDEO_DAMAGE only the part
+ * recorded by video_damage() since the last sync is flushed or copied.
  *
  * @dev:	Device to sync
  */
@@ -95,6 +95,9 @@
 #define BCH_ECC_WORDS(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 32)
 #define BCH_ECC_BYTES(_p)      DIV_ROUND_UP(GF_M(_p)*GF_T(_p), 8)
 
+/* syndrome tables per odd syndrome: remainders, low and high byte values */
+#define BCH_SYN_TAB_SZ         (3*256)
+
 #ifndef dbg
 #define dbg(_fmt, args...)     do {} while (0)
 #endif
@@ -373,14 +376,21 @@ static inline int a_ilog(struct bch_control *bch, unsigned int x)
 
 /*
  * compute 2t syndromes of ecc polynomial, i.e. ecc(a^j) for j=1..2t
+ *
+ * Rather than adding a^(j*i) for each set bit i of the ecc, v is reduced a
+ * byte at a time modulo a degree m multiple of the minimal polynomial of a^j,
+ * which leaves the value at a^j unchanged; the m-bit remainder is then
+ * evaluated with two more lookups. See build_syn_tables().
  */
 static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
 			      unsigned int *syn)
 {
-	int i, j, s;
-	unsigned int m;
-	uint32_t poly;
+	int i, j, k, s;
+	unsigned int m, r;
+	uint32_t w;
 	const int t = GF_T(bch);
+	const unsigned int n = GF_N(bch);
+	const uint16_t *tab;
 
 	s = bch->ecc_bits;
 
@@ -390,18 +400,22 @@ static void compute_syndromes(struct bch_control *bch, uint32_t *ecc,
 		ecc[s/32] &= ~((1u << (32-m))-1);
 	memset(syn, 0, 2*t*sizeof(*syn));
 
-	/* compute v(a^j) for j=1 .. 2t-1 */
-	do {
-		poly = *ecc++;
-		s -= 32;
-		while (poly) {
-			i = deg(poly);
-			for (j = 0; j < 2*t; j += 2)
-				syn[j] ^= a_pow(bch, (j+1)*(i+s));
-
-			poly ^= (1 << i);
+	/* reduce v modulo the polynomial of each a^j, j=1 .. 2t-1 */
+	for (i = 0; i < (int)BCH_ECC_WORDS(bch); i++) {
+		w = ecc[i];
+		for (k = 24; k >= 0; k -= 8) {
+			tab = bch->syn_tab;
+			for (j = 0; j < 2*t; j += 2, tab += BCH_SYN_TAB_SZ) {
+				r = (syn[j] << 8)|((w >> k) & 0xff);
+				syn[j] = (r & n)^tab[r >> GF_M(bch)];
+			}
 		}
-	} while (s > 0);
+	}
+
+	/* evaluate remainders at a^j */
+	tab = bch->syn_tab;
+	for (j = 0; j < 2*t; j += 2, tab += BCH_SYN_TAB_SZ)
+		syn[j] = tab[256+(syn[j] & 0xff)]^tab[512+(syn[j] >> 8)];
 
 	/* v(a^(2j)) = v(a^j)^2 */
 	for (j = 0; j < t; j++)
@@ -1051,14 +1065,14 @@ int decode_bch(struct bch_control *bch, const uint8_t *data, unsigned int len,
 		if (recv_ecc) {
 			load_ecc8(bch, bch->ecc_buf2, recv_ecc);
 			/* XOR received and calculated ecc */
-			for (i = 0, sum = 0; i < (int)ecc_words; i++) {
+			for (i = 0; i < (int)ecc_words; i++)
 				bch->ecc_buf[i] ^= bch->ecc_buf2[i];
-				sum |= bch->ecc_buf[i];
-			}
-			if (!sum)
-				/* no error found */
-				return 0;
 		}
+		for (i = 0, sum = 0; i < (int)ecc_words; i++)
+			sum |= bch->ecc_buf[i];
+		if (!sum)
+			/* no error found */
+			return 0;
 		compute_syndromes(bch, bch->ecc_buf, bch->syn);
 		syn = bch->syn;
 	}
@@ -1146,6 +1160,75 @@ static void build_mod8_tables(struct bch_control *bch, const uint32_t *g)
 	}
 }
 
+/*
+ * compute the minimal polynomial of a^j over GF(2), i.e. the product of
+ * (X+a^e) for e in the cyclotomic coset {j, 2j, 4j, ...}, times X^(m-d) so that
+ * its degree is m; returned as a bit mask of its coefficients
+ */
+static unsigned int compute_syn_poly(struct bch_control *bch, unsigned int j)
+{
+	const unsigned int m = GF_M(bch);
+	unsigned int i, d = 0, e = j, poly = 0, c[m+1];
+
+	c[0] = 1;
+	do {
+		/* multiply by (X+a^e) */
+		c[d+1] = c[d];
+		for (i = d; i > 0; i--)
+			c[i] = c[i-1]^gf_mul(bch, c[i], bch->a_pow_tab[e]);
+		c[0] = gf_mul(bch, c[0], bch->a_pow_tab[e]);
+		d++;
+		e = mod_s(bch, 2*e);
+	} while (e != j);
+
+	/* coefficients are in GF(2) */
+	for (i = 0; i <= d; i++)
+		poly |= c[i] << i;
+
+	return poly << (m-d);
+}
+
+/*
+ * build tables for computing syndromes a byte at a time, for each odd j:
+ * - tab[x] = x.X^m mod p, where p is the polynomial from compute_syn_poly()
+ * - tab[256+x] and tab[512+x] = value at a^j of the low and high byte of a
+ *   remainder, including the factor a^(-j.pad) which accounts for the unused
+ *   bits at the end of the ecc words
+ */
+static void build_syn_tables(struct bch_control *bch)
+{
+	const unsigned int m = GF_M(bch);
+	const unsigned int t = GF_T(bch);
+	const unsigned int pad = 32*BCH_ECC_WORDS(bch)-bch->ecc_bits;
+	unsigned int i, j, b, p, r, v, w[16];
+	uint16_t *tab = bch->syn_tab;
+
+	for (j = 1; j < 2*t; j += 2, tab += BCH_SYN_TAB_SZ) {
+		p = compute_syn_poly(bch, j);
+		for (i = 0; i < 256; i++) {
+			r = i << m;
+			for (b = m+7; b >= m; b--)
+				if (r & (1u << b))
+					r ^= p << (b-m);
+			tab[i] = r;
+		}
+
+		/* a^(j.b)/a^(j.pad) for each bit b of a remainder */
+		for (b = 0; b < 16; b++)
+			w[b] = a_pow(bch, j*b+GF_N(bch)-modulo(bch, j*pad));
+		for (i = 0; i < 256; i++) {
+			for (b = 0, r = 0, v = 0; b < 8; b++) {
+				if (i & (1u << b)) {
+					r ^= w[b];
+					v ^= w[b+8];
+				}
+			}
+			tab[256+i] = r;
+			tab[512+i] = v;
+		}
+	}
+}
+
 /*
  * build a base for factoring degree 2 polynomials
  */
@@ -1344,6 +1427,8 @@ struct bch_control *init_bch(int m, int t, unsigned int prim_poly)
 	bch->syn       = bch_alloc(2*t*sizeof(*bch->syn), &err);
 	bch->cache     = bch_alloc(2*t*sizeof(*bch->cache), &err);
 	bch->elp       = bch_alloc((t+1)*sizeof(struct gf_poly_deg1), &err);
+	bch->syn_tab   = bch_alloc(t*BCH_SYN_TAB_SZ*sizeof(*bch->syn_tab),
+				   &err);
 
 	for (i = 0; i < ARRAY_SIZE(bch->poly_2t); i++)
 		bch->poly_2t[i] = bch_alloc(GF_POLY_SZ(2*t), &err);
@@ -1363,6 +1448,8 @@ struct bch_control *init_bch(int m, int t, unsigned int prim_poly)
 	build_mod8_tables(bch, genpoly);
 	kfree(genpoly);
 
+	build_syn_tables(bch);
+
 	err = build_deg2_base(bch);
 	if (err)
 		goto fail;
@@ -1392,6 +1479,7 @@ void free_bch(struct bch_control *bch)
 		kfree(bch->syn);
 		kfree(bch->cache);
 		kfree(bch->elp);
+		kfree(bch->syn_tab);
 
 		for (i = 0; i < ARRAY_SIZE(bch->poly_2t); i++)
 			kfree(bch->poly_2t[i]);
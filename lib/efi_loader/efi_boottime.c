@@ -23,6 +23,15 @@ DECLARE_GLOBAL_DATA_PTR;
 /* Task priority level */
 static efi_uintn_t efi_tpl = TPL_APPLICATION;
 
+/*
+ * Events whose notification function could not be called yet due to the
+ * task priority level, sorted by decreasing notification TPL.
+ */
+static LIST_HEAD(efi_event_queue);
+
+/* Longest time to sleep in one go while waiting, in microseconds */
+#define EFI_IDLE_MAX_US	10000
+
 /* This list contains all the EFI objects our payload has access to */
 LIST_HEAD(efi_obj_list);
 
@@ -156,17 +165,48 @@ const char *__efi_nesting_dec(void)
  */
 void efi_signal_event(struct efi_event *event, bool check_tpl)
 {
+	struct efi_event *pos;
+
 	if (event->notify_function) {
-		event->is_queued = true;
 		/* Check TPL */
-		if (check_tpl && efi_tpl >= event->notify_tpl)
+		if (check_tpl && efi_tpl >= event->notify_tpl) {
+			if (event->is_queued)
+				return;
+			/* Queue behind all events of the same or higher TPL */
+			list_for_each_entry(pos, &efi_event_queue, queue_link) {
+				if (pos->notify_tpl < event->notify_tpl)
+					break;
+			}
+			list_add_tail(&event->queue_link, &pos->queue_link);
+			event->is_queued = true;
 			return;
+		}
+		if (event->is_queued)
+			list_del(&event->queue_link);
+		event->is_queued = false;
 		EFI_CALL_VOID(event->notify_function(event,
 						     event->notify_context));
 	}
 	event->is_queued = false;
 }
 
+/*
+ * Call the queued notification functions allowed at the current task
+ * priority level, the ones with the highest TPL first.
+ */
+static void efi_process_event_queue(void)
+{
+	struct efi_event *event;
+
+	while (!list_empty(&efi_event_queue)) {
+		event = list_first_entry(&efi_event_queue, struct efi_event,
+					 queue_link);
+		if (event->notify_tpl <= efi_tpl)
+			break;
+		efi_signal_event(event, true);
+	}
+}
+
 /*
  * Raise the task priority level.
  *
@@ -212,6 +252,9 @@ static void EFIAPI efi_restore_tpl(efi_uintn_t old_tpl)
 	if (efi_tpl > TPL_HIGH_LEVEL)
 		efi_tpl = TPL_HIGH_LEVEL;
 
+	/* Notifications blocked by the previous TPL may run now */
+	efi_process_event_queue();
+
 	EFI_EXIT(EFI_SUCCESS);
 }
 
@@ -475,6 +518,119 @@ void efi_delete_handle(struct efi_object *obj)
  */
 static struct efi_event efi_events[16];
 
+/* Armed timer events, a binary min-heap ordered by trigger_next */
+static struct efi_event *efi_timer_heap[ARRAY_SIZE(efi_events)];
+static int efi_timer_count;
+
+/* timer_index of an expired timer event that is being processed */
+#define EFI_TIMER_EXPIRED	-2
+
+static void efi_timer_heap_set(int i, struct efi_event *event)
+{
+	efi_timer_heap[i] = event;
+	event->timer_index = i;
+}
+
+/*
+ * Restore the heap property after the trigger time of the timer at
+ * position i has changed.
+ *
+ * @i	position in the heap
+ */
+static void efi_timer_heap_fix(int i)
+{
+	struct efi_event *event = efi_timer_heap[i];
+	int child;
+
+	/* Move up */
+	while (i && efi_timer_heap[(i - 1) / 2]->trigger_next >
+		    event->trigger_next) {
+		efi_timer_heap_set(i, efi_timer_heap[(i - 1) / 2]);
+		i = (i - 1) / 2;
+	}
+	/* Move down */
+	for (;;) {
+		child = 2 * i + 1;
+		if (child >= efi_timer_count)
+			break;
+		if (child + 1 < efi_timer_count &&
+		    efi_timer_heap[child + 1]->trigger_next <
+		    efi_timer_heap[child]->trigger_next)
+			child++;
+		if (efi_timer_heap[child]->trigger_next >= event->trigger_next)
+			break;
+		efi_timer_heap_set(i, efi_timer_heap[child]);
+		i = child;
+	}
+	efi_timer_heap_set(i, event);
+}
+
+/*
+ * Add a timer event to the heap of armed timers.
+ *
+ * @event	timer event which is not armed
+ */
+static void efi_timer_arm(struct efi_event *event)
+{
+	efi_timer_heap_set(efi_timer_count++, event);
+	efi_timer_heap_fix(efi_timer_count - 1);
+}
+
+/*
+ * Remove a timer event from the heap of armed timers if it is armed.
+ *
+ * @event	timer event
+ */
+static void efi_timer_disarm(struct efi_event *event)
+{
+	int i = event->timer_index;
+
+	event->timer_index = -1;
+	if (i < 0 || i >= efi_timer_count || efi_timer_heap[i] != event)
+		return;
+	if (i != --efi_timer_count) {
+		efi_timer_heap_set(i, efi_timer_heap[efi_timer_count]);
+		efi_timer_heap_fix(i);
+	}
+}
+
+/*
+ * Wait until the given time or until the next timer event is due,
+ * whichever comes first.
+ *
+ * @until	time to wake up at the latest, see timer_get_us()
+ */
+static void efi_idle(u64 until)
+{
+	u64 now = timer_get_us();
+
+	/* Do not sleep when notifications are waiting to be called */
+	if (!list_empty(&efi_event_queue) &&
+	    list_first_entry(&efi_event_queue, struct efi_event,
+			     queue_link)->notify_tpl > efi_tpl)
+		return;
+	if (efi_timer_count && efi_timer_heap[0]->trigger_next < until)
+		until = efi_timer_heap[0]->trigger_next;
+	if (until > now + EFI_IDLE_MAX_US)
+		until = now + EFI_IDLE_MAX_US;
+	if (until > now)
+		efi_cpu_idle(until - now);
+}
+
+/*
+ * Sleep when the EFI loader has nothing to do.
+ *
+ * With CONFIG_EFI_CPU_IDLE, ARMv8 waits for the events of the generic
+ * timer and 32-bit x86 halts until the i8254 raises an interrupt.
+ * Otherwise this is only a delay.
+ *
+ * @usec	time to sleep in microseconds
+ */
+__weak void efi_cpu_idle(ulong usec)
+{
+	udelay(usec);
+}
+
 /*
  * Create an event.
  *
@@ -517,6 +673,7 @@ efi_status_t efi_create_event(uint32_t type, efi_uintn_t notify_tpl,
 		efi_events[i].notify_context = notify_context;
 		/* Disable timers on bootup */
 		efi_events[i].trigger_next = -1ULL;
+		efi_events[i].timer_index = -1;
 		efi_events[i].is_queued = false;
 		efi_events[i].is_signaled = false;
 		*event = &efi_events[i];
@@ -594,30 +751,39 @@ static efi_status_t EFIAPI efi_create_event_ext(
  */
 void efi_timer_check(void)
 {
-	int i;
+	struct efi_event *expired[ARRAY_SIZE(efi_events)];
+	struct efi_event *event;
+	int i, n = 0;
 	u64 now = timer_get_us();
 
-	for (i = 0; i < ARRAY_SIZE(efi_events); ++i) {
-		if (!efi_events[i].type)
-			continue;
-		if (efi_events[i].is_queued)
-			efi_signal_event(&efi_events[i], true);
-		if (!(efi_events[i].type & EVT_TIMER) ||
-		    now < efi_events[i].trigger_next)
-			continue;
-		switch (efi_events[i].trigger_type) {
-		case EFI_TIMER_RELATIVE:
-			efi_events[i].trigger_type = EFI_TIMER_STOP;
-			break;
-		case EFI_TIMER_PERIODIC:
-			efi_events[i].trigger_next +=
-				efi_events[i].trigger_time;
-			break;
-		default:
+	efi_process_event_queue();
+
+	/*
+	 * Take all due timers off the heap first, so that a periodic timer
+	 * with a period shorter than the time since its last trigger fires
+	 * only once per check.
+	 */
+	while (efi_timer_count && efi_timer_heap[0]->trigger_next <= now) {
+		event = efi_timer_heap[0];
+		efi_timer_disarm(event);
+		event->timer_index = EFI_TIMER_EXPIRED;
+		expired[n++] = event;
+	}
+
+	for (i = 0; i < n; ++i) {
+		event = expired[i];
+		/* A notification function may have closed or reset it */
+		if (event->timer_index != EFI_TIMER_EXPIRED)
 			continue;
+		event->timer_index = -1;
+		if (event->trigger_type == EFI_TIMER_PERIODIC) {
+			event->trigger_next += event->trigger_time;
+			efi_timer_arm(event);
+		} else {
+			event->trigger_type = EFI_TIMER_STOP;
 		}
-		efi_events[i].is_signaled = true;
-		efi_signal_event(&efi_events[i], true);
+		event->is_signaled = true;
+		efi_signal_event(event, true);
 	}
 	WATCHDOG_RESET();
 }
@@ -652,12 +818,15 @@ efi_status_t efi_set_timer(struct efi_event *event, enum efi_timer_delay type,
 			break;
 		switch (type) {
 		case EFI_TIMER_STOP:
+			efi_timer_disarm(event);
 			event->trigger_next = -1ULL;
 			break;
 		case EFI_TIMER_PERIODIC:
 		case EFI_TIMER_RELATIVE:
+			efi_timer_disarm(event);
 			event->trigger_next =
 				timer_get_us() + trigger_time;
+			efi_timer_arm(event);
 			break;
 		default:
 			return EFI_INVALID_PARAMETER;
@@ -735,6 +904,8 @@ known_event:
 			if (event[i]->is_signaled)
 				goto out;
 		}
+		/* Sleep until the next timer is due */
+		efi_idle(timer_get_us() + EFI_IDLE_MAX_US);
 		/* Allow events to occur. */
 		efi_timer_check();
 	}
@@ -799,6 +970,9 @@ static efi_status_t EFIAPI efi_close_event(struct efi_event *event)
 	EFI_ENTRY("%p", event);
 	for (i = 0; i < ARRAY_SIZE(efi_events); ++i) {
 		if (event == &efi_events[i]) {
+			efi_timer_disarm(event);
+			if (event->is_queued)
+				list_del(&event->queue_link);
 			event->type = 0;
 			event->trigger_next = -1ULL;
 			event->is_queued = false;
@@ -1743,7 +1917,8 @@ static efi_status_t EFIAPI efi_exit_boot_services(efi_handle_t image_handle,
 		efi_signal_event(&efi_events[i], false);
 	}
 
-	/* TODO Should persist EFI variables here */
+	/* Persist EFI variables, they are not available anymore */
+	efi_variables_flush();
 
 	board_quiesce_devices();
 
@@ -1804,8 +1979,19 @@ static efi_status_t EFIAPI efi_get_next_monotonic_count(uint64_t *count)
  */
 static efi_status_t EFIAPI efi_stall(unsigned long microseconds)
 {
+	u64 end;
+
 	EFI_ENTRY("%ld", microseconds);
-	udelay(microseconds);
+
+	/* Let timer events fire while stalling */
+	end = timer_get_us() + microseconds;
+	for (;;) {
+		efi_timer_check();
+		if (timer_get_us() >= end)
+			break;
+		efi_idle(end);
+	}
+
 	return EFI_EXIT(EFI_SUCCESS);
 }
 
@@ -13,14 +13,52 @@
 #include <inttypes.h>
 #include <part.h>
 #include <malloc.h>
+#include <memalign.h>
+#include <div64.h>
+#include <linux/log2.h>
 
 const efi_guid_t efi_block_io_guid = BLOCK_IO_GUID;
+const efi_guid_t efi_block_io2_guid = BLOCK_IO2_GUID;
+const efi_guid_t efi_disk_io_guid = DISK_IO_GUID;
+
+/* Size of a line of the disk read cache and of the disk I/O scratch buffer */
+#define EFI_DISK_CACHE_LINE_SIZE	4096
+
+struct efi_disk_cache_line {
+	/* First block of the line */
+	lbaint_t lba;
+	/* Number of blocks held, 0 if the line is unused */
+	lbaint_t blocks;
+	/* Time of the last use, for least recently used replacement */
+	ulong stamp;
+	u8 *data;
+};
+
+/*
+ * Read cache of a block device, shared by the disk object and the objects
+ * of its partitions. Partition and file system probing does many small
+ * reads of the same few blocks, these are served from memory.
+ */
+struct efi_disk_cache {
+	struct list_head link;
+	struct blk_desc *desc;
+	/* Blocks per line */
+	lbaint_t line_blocks;
+	ulong clock;
+	struct efi_disk_cache_line lines[CONFIG_EFI_DISK_CACHE_LINES];
+};
+
+static LIST_HEAD(efi_disk_caches);
 
 struct efi_disk_obj {
 	/* Generic EFI object parent class data */
 	struct efi_object parent;
 	/* EFI Interface callback struct for block I/O */
 	struct efi_block_io ops;
+	/* EFI Interface callback struct for block I/O 2 */
+	struct efi_block_io2 ops2;
+	/* EFI Interface callback struct for disk I/O */
+	struct efi_disk_io disk_io;
 	/* U-Boot ifname for block device */
 	const char *ifname;
 	/* U-Boot dev_index for block device */
@@ -37,8 +75,180 @@ struct efi_disk_obj {
 	lbaint_t offset;
 	/* Internal block device */
 	struct blk_desc *desc;
+	/* Scratch buffer for partial and unaligned disk I/O */
+	u8 *scratch;
 };
 
+/*
+ * Find the read cache of a block device.
+ *
+ * @desc	block device
+ * @return	cache or NULL if nothing has been read through it yet
+ */
+static struct efi_disk_cache *efi_disk_cache_find(struct blk_desc *desc)
+{
+	struct efi_disk_cache *cache;
+
+	list_for_each_entry(cache, &efi_disk_caches, link) {
+		if (cache->desc == desc)
+			return cache;
+	}
+
+	return NULL;
+}
+
+/*
+ * Get the read cache of a block device, creating it on first use.
+ *
+ * The cache is only allocated on the first read through it, so that block
+ * devices which EFI applications never read cost no memory.
+ *
+ * @desc	block device
+ * @return	cache or NULL if the cache is disabled or out of memory
+ */
+static struct efi_disk_cache *efi_disk_cache_get(struct blk_desc *desc)
+{
+	struct efi_disk_cache *cache;
+	u8 *data;
+	int i;
+
+	if (!CONFIG_EFI_DISK_CACHE_LINES ||
+	    desc->blksz > EFI_DISK_CACHE_LINE_SIZE ||
+	    !is_power_of_2(desc->blksz))
+		return NULL;
+
+	cache = efi_disk_cache_find(desc);
+	if (cache)
+		return cache;
+
+	cache = calloc(1, sizeof(*cache));
+	data = malloc_cache_aligned(CONFIG_EFI_DISK_CACHE_LINES *
+				    EFI_DISK_CACHE_LINE_SIZE);
+	if (!cache || !data) {
+		free(cache);
+		free(data);
+		return NULL;
+	}
+	cache->desc = desc;
+	cache->line_blocks = EFI_DISK_CACHE_LINE_SIZE / desc->blksz;
+	for (i = 0; i < CONFIG_EFI_DISK_CACHE_LINES; i++)
+		cache->lines[i].data = data + i * EFI_DISK_CACHE_LINE_SIZE;
+	list_add(&cache->link, &efi_disk_caches);
+
+	return cache;
+}
+
+/*
+ * Drop the cached blocks in a range of a block device.
+ *
+ * @cache	read cache
+ * @lba		first block on the device
+ * @blocks	number of blocks
+ */
+static void efi_disk_cache_drop(struct efi_disk_cache *cache, lbaint_t lba,
+				lbaint_t blocks)
+{
+	struct efi_disk_cache_line *line;
+	int i;
+
+	for (i = 0; i < CONFIG_EFI_DISK_CACHE_LINES; i++) {
+		line = &cache->lines[i];
+		if (line->blocks && line->lba < lba + blocks &&
+		    lba < line->lba + line->blocks) {
+			line->blocks = 0;
+			line->stamp = 0;
+		}
+	}
+}
+
+/*
+ * Drop all cached blocks of a block device.
+ *
+ * This must be called when a block device is written without going through
+ * the EFI disk objects, e.g. by the U-Boot file system layer.
+ *
+ * @desc	block device, NULL for all block devices
+ */
+void efi_disk_invalidate_cache(struct blk_desc *desc)
+{
+	struct efi_disk_cache *cache;
+
+	list_for_each_entry(cache, &efi_disk_caches, link) {
+		if (!desc || cache->desc == desc)
+			efi_disk_cache_drop(cache, 0, cache->desc->lba);
+	}
+}
+
+/*
+ * Find the cache line starting at a block, reading it on a miss.
+ *
+ * @cache	read cache
+ * @lba		first block of the line, aligned to the line size
+ * @return	cache line or NULL on a read error
+ */
+static struct efi_disk_cache_line *
+efi_disk_cache_line(struct efi_disk_cache *cache, lbaint_t lba)
+{
+	struct efi_disk_cache_line *line, *victim = &cache->lines[0];
+	lbaint_t blocks;
+	int i;
+
+	for (i = 0; i < CONFIG_EFI_DISK_CACHE_LINES; i++) {
+		line = &cache->lines[i];
+		if (line->blocks && line->lba == lba) {
+			line->stamp = ++cache->clock;
+			return line;
+		}
+		/* Unused lines have a stamp of 0 and are taken first */
+		if (line->stamp < victim->stamp)
+			victim = line;
+	}
+
+	/* Do not read past the end of the device */
+	blocks = min(cache->line_blocks, cache->desc->lba - lba);
+	victim->blocks = 0;
+	victim->stamp = 0;
+	if (blk_dread(cache->desc, lba, blocks, victim->data) != blocks)
+		return NULL;
+	victim->lba = lba;
+	victim->blocks = blocks;
+	victim->stamp = ++cache->clock;
+
+	return victim;
+}
+
+/*
+ * Read blocks through the read cache.
+ *
+ * @cache	read cache
+ * @lba		first block on the device
+ * @blocks	number of blocks
+ * @buffer	buffer to read into
+ * @return	number of blocks read, less than @blocks on a read error
+ */
+static ulong efi_disk_cache_read(struct efi_disk_cache *cache, lbaint_t lba,
+				 lbaint_t blocks, u8 *buffer)
+{
+	struct efi_disk_cache_line *line;
+	ulong blksz = cache->desc->blksz;
+	lbaint_t start, skip, n, done = 0;
+
+	while (done < blocks) {
+		start = lba & ~(cache->line_blocks - 1);
+		skip = lba - start;
+		line = efi_disk_cache_line(cache, start);
+		if (!line || line->blocks <= skip)
+			break;
+		n = min(blocks - done, line->blocks - skip);
+		memcpy(buffer, line->data + skip * blksz, n * blksz);
+		buffer += n * blksz;
+		lba += n;
+		done += n;
+	}
+
+	return done;
+}
+
 static efi_status_t EFIAPI efi_disk_reset(struct efi_block_io *this,
 			char extended_verification)
 {
@@ -51,17 +261,16 @@ enum efi_disk_direction {
 	EFI_DISK_WRITE,
 };
 
-static efi_status_t efi_disk_rw_blocks(struct efi_block_io *this,
-			u32 media_id, u64 lba, unsigned long buffer_size,
+static efi_status_t efi_disk_rw_blocks(struct efi_disk_obj *diskobj,
+			u64 lba, unsigned long buffer_size,
 			void *buffer, enum efi_disk_direction direction)
 {
-	struct efi_disk_obj *diskobj;
+	struct efi_disk_cache *cache;
 	struct blk_desc *desc;
 	int blksz;
 	int blocks;
 	unsigned long n;
 
-	diskobj = container_of(this, struct efi_disk_obj, ops);
 	desc = (struct blk_desc *) diskobj->desc;
 	blksz = desc->blksz;
 	blocks = buffer_size / blksz;
@@ -74,10 +283,21 @@ static efi_status_t efi_disk_rw_blocks(struct efi_block_io *this,
 	if (buffer_size & (blksz - 1))
 		return EFI_DEVICE_ERROR;
 
-	if (direction == EFI_DISK_READ)
-		n = blk_dread(desc, lba, blocks, buffer);
-	else
+	if (direction == EFI_DISK_READ) {
+		/* Small reads are served from the cache */
+		cache = NULL;
+		if (buffer_size <= EFI_DISK_CACHE_LINE_SIZE)
+			cache = efi_disk_cache_get(desc);
+		if (cache)
+			n = efi_disk_cache_read(cache, lba, blocks, buffer);
+		else
+			n = blk_dread(desc, lba, blocks, buffer);
+	} else {
 		n = blk_dwrite(desc, lba, blocks, buffer);
+		cache = efi_disk_cache_find(desc);
+		if (cache)
+			efi_disk_cache_drop(cache, lba, blocks);
+	}
 
 	/* We don't do interrupts, so check for timers cooperatively */
 	efi_timer_check();
@@ -90,72 +310,83 @@ static efi_status_t efi_disk_rw_blocks(struct efi_block_io *this,
 	return EFI_SUCCESS;
 }
 
-static efi_status_t EFIAPI efi_disk_read_blocks(struct efi_block_io *this,
-			u32 media_id, u64 lba, efi_uintn_t buffer_size,
-			void *buffer)
+/*
+ * Read or write whole blocks, counted from the start of the partition.
+ *
+ * @diskobj	disk object
+ * @lba		first block
+ * @buffer_size	number of bytes, a multiple of the block size
+ * @buffer	buffer to read into or write from
+ * @direction	read or write
+ * @return	status code
+ */
+static efi_status_t efi_disk_transfer(struct efi_disk_obj *diskobj, u64 lba,
+				      efi_uintn_t buffer_size, void *buffer,
+				      enum efi_disk_direction direction)
 {
 	void *real_buffer = buffer;
 	efi_status_t r;
 
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 	if (buffer_size > EFI_LOADER_BOUNCE_BUFFER_SIZE) {
-		r = efi_disk_read_blocks(this, media_id, lba,
-			EFI_LOADER_BOUNCE_BUFFER_SIZE, buffer);
+		r = efi_disk_transfer(diskobj, lba,
+			EFI_LOADER_BOUNCE_BUFFER_SIZE, buffer, direction);
 		if (r != EFI_SUCCESS)
 			return r;
-		return efi_disk_read_blocks(this, media_id, lba +
-			EFI_LOADER_BOUNCE_BUFFER_SIZE / this->media->block_size,
+		return efi_disk_transfer(diskobj, lba +
+			EFI_LOADER_BOUNCE_BUFFER_SIZE / diskobj->media.block_size,
 			buffer_size - EFI_LOADER_BOUNCE_BUFFER_SIZE,
-			buffer + EFI_LOADER_BOUNCE_BUFFER_SIZE);
+			buffer + EFI_LOADER_BOUNCE_BUFFER_SIZE, direction);
 	}
 
 	real_buffer = efi_bounce_buffer;
 #endif
 
-	EFI_ENTRY("%p, %x, %" PRIx64 ", %zx, %p", this, media_id, lba,
-		  buffer_size, buffer);
+	/* Populate bounce buffer if necessary */
+	if (direction == EFI_DISK_WRITE && real_buffer != buffer)
+		memcpy(real_buffer, buffer, buffer_size);
 
-	r = efi_disk_rw_blocks(this, media_id, lba, buffer_size, real_buffer,
-			       EFI_DISK_READ);
+	r = efi_disk_rw_blocks(diskobj, lba, buffer_size, real_buffer,
+			       direction);
 
 	/* Copy from bounce buffer to real buffer if necessary */
-	if ((r == EFI_SUCCESS) && (real_buffer != buffer))
+	if (direction == EFI_DISK_READ && r == EFI_SUCCESS &&
+	    real_buffer != buffer)
 		memcpy(buffer, real_buffer, buffer_size);
 
-	return EFI_EXIT(r);
+	return r;
 }
 
-static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
+static efi_status_t EFIAPI efi_disk_read_blocks(struct efi_block_io *this,
 			u32 media_id, u64 lba, efi_uintn_t buffer_size,
 			void *buffer)
 {
-	void *real_buffer = buffer;
+	struct efi_disk_obj *diskobj;
 	efi_status_t r;
 
-#ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
-	if (buffer_size > EFI_LOADER_BOUNCE_BUFFER_SIZE) {
-		r = efi_disk_write_blocks(this, media_id, lba,
-			EFI_LOADER_BOUNCE_BUFFER_SIZE, buffer);
-		if (r != EFI_SUCCESS)
-			return r;
-		return efi_disk_write_blocks(this, media_id, lba +
-			EFI_LOADER_BOUNCE_BUFFER_SIZE / this->media->block_size,
-			buffer_size - EFI_LOADER_BOUNCE_BUFFER_SIZE,
-			buffer + EFI_LOADER_BOUNCE_BUFFER_SIZE);
-	}
+	EFI_ENTRY("%p, %x, %" PRIx64 ", %zx, %p", this, media_id, lba,
+		  buffer_size, buffer);
 
-	real_buffer = efi_bounce_buffer;
-#endif
+	diskobj = container_of(this, struct efi_disk_obj, ops);
+	r = efi_disk_transfer(diskobj, lba, buffer_size, buffer,
+			      EFI_DISK_READ);
+
+	return EFI_EXIT(r);
+}
+
+static efi_status_t EFIAPI efi_disk_write_blocks(struct efi_block_io *this,
+			u32 media_id, u64 lba, efi_uintn_t buffer_size,
+			void *buffer)
+{
+	struct efi_disk_obj *diskobj;
+	efi_status_t r;
 
 	EFI_ENTRY("%p, %x, %" PRIx64 ", %zx, %p", this, media_id, lba,
 		  buffer_size, buffer);
 
-	/* Populate bounce buffer if necessary */
-	if (real_buffer != buffer)
-		memcpy(real_buffer, buffer, buffer_size);
-
-	r = efi_disk_rw_blocks(this, media_id, lba, buffer_size, real_buffer,
-			       EFI_DISK_WRITE);
+	diskobj = container_of(this, struct efi_disk_obj, ops);
+	r = efi_disk_transfer(diskobj, lba, buffer_size, buffer,
+			      EFI_DISK_WRITE);
 
 	return EFI_EXIT(r);
 }
@@ -174,6 +405,209 @@ static const struct efi_block_io block_io_disk_template = {
 	.flush_blocks = &efi_disk_flush_blocks,
 };
 
+/*
+ * Report the completion of a block I/O 2 request.
+ *
+ * All transfers are synchronous. If the caller passed an event, the
+ * transfer is reported as completed through the token and the event is
+ * signaled before returning.
+ *
+ * @token	token passed by the caller, may be NULL
+ * @r		status of the transfer
+ * @return	status code to return to the caller
+ */
+static efi_status_t efi_disk_complete(struct efi_block_io2_token *token,
+				      efi_status_t r)
+{
+	if (!token || !token->event)
+		return r;
+
+	token->transaction_status = r;
+	token->event->is_signaled = true;
+	if (token->event->type & EVT_NOTIFY_SIGNAL)
+		efi_signal_event(token->event, true);
+
+	return EFI_SUCCESS;
+}
+
+static efi_status_t EFIAPI efi_disk_reset_ex(struct efi_block_io2 *this,
+			bool extended_verification)
+{
+	EFI_ENTRY("%p, %x", this, extended_verification);
+	return EFI_EXIT(EFI_DEVICE_ERROR);
+}
+
+static efi_status_t EFIAPI efi_disk_read_blocks_ex(struct efi_block_io2 *this,
+			u32 media_id, u64 lba,
+			struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer)
+{
+	struct efi_disk_obj *diskobj;
+	efi_status_t r;
+
+	EFI_ENTRY("%p, %x, %" PRIx64 ", %p, %zx, %p", this, media_id, lba,
+		  token, buffer_size, buffer);
+
+	diskobj = container_of(this, struct efi_disk_obj, ops2);
+	r = efi_disk_transfer(diskobj, lba, buffer_size, buffer,
+			      EFI_DISK_READ);
+
+	return EFI_EXIT(efi_disk_complete(token, r));
+}
+
+static efi_status_t EFIAPI efi_disk_write_blocks_ex(struct efi_block_io2 *this,
+			u32 media_id, u64 lba,
+			struct efi_block_io2_token *token,
+			efi_uintn_t buffer_size, void *buffer)
+{
+	struct efi_disk_obj *diskobj;
+	efi_status_t r;
+
+	EFI_ENTRY("%p, %x, %" PRIx64 ", %p, %zx, %p", this, media_id, lba,
+		  token, buffer_size, buffer);
+
+	diskobj = container_of(this, struct efi_disk_obj, ops2);
+	r = efi_disk_transfer(diskobj, lba, buffer_size, buffer,
+			      EFI_DISK_WRITE);
+
+	return EFI_EXIT(efi_disk_complete(token, r));
+}
+
+static efi_status_t EFIAPI efi_disk_flush_blocks_ex(struct efi_block_io2 *this,
+			struct efi_block_io2_token *token)
+{
+	/* We always write synchronously */
+	EFI_ENTRY("%p, %p", this, token);
+	return EFI_EXIT(efi_disk_complete(token, EFI_SUCCESS));
+}
+
+static const struct efi_block_io2 block_io2_disk_template = {
+	.reset = &efi_disk_reset_ex,
+	.read_blocks_ex = &efi_disk_read_blocks_ex,
+	.write_blocks_ex = &efi_disk_write_blocks_ex,
+	.flush_blocks_ex = &efi_disk_flush_blocks_ex,
+};
+
+/*
+ * Read or write bytes at any offset from the start of the partition.
+ *
+ * Partial blocks and buffers unsuitable for DMA go through the scratch
+ * buffer, whole blocks are transferred directly.
+ *
+ * @diskobj	disk object
+ * @offset	offset in bytes
+ * @buffer_size	number of bytes
+ * @buffer	buffer to read into or write from
+ * @direction	read or write
+ * @return	status code
+ */
+static efi_status_t efi_disk_io_rw(struct efi_disk_obj *diskobj, u64 offset,
+				   efi_uintn_t buffer_size, u8 *buffer,
+				   enum efi_disk_direction direction)
+{
+	efi_uintn_t blksz = diskobj->media.block_size;
+	efi_uintn_t scratch_size = max(blksz,
+				       (efi_uintn_t)EFI_DISK_CACHE_LINE_SIZE);
+	efi_uintn_t n, skip;
+	efi_status_t r;
+	u64 lba = offset;
+
+	skip = do_div(lba, blksz);
+
+	if (!diskobj->scratch) {
+		diskobj->scratch = malloc_cache_aligned(scratch_size);
+		if (!diskobj->scratch)
+			return EFI_OUT_OF_RESOURCES;
+	}
+
+	while (buffer_size) {
+		if (skip || buffer_size < blksz) {
+			/* Partial block: read, modify, write */
+			n = min(buffer_size, blksz - skip);
+			r = efi_disk_transfer(diskobj, lba, blksz,
+					      diskobj->scratch, EFI_DISK_READ);
+			if (r != EFI_SUCCESS)
+				return r;
+			if (direction == EFI_DISK_READ) {
+				memcpy(buffer, diskobj->scratch + skip, n);
+			} else {
+				memcpy(diskobj->scratch + skip, buffer, n);
+				r = efi_disk_transfer(diskobj, lba, blksz,
+						      diskobj->scratch,
+						      EFI_DISK_WRITE);
+				if (r != EFI_SUCCESS)
+					return r;
+			}
+			skip = 0;
+			lba++;
+		} else if ((uintptr_t)buffer & (ARCH_DMA_MINALIGN - 1)) {
+			/* Whole blocks, but the buffer is misaligned */
+			n = min(buffer_size, scratch_size);
+			n -= n % blksz;
+			if (direction == EFI_DISK_WRITE)
+				memcpy(diskobj->scratch, buffer, n);
+			r = efi_disk_transfer(diskobj, lba, n,
+					      diskobj->scratch, direction);
+			if (r != EFI_SUCCESS)
+				return r;
+			if (direction == EFI_DISK_READ)
+				memcpy(buffer, diskobj->scratch, n);
+			lba += n / blksz;
+		} else {
+			n = buffer_size - buffer_size % blksz;
+			r = efi_disk_transfer(diskobj, lba, n, buffer,
+					      direction);
+			if (r != EFI_SUCCESS)
+				return r;
+			lba += n / blksz;
+		}
+		buffer += n;
+		buffer_size -= n;
+	}
+
+	return EFI_SUCCESS;
+}
+
+static efi_status_t EFIAPI efi_disk_read_disk(struct efi_disk_io *this,
+			u32 media_id, u64 offset, efi_uintn_t buffer_size,
+			void *buffer)
+{
+	struct efi_disk_obj *diskobj;
+	efi_status_t r;
+
+	EFI_ENTRY("%p, %x, %" PRIx64 ", %zx, %p", this, media_id, offset,
+		  buffer_size, buffer);
+
+	diskobj = container_of(this, struct efi_disk_obj, disk_io);
+	r = efi_disk_io_rw(diskobj, offset, buffer_size, buffer,
+			   EFI_DISK_READ);
+
+	return EFI_EXIT(r);
+}
+
+static efi_status_t EFIAPI efi_disk_write_disk(struct efi_disk_io *this,
+			u32 media_id, u64 offset, efi_uintn_t buffer_size,
+			void *buffer)
+{
+	struct efi_disk_obj *diskobj;
+	efi_status_t r;
+
+	EFI_ENTRY("%p, %x, %" PRIx64 ", %zx, %p", this, media_id, offset,
+		  buffer_size, buffer);
+
+	diskobj = container_of(this, struct efi_disk_obj, disk_io);
+	r = efi_disk_io_rw(diskobj, offset, buffer_size, buffer,
+			   EFI_DISK_WRITE);
+
+	return EFI_EXIT(r);
+}
+
+static const struct efi_disk_io disk_io_template = {
+	.revision = EFI_DISK_IO_PROTOCOL_REVISION,
+	.read_disk = &efi_disk_read_disk,
+	.write_disk = &efi_disk_write_disk,
+};
+
 /*
  * Get the simple file system protocol for a file device path.
  *
@@ -264,6 +698,14 @@ static efi_status_t efi_disk_add_dev(
 			       &diskobj->ops);
 	if (ret != EFI_SUCCESS)
 		return ret;
+	ret = efi_add_protocol(diskobj->parent.handle, &efi_block_io2_guid,
+			       &diskobj->ops2);
+	if (ret != EFI_SUCCESS)
+		return ret;
+	ret = efi_add_protocol(diskobj->parent.handle, &efi_disk_io_guid,
+			       &diskobj->disk_io);
+	if (ret != EFI_SUCCESS)
+		return ret;
 	ret = efi_add_protocol(diskobj->parent.handle, &efi_guid_device_path,
 			       diskobj->dp);
 	if (ret != EFI_SUCCESS)
@@ -278,6 +720,8 @@ static efi_status_t efi_disk_add_dev(
 			return ret;
 	}
 	diskobj->ops = block_io_disk_template;
+	diskobj->ops2 = block_io2_disk_template;
+	diskobj->disk_io = disk_io_template;
 	diskobj->ifname = if_typename;
 	diskobj->dev_index = dev_index;
 	diskobj->offset = offset;
@@ -292,6 +736,7 @@ static efi_status_t efi_disk_add_dev(
 	if (part != 0)
 		diskobj->media.logical_partition = 1;
 	diskobj->ops.media = &diskobj->media;
+	diskobj->ops2.media = &diskobj->media;
 	if (disk)
 		*disk = diskobj;
 	return EFI_SUCCESS;
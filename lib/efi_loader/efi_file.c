@@ -30,6 +30,9 @@ struct file_handle {
 	struct fs_dir_stream *dirs;
 	struct fs_dirent *dent;
 
+	/* for reading a file, opened on first read: */
+	struct fs_file *file;
+
 	char path[0];
 };
 #define to_fh(x) container_of(x, struct file_handle, base)
@@ -207,6 +210,7 @@ static efi_status_t EFIAPI efi_file_open(struct efi_file_handle *file,
 static efi_status_t file_close(struct file_handle *fh)
 {
 	fs_closedir(fh->dirs);
+	fs_closefile(fh->file);
 	free(fh);
 	return EFI_SUCCESS;
 }
@@ -231,8 +235,20 @@ static efi_status_t file_read(struct file_handle *fh, u64 *buffer_size,
 {
 	loff_t actread;
 
-	if (fs_read(fh->path, (ulong)buffer, fh->offset,
-		    *buffer_size, &actread))
+	/*
+	 * Keep the file open across reads, so that loading a file in
+	 * chunks does not look up the path and walk the file from its
+	 * start on every call.
+	 */
+	if (!fh->file) {
+		if (set_blk_dev(fh))
+			return EFI_DEVICE_ERROR;
+		fh->file = fs_openfile(fh->path);
+		if (!fh->file)
+			return EFI_DEVICE_ERROR;
+	}
+
+	if (fs_pread(fh->file, buffer, fh->offset, *buffer_size, &actread))
 		return EFI_DEVICE_ERROR;
 
 	*buffer_size = actread;
@@ -321,15 +337,15 @@ static efi_status_t EFIAPI efi_file_read(struct efi_file_handle *file,
 
 	EFI_ENTRY("%p, %p, %p", file, buffer_size, buffer);
 
-	if (set_blk_dev(fh)) {
-		ret = EFI_DEVICE_ERROR;
-		goto error;
-	}
-
-	if (fh->isdir)
+	if (fh->isdir) {
+		if (set_blk_dev(fh)) {
+			ret = EFI_DEVICE_ERROR;
+			goto error;
+		}
 		ret = dir_read(fh, buffer_size, buffer);
-	else
+	} else {
 		ret = file_read(fh, buffer_size, buffer);
+	}
 
 error:
 	return EFI_EXIT(ret);
@@ -344,16 +360,21 @@ static efi_status_t EFIAPI efi_file_write(struct efi_file_handle *file,
 
 	EFI_ENTRY("%p, %p, %p", file, buffer_size, buffer);
 
+	/* The open file would not see the new size or clusters */
+	fs_closefile(fh->file);
+	fh->file = NULL;
+
 	if (set_blk_dev(fh)) {
 		ret = EFI_DEVICE_ERROR;
 		goto error;
 	}
 
-	if (fs_write(fh->path, (ulong)buffer, fh->offset, *buffer_size,
-		     &actwrite)) {
-		ret = EFI_DEVICE_ERROR;
+	ret = fs_write(fh->path, (ulong)buffer, fh->offset, *buffer_size,
+		       &actwrite) ? EFI_DEVICE_ERROR : EFI_SUCCESS;
+	/* The blocks were written behind the back of the disk objects */
+	efi_disk_invalidate_cache(fh->fs->desc);
+	if (ret != EFI_SUCCESS)
 		goto error;
-	}
 
 	*buffer_size = actwrite;
 	fh->offset += actwrite;
@@ -388,7 +409,9 @@ static efi_status_t EFIAPI efi_file_setpos(struct efi_file_handle *file,
 		fh->dirs = NULL;
 	}
 
-	if (pos == ~0ULL) {
+	if (pos == ~0ULL && fh->file) {
+		pos = fh->file->size;
+	} else if (pos == ~0ULL) {
 		loff_t file_size;
 
 		if (set_blk_dev(fh)) {
@@ -29,6 +29,9 @@ struct efi_gop_obj {
 	/* Fields we only have acces to during init */
 	u32 bpix;
 	void *fb;
+#ifdef CONFIG_DM_VIDEO
+	struct udevice *vdev;
+#endif
 };
 
 static efi_status_t EFIAPI gop_query_mode(struct efi_gop *this, u32 mode_number,
@@ -117,7 +120,8 @@ efi_status_t EFIAPI gop_blt(struct efi_gop *this, void *buffer,
 	}
 
 #ifdef CONFIG_DM_VIDEO
-	video_sync_all();
+	video_damage(gopobj->vdev, dx, dy, width, height);
+	video_sync(gopobj->vdev);
 #else
 	lcd_sync();
 #endif
@@ -145,7 +149,8 @@ int efi_gop_register(void)
 	bpix = priv->bpix;
 	col = video_get_xsize(vdev);
 	row = video_get_ysize(vdev);
-	fb_base = (uintptr_t)priv->fb;
+	/* The OS must draw straight into the frame buffer that is displayed */
+	fb_base = (uintptr_t)(priv->copy_fb ? priv->copy_fb : priv->fb);
 	fb_size = priv->fb_size;
 	fb = priv->fb;
 #else
@@ -216,6 +221,9 @@ int efi_gop_register(void)
 
 	gopobj->bpix = bpix;
 	gopobj->fb = fb;
+#ifdef CONFIG_DM_VIDEO
+	gopobj->vdev = vdev;
+#endif
 
 	return 0;
 }
@@ -11,360 +11,205 @@
 #include <malloc.h>
 #include <asm/global_data.h>
 #include <linux/libfdt_env.h>
-#include <linux/list_sort.h>
 #include <inttypes.h>
 #include <watchdog.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
-struct efi_mem_list {
-	struct list_head link;
-	struct efi_mem_desc desc;
-};
-
-#define EFI_CARVE_NO_OVERLAP		-1
-#define EFI_CARVE_LOOP_AGAIN		-2
-#define EFI_CARVE_OVERLAPS_NONRAM	-3
-
-/* This list contains all memory map items */
-LIST_HEAD(efi_mem);
-
 #ifdef CONFIG_EFI_LOADER_BOUNCE_BUFFER
 void *efi_bounce_buffer;
 #endif
 
 /*
- * U-Boot services each EFI AllocatePool request as a separate
- * (multiple) page allocation.  We have to track the number of pages
- * to be able to free the correct amount later.
+ * EFI AllocatePool requests are carved from pool arenas: runs of
+ * EFI_POOL_ARENA_PAGES pages of a single memory type, split into equally
+ * sized chunks. Small allocations thus cost bytes instead of pages and do
+ * not each add an entry to the memory map. Requests too large for the
+ * biggest size class are still serviced as separate page allocations.
+ *
  * EFI requires 8 byte alignment for pool allocations, so we can
- * prepend each allocation with an 64 bit header tracking the
- * allocation size, and hand out the remainder to the caller.
+ * prepend each allocation with a header recording where it came from,
+ * and hand out the remainder to the caller. num_pages is the size of a
+ * page allocation, or 0 for an arena chunk. arena is NULL for page
+ * allocations and for free chunks.
+ *
+ * Arena chunks are only 8 byte aligned, so that small allocations stay
+ * small. Page allocations put the header just below the first DMA
+ * aligned address of the pages, EFI_POOL_PAGE_OFFSET.
  */
 struct efi_pool_allocation {
 	u64 num_pages;
-	char data[] __aligned(ARCH_DMA_MINALIGN);
+	struct efi_pool_arena *arena;
+	char data[] __aligned(sizeof(u64));
 };
 
+#define EFI_POOL_PAGE_OFFSET	ALIGN(sizeof(struct efi_pool_allocation), \
+				      ARCH_DMA_MINALIGN)
+
 /*
- * Sorts the memory list from highest address to lowest address
- *
- * When allocating memory we should always start from the highest
- * address chunk, so sort the memory list such that the first list
- * iterator gets the highest address and goes lower from there.
+ * Header at the start of each pool arena. Free chunks are kept on a
+ * singly linked list threaded through their data area.
  */
-static int efi_mem_cmp(void *priv, struct list_head *a, struct list_head *b)
-{
-	struct efi_mem_list *mema = list_entry(a, struct efi_mem_list, link);
-	struct efi_mem_list *memb = list_entry(b, struct efi_mem_list, link);
-
-	if (mema->desc.physical_start == memb->desc.physical_start)
-		return 0;
-	else if (mema->desc.physical_start < memb->desc.physical_start)
-		return 1;
-	else
-		return -1;
-}
+struct efi_pool_arena {
+	struct list_head link;
+	int memory_type;
+	int class;
+	unsigned int chunk_size;
+	unsigned int used;
+	unsigned int total;
+	struct efi_pool_allocation *free;
+};
 
-static void efi_mem_sort(void)
-{
-	list_sort(NULL, &efi_mem, efi_mem_cmp);
-}
+#define EFI_POOL_ARENA_PAGES	4
+#define EFI_POOL_MIN_SHIFT	4	/* 16 bytes */
+#define EFI_POOL_MAX_SHIFT	11	/* 2 KiB */
+#define EFI_POOL_CLASSES	(EFI_POOL_MAX_SHIFT - EFI_POOL_MIN_SHIFT + 1)
 
 /*
- * Unmaps all memory occupied by the carve_desc region from the
- * list entry pointed to by map.
- *
- * Returns EFI_CARVE_NO_OVERLAP if the regions don't overlap.
- * Returns EFI_CARVE_OVERLAPS_NONRAM if the carve and map overlap,
- *    and the map contains anything but free ram.
- *    (only when overlap_only_ram is true)
- * Returns EFI_CARVE_LOOP_AGAIN if the mapping list should be traversed
- *    again, as it has been altered
- * Returns the number of overlapping pages. The pages are removed from
- *     the mapping list.
- *
- * In case of EFI_CARVE_OVERLAPS_NONRAM it is the callers responsibility
- * to readd the already carved out pages to the mapping.
+ * Arenas of each size class. Arenas with free chunks are kept in front
+ * of full ones, so allocation usually succeeds on the first match.
  */
-static int efi_mem_carve_out(struct efi_mem_list *map,
-			     struct efi_mem_desc *carve_desc,
-			     bool overlap_only_ram)
+static struct list_head efi_pool_arenas[EFI_POOL_CLASSES];
+
+void *efi_alloc(uint64_t len, int memory_type)
 {
-	struct efi_mem_list *newmap;
-	struct efi_mem_desc *map_desc = &map->desc;
-	uint64_t map_start = map_desc->physical_start;
-	uint64_t map_end = map_start + (map_desc->num_pages << EFI_PAGE_SHIFT);
-	uint64_t carve_start = carve_desc->physical_start;
-	uint64_t carve_end = carve_start +
-			     (carve_desc->num_pages << EFI_PAGE_SHIFT);
-
-	/* check whether we're overlapping */
-	if ((carve_end <= map_start) || (carve_start >= map_end))
-		return EFI_CARVE_NO_OVERLAP;
-
-	/* We're overlapping with non-RAM, warn the caller if desired */
-	if (overlap_only_ram && (map_desc->type != EFI_CONVENTIONAL_MEMORY))
-		return EFI_CARVE_OVERLAPS_NONRAM;
-
-	/* Sanitize carve_start and carve_end to lie within our bounds */
-	carve_start = max(carve_start, map_start);
-	carve_end = min(carve_end, map_end);
-
-	/* Carving at the beginning of our map? Just move it! */
-	if (carve_start == map_start) {
-		if (map_end == carve_end) {
-			/* Full overlap, just remove map */
-			list_del(&map->link);
-			free(map);
-		} else {
-			map->desc.physical_start = carve_end;
-			map->desc.num_pages = (map_end - carve_end)
-					      >> EFI_PAGE_SHIFT;
-		}
+	uint64_t ret = 0;
+	uint64_t pages = (len + EFI_PAGE_MASK) >> EFI_PAGE_SHIFT;
+	efi_status_t r;
 
-		return (carve_end - carve_start) >> EFI_PAGE_SHIFT;
-	}
+	r = efi_allocate_pages(0, memory_type, pages, &ret);
+	if (r == EFI_SUCCESS)
+		return (void*)(uintptr_t)ret;
 
-	/*
-	 * Overlapping maps, just split the list map at carve_start,
-	 * it will get moved or removed in the next iteration.
-	 *
-	 * [ map_desc |__carve_start__| newmap ]
-	 */
-
-	/* Create a new map from [ carve_start ... map_end ] */
-	newmap = calloc(1, sizeof(*newmap));
-	newmap->desc = map->desc;
-	newmap->desc.physical_start = carve_start;
-	newmap->desc.num_pages = (map_end - carve_start) >> EFI_PAGE_SHIFT;
-	/* Insert before current entry (descending address order) */
-	list_add_tail(&newmap->link, &map->link);
-
-	/* Shrink the map to [ map_start ... carve_start ] */
-	map_desc->num_pages = (carve_start - map_start) >> EFI_PAGE_SHIFT;
-
-	return EFI_CARVE_LOOP_AGAIN;
+	return NULL;
 }
 
-uint64_t efi_add_memory_map(uint64_t start, uint64_t pages, int memory_type,
-			    bool overlap_only_ram)
+/*
+ * Get the pool size class serving an allocation.
+ *
+ * @size	number of bytes requested
+ * @return	size class, or -1 if the request is too large for any class
+ */
+static int efi_pool_class(efi_uintn_t size)
 {
-	struct list_head *lhandle;
-	struct efi_mem_list *newlist;
-	bool carve_again;
-	uint64_t carved_pages = 0;
-
-	debug("%s: 0x%" PRIx64 " 0x%" PRIx64 " %d %s\n", __func__,
-	      start, pages, memory_type, overlap_only_ram ? "yes" : "no");
-
-	if (!pages)
-		return start;
-
-	newlist = calloc(1, sizeof(*newlist));
-	newlist->desc.type = memory_type;
-	newlist->desc.physical_start = start;
-	newlist->desc.virtual_start = start;
-	newlist->desc.num_pages = pages;
-
-	switch (memory_type) {
-	case EFI_RUNTIME_SERVICES_CODE:
-	case EFI_RUNTIME_SERVICES_DATA:
-		newlist->desc.attribute = (1 << EFI_MEMORY_WB_SHIFT) |
-					  (1ULL << EFI_MEMORY_RUNTIME_SHIFT);
-		break;
-	case EFI_MMAP_IO:
-		newlist->desc.attribute = 1ULL << EFI_MEMORY_RUNTIME_SHIFT;
-		break;
-	default:
-		newlist->desc.attribute = 1 << EFI_MEMORY_WB_SHIFT;
-		break;
-	}
+	int class;
 
-	/* Add our new map */
-	do {
-		carve_again = false;
-		list_for_each(lhandle, &efi_mem) {
-			struct efi_mem_list *lmem;
-			int r;
-
-			lmem = list_entry(lhandle, struct efi_mem_list, link);
-			r = efi_mem_carve_out(lmem, &newlist->desc,
-					      overlap_only_ram);
-			switch (r) {
-			case EFI_CARVE_OVERLAPS_NONRAM:
-				/*
-				 * The user requested to only have RAM overlaps,
-				 * but we hit a non-RAM region. Error out.
-				 */
-				return 0;
-			case EFI_CARVE_NO_OVERLAP:
-				/* Just ignore this list entry */
-				break;
-			case EFI_CARVE_LOOP_AGAIN:
-				/*
-				 * We split an entry, but need to loop through
-				 * the list again to actually carve it.
-				 */
-				carve_again = true;
-				break;
-			default:
-				/* We carved a number of pages */
-				carved_pages += r;
-				carve_again = true;
-				break;
-			}
-
-			if (carve_again) {
-				/* The list changed, we need to start over */
-				break;
-			}
-		}
-	} while (carve_again);
-
-	if (overlap_only_ram && (carved_pages != pages)) {
-		/*
-		 * The payload wanted to have RAM overlaps, but we overlapped
-		 * with an unallocated region. Error out.
-		 */
-		return 0;
+	for (class = 0; class < EFI_POOL_CLASSES; class++) {
+		if (size <= (1UL << (EFI_POOL_MIN_SHIFT + class)))
+			return class;
 	}
 
-	/* Add our new map */
-        list_add_tail(&newlist->link, &efi_mem);
-
-	/* And make sure memory is listed in descending order */
-	efi_mem_sort();
-
-	return start;
+	return -1;
 }
 
-static uint64_t efi_find_free_memory(uint64_t len, uint64_t max_addr)
+/*
+ * Set up a new pool arena and add it to the front of its class list.
+ *
+ * @class	size class of the arena
+ * @memory_type	memory type the chunks are allocated as
+ * @return	new arena, or NULL if out of memory
+ */
+static struct efi_pool_arena *efi_pool_new_arena(int class, int memory_type)
 {
-	struct list_head *lhandle;
-
-	list_for_each(lhandle, &efi_mem) {
-		struct efi_mem_list *lmem = list_entry(lhandle,
-			struct efi_mem_list, link);
-		struct efi_mem_desc *desc = &lmem->desc;
-		uint64_t desc_len = desc->num_pages << EFI_PAGE_SHIFT;
-		uint64_t desc_end = desc->physical_start + desc_len;
-		uint64_t curmax = min(max_addr, desc_end);
-		uint64_t ret = curmax - len;
-
-		/* We only take memory from free RAM */
-		if (desc->type != EFI_CONVENTIONAL_MEMORY)
-			continue;
-
-		/* Out of bounds for max_addr */
-		if ((ret + len) > max_addr)
-			continue;
-
-		/* Out of bounds for upper map limit */
-		if ((ret + len) > desc_end)
-			continue;
-
-		/* Out of bounds for lower map limit */
-		if (ret < desc->physical_start)
-			continue;
-
-		/* Return the highest address in this map within bounds */
-		return ret;
+	struct efi_pool_arena *arena;
+	struct efi_pool_allocation *chunk;
+	efi_physical_addr_t t;
+	ulong start, end;
+
+	if (efi_allocate_pages(0, memory_type, EFI_POOL_ARENA_PAGES, &t) !=
+	    EFI_SUCCESS)
+		return NULL;
+
+	arena = (void *)(uintptr_t)t;
+	arena->memory_type = memory_type;
+	arena->class = class;
+	arena->chunk_size = sizeof(struct efi_pool_allocation) +
+			    ALIGN(1UL << (EFI_POOL_MIN_SHIFT + class),
+				  sizeof(u64));
+	arena->used = 0;
+	arena->total = 0;
+	arena->free = NULL;
+
+	/* Thread all chunks on the free list */
+	start = ALIGN((ulong)(arena + 1), sizeof(u64));
+	end = (ulong)arena + (EFI_POOL_ARENA_PAGES << EFI_PAGE_SHIFT);
+	for (; start + arena->chunk_size <= end; start += arena->chunk_size) {
+		chunk = (void *)start;
+		chunk->num_pages = 0;
+		chunk->arena = NULL;
+		*(struct efi_pool_allocation **)chunk->data = arena->free;
+		arena->free = chunk;
+		arena->total++;
 	}
 
-	return 0;
+	list_add(&arena->link, &efi_pool_arenas[class]);
+
+	return arena;
 }
 
 /*
- * Allocate memory pages.
+ * Allocate a chunk from the pool arenas.
  *
- * @type		type of allocation to be performed
- * @memory_type		usage type of the allocated memory
- * @pages		number of pages to be allocated
- * @memory		allocated memory
- * @return		status code
+ * @class	size class of the allocation
+ * @memory_type	memory type of the allocation
+ * @return	allocated chunk, or NULL if out of memory
  */
-efi_status_t efi_allocate_pages(int type, int memory_type,
-				efi_uintn_t pages, uint64_t *memory)
+static struct efi_pool_allocation *efi_pool_get_chunk(int class,
+						       int memory_type)
 {
-	u64 len = pages << EFI_PAGE_SHIFT;
-	efi_status_t r = EFI_SUCCESS;
-	uint64_t addr;
-
-	switch (type) {
-	case 0:
-		/* Any page */
-		addr = efi_find_free_memory(len, gd->start_addr_sp);
-		if (!addr) {
-			r = EFI_NOT_FOUND;
+	struct list_head *head = &efi_pool_arenas[class];
+	struct efi_pool_arena *arena, *found = NULL;
+	struct efi_pool_allocation *chunk;
+
+	list_for_each_entry(arena, head, link) {
+		if (!arena->free)
 			break;
-		}
-		break;
-	case 1:
-		/* Max address */
-		addr = efi_find_free_memory(len, *memory);
-		if (!addr) {
-			r = EFI_NOT_FOUND;
+		if (arena->memory_type == memory_type) {
+			found = arena;
 			break;
 		}
-		break;
-	case 2:
-		/* Exact address, reserve it. The addr is already in *memory. */
-		addr = *memory;
-		break;
-	default:
-		/* UEFI doesn't specify other allocation types */
-		r = EFI_INVALID_PARAMETER;
-		break;
 	}
+	if (!found)
+		found = efi_pool_new_arena(class, memory_type);
+	if (!found)
+		return NULL;
 
-	if (r == EFI_SUCCESS) {
-		uint64_t ret;
-
-		/* Reserve that map in our memory maps */
-		ret = efi_add_memory_map(addr, pages, memory_type, true);
-		if (ret == addr) {
-			*memory = addr;
-		} else {
-			/* Map would overlap, bail out */
-			r = EFI_OUT_OF_RESOURCES;
-		}
-	}
+	chunk = found->free;
+	found->free = *(struct efi_pool_allocation **)chunk->data;
+	chunk->arena = found;
+	found->used++;
 
-	return r;
-}
-
-void *efi_alloc(uint64_t len, int memory_type)
-{
-	uint64_t ret = 0;
-	uint64_t pages = (len + EFI_PAGE_MASK) >> EFI_PAGE_SHIFT;
-	efi_status_t r;
-
-	r = efi_allocate_pages(0, memory_type, pages, &ret);
-	if (r == EFI_SUCCESS)
-		return (void*)(uintptr_t)ret;
+	/* Keep full arenas out of the way of the next allocation */
+	if (!found->free)
+		list_move_tail(&found->link, head);
 
-	return NULL;
+	return chunk;
 }
 
 /*
- * Free memory pages.
+ * Return a chunk to its pool arena. Arenas that become empty are handed
+ * back to the page allocator so the memory map does not keep them.
  *
- * @memory	start of the memory area to be freed
- * @pages	number of pages to be freed
+ * @chunk	chunk to be freed
  * @return	status code
  */
-efi_status_t efi_free_pages(uint64_t memory, efi_uintn_t pages)
+static efi_status_t efi_pool_put_chunk(struct efi_pool_allocation *chunk)
 {
-	uint64_t r = 0;
+	struct efi_pool_arena *arena = chunk->arena;
 
-	r = efi_add_memory_map(memory, pages, EFI_CONVENTIONAL_MEMORY, false);
-	/* Merging of adjacent free regions is missing */
+	chunk->arena = NULL;
+	*(struct efi_pool_allocation **)chunk->data = arena->free;
+	arena->free = chunk;
 
-	if (r == memory)
-		return EFI_SUCCESS;
+	if (!--arena->used) {
+		list_del(&arena->link);
+		return efi_free_pages((uintptr_t)arena, EFI_POOL_ARENA_PAGES);
+	}
+
+	/* The arena has a free chunk again, move it in front */
+	list_move(&arena->link, &efi_pool_arenas[arena->class]);
 
-	return EFI_NOT_FOUND;
+	return EFI_SUCCESS;
 }
 
 /*
@@ -379,19 +224,37 @@ efi_status_t efi_allocate_pool(int pool_type, efi_uintn_t size, void **buffer)
 {
 	efi_status_t r;
 	efi_physical_addr_t t;
-	u64 num_pages = (size + sizeof(struct efi_pool_allocation) +
-			 EFI_PAGE_MASK) >> EFI_PAGE_SHIFT;
+	struct efi_pool_allocation *alloc;
+	int class;
+	u64 num_pages;
+
+	/* Reject the reserved memory types before touching any arena */
+	if (!efi_memory_type_valid(pool_type))
+		return EFI_INVALID_PARAMETER;
 
 	if (size == 0) {
 		*buffer = NULL;
 		return EFI_SUCCESS;
 	}
 
+	class = efi_pool_class(size);
+	if (class >= 0) {
+		alloc = efi_pool_get_chunk(class, pool_type);
+		if (!alloc)
+			return EFI_OUT_OF_RESOURCES;
+		*buffer = alloc->data;
+		return EFI_SUCCESS;
+	}
+
+	num_pages = (size + EFI_POOL_PAGE_OFFSET + EFI_PAGE_MASK) >>
+		    EFI_PAGE_SHIFT;
 	r = efi_allocate_pages(0, pool_type, num_pages, &t);
 
 	if (r == EFI_SUCCESS) {
-		struct efi_pool_allocation *alloc = (void *)(uintptr_t)t;
+		alloc = (void *)(uintptr_t)(t + EFI_POOL_PAGE_OFFSET -
+					    sizeof(*alloc));
 		alloc->num_pages = num_pages;
+		alloc->arena = NULL;
 		*buffer = alloc->data;
 	}
 
@@ -413,70 +276,22 @@ efi_status_t efi_free_pool(void *buffer)
 		return EFI_INVALID_PARAMETER;
 
 	alloc = container_of(buffer, struct efi_pool_allocation, data);
+	if (!alloc->num_pages) {
+		/* Sanity check, the chunk must not have been freed before */
+		if (!alloc->arena)
+			return EFI_INVALID_PARAMETER;
+		return efi_pool_put_chunk(alloc);
+	}
+
 	/* Sanity check, was the supplied address returned by allocate_pool */
-	assert(((uintptr_t)alloc & EFI_PAGE_MASK) == 0);
+	assert(((uintptr_t)buffer & EFI_PAGE_MASK) == EFI_POOL_PAGE_OFFSET);
 
-	r = efi_free_pages((uintptr_t)alloc, alloc->num_pages);
+	r = efi_free_pages((uintptr_t)buffer - EFI_POOL_PAGE_OFFSET,
+			   alloc->num_pages);
 
 	return r;
 }
 
-/*
- * Get map describing memory usage.
- *
- * @memory_map_size	on entry the size, in bytes, of the memory map buffer,
- *			on exit the size of the copied memory map
- * @memory_map		buffer to which the memory map is written
- * @map_key		key for the memory map
- * @descriptor_size	size of an individual memory descriptor
- * @descriptor_version	version number of the memory descriptor structure
- * @return		status code
- */
-efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
-				struct efi_mem_desc *memory_map,
-				efi_uintn_t *map_key,
-				efi_uintn_t *descriptor_size,
-				uint32_t *descriptor_version)
-{
-	efi_uintn_t map_size = 0;
-	int map_entries = 0;
-	struct list_head *lhandle;
-	efi_uintn_t provided_map_size = *memory_map_size;
-
-	list_for_each(lhandle, &efi_mem)
-		map_entries++;
-
-	map_size = map_entries * sizeof(struct efi_mem_desc);
-
-	*memory_map_size = map_size;
-
-	if (provided_map_size < map_size)
-		return EFI_BUFFER_TOO_SMALL;
-
-	if (descriptor_size)
-		*descriptor_size = sizeof(struct efi_mem_desc);
-
-	if (descriptor_version)
-		*descriptor_version = EFI_MEMORY_DESCRIPTOR_VERSION;
-
-	/* Copy list into array */
-	if (memory_map) {
-		/* Return the list in ascending order */
-		memory_map = &memory_map[map_entries - 1];
-		list_for_each(lhandle, &efi_mem) {
-			struct efi_mem_list *lmem;
-
-			lmem = list_entry(lhandle, struct efi_mem_list, link);
-			*memory_map = lmem->desc;
-			memory_map--;
-		}
-	}
-
-	*map_key = 0;
-
-	return EFI_SUCCESS;
-}
-
 __weak void efi_add_known_memory(void)
 {
 	int i;
@@ -498,6 +313,10 @@ int efi_memory_init(void)
 	unsigned long runtime_start, runtime_end, runtime_pages;
 	unsigned long uboot_start, uboot_pages;
 	unsigned long uboot_stack_size = 16 * 1024 * 1024;
+	int i;
+
+	for (i = 0; i < EFI_POOL_CLASSES; i++)
+		INIT_LIST_HEAD(&efi_pool_arenas[i]);
 
 	efi_add_known_memory();
 
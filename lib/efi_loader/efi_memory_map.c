@@ -0,0 +1,472 @@
+/*
+ *  EFI memory map
+ *
+ *  Copyright (c) 2016 Alexander Graf
+ *
+ *  SPDX-License-Identifier:     GPL-2.0+
+ */
+
+#include <common.h>
+#include <efi_loader.h>
+#include <malloc.h>
+#include <asm/global_data.h>
+#include <linux/rbtree_augmented.h>
+#include <inttypes.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/*
+ * The memory map is kept in a red-black tree sorted by physical address.
+ * Regions never overlap, and adjacent regions with identical type and
+ * attributes are merged. Each node also tracks the largest free region
+ * in its subtree, so that free memory can be found without walking the
+ * whole map.
+ */
+struct efi_mem_node {
+	struct rb_node rb;
+	struct efi_mem_desc desc;
+	u64 max_free;
+};
+
+/* This tree contains all memory map items */
+static struct rb_root efi_mem = RB_ROOT;
+static int efi_mem_count;
+
+static u64 efi_mem_end(const struct efi_mem_desc *desc)
+{
+	return desc->physical_start + (desc->num_pages << EFI_PAGE_SHIFT);
+}
+
+static u64 efi_mem_free_pages(const struct efi_mem_node *node)
+{
+	if (node->desc.type != EFI_CONVENTIONAL_MEMORY)
+		return 0;
+	return node->desc.num_pages;
+}
+
+static u64 efi_mem_compute_max_free(struct efi_mem_node *node)
+{
+	u64 ret = efi_mem_free_pages(node);
+	struct efi_mem_node *child;
+
+	if (node->rb.rb_left) {
+		child = rb_entry(node->rb.rb_left, struct efi_mem_node, rb);
+		ret = max(ret, child->max_free);
+	}
+	if (node->rb.rb_right) {
+		child = rb_entry(node->rb.rb_right, struct efi_mem_node, rb);
+		ret = max(ret, child->max_free);
+	}
+
+	return ret;
+}
+
+RB_DECLARE_CALLBACKS(static, efi_mem_augment, struct efi_mem_node, rb,
+		     u64, max_free, efi_mem_compute_max_free)
+
+/*
+ * Update the free space bookkeeping after a node was resized in place.
+ */
+static void efi_mem_update(struct efi_mem_node *node)
+{
+	efi_mem_augment_propagate(&node->rb, NULL);
+}
+
+static void efi_mem_insert(struct efi_mem_node *new)
+{
+	struct rb_node **link = &efi_mem.rb_node, *parent = NULL;
+	u64 start = new->desc.physical_start;
+	struct efi_mem_node *node;
+
+	new->max_free = efi_mem_free_pages(new);
+	while (*link) {
+		parent = *link;
+		node = rb_entry(parent, struct efi_mem_node, rb);
+		if (node->max_free < new->max_free)
+			node->max_free = new->max_free;
+		if (start < node->desc.physical_start)
+			link = &parent->rb_left;
+		else
+			link = &parent->rb_right;
+	}
+
+	rb_link_node(&new->rb, parent, link);
+	rb_insert_augmented(&new->rb, &efi_mem, &efi_mem_augment);
+	efi_mem_count++;
+}
+
+static void efi_mem_remove(struct efi_mem_node *node)
+{
+	rb_erase_augmented(&node->rb, &efi_mem, &efi_mem_augment);
+	free(node);
+	efi_mem_count--;
+}
+
+static struct efi_mem_node *efi_mem_next(struct efi_mem_node *node)
+{
+	struct rb_node *rb = rb_next(&node->rb);
+
+	return rb ? rb_entry(rb, struct efi_mem_node, rb) : NULL;
+}
+
+static struct efi_mem_node *efi_mem_prev(struct efi_mem_node *node)
+{
+	struct rb_node *rb = rb_prev(&node->rb);
+
+	return rb ? rb_entry(rb, struct efi_mem_node, rb) : NULL;
+}
+
+/*
+ * Find the lowest region ending above addr, i.e. the first region which
+ * contains addr or lies above it.
+ */
+static struct efi_mem_node *efi_mem_lookup(u64 addr)
+{
+	struct rb_node *rb = efi_mem.rb_node;
+	struct efi_mem_node *node, *found = NULL;
+
+	while (rb) {
+		node = rb_entry(rb, struct efi_mem_node, rb);
+		if (efi_mem_end(&node->desc) > addr) {
+			found = node;
+			rb = rb->rb_left;
+		} else {
+			rb = rb->rb_right;
+		}
+	}
+
+	return found;
+}
+
+/*
+ * Checks whether [start, end) is completely covered by free RAM.
+ */
+static bool efi_mem_is_free_ram(u64 start, u64 end)
+{
+	struct efi_mem_node *node;
+	u64 addr = start;
+
+	for (node = efi_mem_lookup(start);
+	     node && node->desc.physical_start < end;
+	     node = efi_mem_next(node)) {
+		if (node->desc.type != EFI_CONVENTIONAL_MEMORY)
+			return false;
+		if (node->desc.physical_start > addr)
+			return false;
+		addr = efi_mem_end(&node->desc);
+	}
+
+	return addr >= end;
+}
+
+/*
+ * Unmaps all memory in [start, end) from the map, splitting and
+ * shrinking regions that only partially overlap.
+ */
+static int efi_mem_carve_out(u64 start, u64 end)
+{
+	struct efi_mem_node *node, *next, *tail;
+	u64 node_start, node_end;
+
+	for (node = efi_mem_lookup(start);
+	     node && node->desc.physical_start < end; node = next) {
+		next = efi_mem_next(node);
+		node_start = node->desc.physical_start;
+		node_end = efi_mem_end(&node->desc);
+
+		if (node_start >= start && node_end <= end) {
+			/* Full overlap, just remove the region */
+			efi_mem_remove(node);
+			continue;
+		}
+
+		if (node_start >= start) {
+			/* Carving at the beginning of the region, move it */
+			node->desc.physical_start = end;
+			node->desc.virtual_start += end - node_start;
+			node->desc.num_pages = (node_end - end) >> EFI_PAGE_SHIFT;
+			efi_mem_update(node);
+			continue;
+		}
+
+		/* Keep [ node_start ... start ] */
+		node->desc.num_pages = (start - node_start) >> EFI_PAGE_SHIFT;
+		efi_mem_update(node);
+
+		if (node_end > end) {
+			/* Carving in the middle, add [ end ... node_end ] */
+			tail = calloc(1, sizeof(*tail));
+			if (!tail)
+				return -ENOMEM;
+			tail->desc = node->desc;
+			tail->desc.physical_start = end;
+			tail->desc.virtual_start += end - node_start;
+			tail->desc.num_pages = (node_end - end) >> EFI_PAGE_SHIFT;
+			efi_mem_insert(tail);
+		}
+	}
+
+	return 0;
+}
+
+static bool efi_mem_can_merge(const struct efi_mem_desc *lo,
+			      const struct efi_mem_desc *hi)
+{
+	u64 len = lo->num_pages << EFI_PAGE_SHIFT;
+
+	return lo->type == hi->type && lo->attribute == hi->attribute &&
+	       lo->physical_start + len == hi->physical_start &&
+	       lo->virtual_start + len == hi->virtual_start;
+}
+
+/*
+ * Merges a region with its neighbours if they are of the same kind, so
+ * that the map stays short however many allocations are made.
+ */
+static void efi_mem_coalesce(struct efi_mem_node *node)
+{
+	struct efi_mem_node *other;
+
+	other = efi_mem_prev(node);
+	if (other && efi_mem_can_merge(&other->desc, &node->desc)) {
+		other->desc.num_pages += node->desc.num_pages;
+		efi_mem_remove(node);
+		efi_mem_update(other);
+		node = other;
+	}
+
+	other = efi_mem_next(node);
+	if (other && efi_mem_can_merge(&node->desc, &other->desc)) {
+		node->desc.num_pages += other->desc.num_pages;
+		efi_mem_remove(other);
+		efi_mem_update(node);
+	}
+}
+
+uint64_t efi_add_memory_map(uint64_t start, uint64_t pages, int memory_type,
+			    bool overlap_only_ram)
+{
+	struct efi_mem_node *newmap;
+	uint64_t end = start + (pages << EFI_PAGE_SHIFT);
+
+	debug("%s: 0x%" PRIx64 " 0x%" PRIx64 " %d %s\n", __func__,
+	      start, pages, memory_type, overlap_only_ram ? "yes" : "no");
+
+	if (!pages)
+		return start;
+
+	/*
+	 * The user requested to only have RAM overlaps, but the range
+	 * covers a non-RAM or unallocated region. Error out.
+	 */
+	if (overlap_only_ram && !efi_mem_is_free_ram(start, end))
+		return 0;
+
+	newmap = calloc(1, sizeof(*newmap));
+	if (!newmap)
+		return 0;
+	newmap->desc.type = memory_type;
+	newmap->desc.physical_start = start;
+	newmap->desc.virtual_start = start;
+	newmap->desc.num_pages = pages;
+
+	switch (memory_type) {
+	case EFI_RUNTIME_SERVICES_CODE:
+	case EFI_RUNTIME_SERVICES_DATA:
+		newmap->desc.attribute = (1 << EFI_MEMORY_WB_SHIFT) |
+					 (1ULL << EFI_MEMORY_RUNTIME_SHIFT);
+		break;
+	case EFI_MMAP_IO:
+		newmap->desc.attribute = 1ULL << EFI_MEMORY_RUNTIME_SHIFT;
+		break;
+	default:
+		newmap->desc.attribute = 1 << EFI_MEMORY_WB_SHIFT;
+		break;
+	}
+
+	if (efi_mem_carve_out(start, end)) {
+		free(newmap);
+		return 0;
+	}
+
+	/* Add our new map */
+	efi_mem_insert(newmap);
+	efi_mem_coalesce(newmap);
+
+	return start;
+}
+
+/*
+ * Finds the highest free region below max_addr that fits len bytes in
+ * the subtree at rb. Subtrees without a large enough free region are
+ * skipped using the max_free bookkeeping.
+ */
+static uint64_t efi_mem_find_free(struct rb_node *rb, uint64_t len,
+				  uint64_t max_addr)
+{
+	struct efi_mem_node *node;
+	struct efi_mem_desc *desc;
+	uint64_t curmax, ret;
+
+	if (!rb)
+		return 0;
+	node = rb_entry(rb, struct efi_mem_node, rb);
+	if ((node->max_free << EFI_PAGE_SHIFT) < len)
+		return 0;
+	desc = &node->desc;
+
+	/* Higher addresses first */
+	if (desc->physical_start < max_addr) {
+		ret = efi_mem_find_free(rb->rb_right, len, max_addr);
+		if (ret)
+			return ret;
+
+		/* We only take memory from free RAM */
+		if (desc->type == EFI_CONVENTIONAL_MEMORY) {
+			curmax = min(max_addr, efi_mem_end(desc));
+			ret = curmax - len;
+
+			/* Return the highest address within bounds */
+			if (curmax >= len && ret >= desc->physical_start)
+				return ret;
+		}
+	}
+
+	return efi_mem_find_free(rb->rb_left, len, max_addr);
+}
+
+static uint64_t efi_find_free_memory(uint64_t len, uint64_t max_addr)
+{
+	return efi_mem_find_free(efi_mem.rb_node, len, max_addr);
+}
+
+/*
+ * Allocate memory pages.
+ *
+ * @type		type of allocation to be performed
+ * @memory_type		usage type of the allocated memory
+ * @pages		number of pages to be allocated
+ * @memory		allocated memory
+ * @return		status code
+ */
+efi_status_t efi_allocate_pages(int type, int memory_type,
+				efi_uintn_t pages, uint64_t *memory)
+{
+	u64 len = pages << EFI_PAGE_SHIFT;
+	efi_status_t r = EFI_SUCCESS;
+	uint64_t addr;
+
+	if (!efi_memory_type_valid(memory_type))
+		return EFI_INVALID_PARAMETER;
+
+	switch (type) {
+	case 0:
+		/* Any page */
+		addr = efi_find_free_memory(len, gd->start_addr_sp);
+		if (!addr) {
+			r = EFI_NOT_FOUND;
+			break;
+		}
+		break;
+	case 1:
+		/* Max address */
+		addr = efi_find_free_memory(len, *memory);
+		if (!addr) {
+			r = EFI_NOT_FOUND;
+			break;
+		}
+		break;
+	case 2:
+		/* Exact address, reserve it. The addr is already in *memory. */
+		addr = *memory;
+		break;
+	default:
+		/* UEFI doesn't specify other allocation types */
+		r = EFI_INVALID_PARAMETER;
+		break;
+	}
+
+	if (r == EFI_SUCCESS) {
+		uint64_t ret;
+
+		/* Reserve that map in our memory maps */
+		ret = efi_add_memory_map(addr, pages, memory_type, true);
+		if (ret == addr) {
+			*memory = addr;
+		} else {
+			/* Map would overlap, bail out */
+			r = EFI_OUT_OF_RESOURCES;
+		}
+	}
+
+	return r;
+}
+
+/*
+ * Free memory pages.
+ *
+ * @memory	start of the memory area to be freed
+ * @pages	number of pages to be freed
+ * @return	status code
+ */
+efi_status_t efi_free_pages(uint64_t memory, efi_uintn_t pages)
+{
+	uint64_t r = 0;
+
+	r = efi_add_memory_map(memory, pages, EFI_CONVENTIONAL_MEMORY, false);
+	/* Merging of adjacent free regions is missing */
+
+	if (r == memory)
+		return EFI_SUCCESS;
+
+	return EFI_NOT_FOUND;
+}
+
+/*
+ * Get map describing memory usage.
+ *
+ * @memory_map_size	on entry the size, in bytes, of the memory map buffer,
+ *			on exit the size of the copied memory map
+ * @memory_map		buffer to which the memory map is written
+ * @map_key		key for the memory map
+ * @descriptor_size	size of an individual memory descriptor
+ * @descriptor_version	version number of the memory descriptor structure
+ * @return		status code
+ */
+efi_status_t efi_get_memory_map(efi_uintn_t *memory_map_size,
+				struct efi_mem_desc *memory_map,
+				efi_uintn_t *map_key,
+				efi_uintn_t *descriptor_size,
+				uint32_t *descriptor_version)
+{
+	efi_uintn_t map_size = 0;
+	struct rb_node *rb;
+	efi_uintn_t provided_map_size = *memory_map_size;
+
+	map_size = efi_mem_count * sizeof(struct efi_mem_desc);
+
+	*memory_map_size = map_size;
+
+	if (provided_map_size < map_size)
+		return EFI_BUFFER_TOO_SMALL;
+
+	if (descriptor_size)
+		*descriptor_size = sizeof(struct efi_mem_desc);
+
+	if (descriptor_version)
+		*descriptor_version = EFI_MEMORY_DESCRIPTOR_VERSION;
+
+	/* Copy tree into array, in ascending order */
+	if (memory_map) {
+		for (rb = rb_first(&efi_mem); rb; rb = rb_next(rb)) {
+			struct efi_mem_node *node;
+
+			node = rb_entry(rb, struct efi_mem_node, rb);
+			*memory_map++ = node->desc;
+		}
+	}
+
+	*map_key = 0;
+
+	return EFI_SUCCESS;
+}
@@ -17,8 +17,28 @@ DECLARE_GLOBAL_DATA_PTR;
 static const efi_guid_t efi_net_guid = EFI_SIMPLE_NETWORK_GUID;
 static const efi_guid_t efi_pxe_guid = EFI_PXE_GUID;
 static struct efi_pxe_packet *dhcp_ack;
-static bool new_rx_packet;
-static void *new_tx_packet;
+
+/* Number of received frames held until the payload picks them up */
+#define EFI_NET_RX_SLOTS	32
+/* Number of transmitted buffers held until the payload recycles them */
+#define EFI_NET_TX_SLOTS	32
+
+/*
+ * Ring of received frames. Frames are captured from eth_rx() by
+ * efi_net_push() and handed out in order of arrival by efi_net_receive().
+ */
+static u8 *rx_frames;
+static size_t rx_lengths[EFI_NET_RX_SLOTS];
+static unsigned int rx_head;
+static unsigned int rx_count;
+/*
+ * Ring of transmitted buffers. Packets are sent synchronously, so the
+ * buffers are complete at once and wait here to be returned by
+ * efi_net_get_status().
+ */
+static void *tx_done[EFI_NET_TX_SLOTS];
+static unsigned int tx_head;
+static unsigned int tx_count;
 /*
  * The notification function of this event is called in every timer cycle
  * to check if a new network packet has been received.
@@ -40,6 +60,27 @@ struct efi_net_obj {
 	struct efi_pxe_mode pxe_mode;
 };
 
+/* The network object of the active eth device */
+static struct efi_net_obj *efi_net;
+
+/* Supported receive filters */
+#define EFI_NET_RECEIVE_FILTERS (EFI_SIMPLE_NETWORK_RECEIVE_UNICAST | \
+				 EFI_SIMPLE_NETWORK_RECEIVE_MULTICAST | \
+				 EFI_SIMPLE_NETWORK_RECEIVE_BROADCAST | \
+				 EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS | \
+				 EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS_MULTICAST)
+
+/*
+ * Discard all received frames and transmit completions.
+ */
+static void efi_net_flush_queues(void)
+{
+	rx_head = 0;
+	rx_count = 0;
+	tx_head = 0;
+	tx_count = 0;
+}
+
 static efi_status_t EFIAPI efi_net_start(struct efi_simple_network *this)
 {
 	EFI_ENTRY("%p", this);
@@ -59,6 +100,7 @@ static efi_status_t EFIAPI efi_net_initialize(struct efi_simple_network *this,
 {
 	EFI_ENTRY("%p, %lx, %lx", this, extra_rx, extra_tx);
 
+	efi_net_flush_queues();
 	eth_init();
 
 	return EFI_EXIT(EFI_SUCCESS);
@@ -69,6 +111,8 @@ static efi_status_t EFIAPI efi_net_reset(struct efi_simple_network *this,
 {
 	EFI_ENTRY("%p, %x", this, extended_verification);
 
+	efi_net_flush_queues();
+
 	return EFI_EXIT(EFI_SUCCESS);
 }
 
@@ -76,18 +120,67 @@ static efi_status_t EFIAPI efi_net_shutdown(struct efi_simple_network *this)
 {
 	EFI_ENTRY("%p", this);
 
+	efi_net_flush_queues();
+
 	return EFI_EXIT(EFI_SUCCESS);
 }
 
+/*
+ * Manage the receive filters of a network interface.
+ *
+ * This function implements the ReceiveFilters service of the Simple Network
+ * Protocol. See the UEFI spec for details.
+ *
+ * The filters are applied in software when a frame is captured, so frames
+ * the payload is not interested in never take up a slot of the receive
+ * ring.
+ *
+ * @this		the instance of the Simple Network Protocol
+ * @enable		receive filters to enable
+ * @disable		receive filters to disable
+ * @reset_mcast_filter	clear the multicast filter list
+ * @mcast_filter_count	number of entries in the multicast filter list
+ * @mcast_filter	multicast filter list
+ * @return		status code
+ */
 static efi_status_t EFIAPI efi_net_receive_filters(
 		struct efi_simple_network *this, u32 enable, u32 disable,
 		int reset_mcast_filter, ulong mcast_filter_count,
 		struct efi_mac_address *mcast_filter)
 {
+	struct efi_simple_network_mode *mode;
+	ulong i;
+
 	EFI_ENTRY("%p, %x, %x, %x, %lx, %p", this, enable, disable,
 		  reset_mcast_filter, mcast_filter_count, mcast_filter);
 
-	return EFI_EXIT(EFI_UNSUPPORTED);
+	if (!this)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+	mode = this->mode;
+	if ((enable | disable) & ~mode->receive_filter_mask)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+	if (!reset_mcast_filter && mcast_filter_count) {
+		if (!(enable & EFI_SIMPLE_NETWORK_RECEIVE_MULTICAST) ||
+		    mcast_filter_count > mode->max_mcast_filter_count ||
+		    !mcast_filter)
+			return EFI_EXIT(EFI_INVALID_PARAMETER);
+		for (i = 0; i < mcast_filter_count; i++) {
+			if (!(mcast_filter[i].mac_addr[0] & 1))
+				return EFI_EXIT(EFI_INVALID_PARAMETER);
+		}
+	}
+
+	mode->receive_filter_setting |= enable;
+	mode->receive_filter_setting &= ~disable;
+	if (reset_mcast_filter) {
+		mode->mcast_filter_count = 0;
+	} else if (mcast_filter_count) {
+		memcpy(mode->mcast_filter, mcast_filter,
+		       mcast_filter_count * sizeof(*mcast_filter));
+		mode->mcast_filter_count = mcast_filter_count;
+	}
+
+	return EFI_EXIT(EFI_SUCCESS);
 }
 
 static efi_status_t EFIAPI efi_net_station_address(
@@ -138,13 +231,18 @@ static efi_status_t EFIAPI efi_net_get_status(struct efi_simple_network *this,
 	if (int_status) {
 		/* We send packets synchronously, so nothing is outstanding */
 		*int_status = EFI_SIMPLE_NETWORK_TRANSMIT_INTERRUPT;
-		if (new_rx_packet)
+		if (rx_count)
 			*int_status |= EFI_SIMPLE_NETWORK_RECEIVE_INTERRUPT;
 	}
-	if (txbuf)
-		*txbuf = new_tx_packet;
-
-	new_tx_packet = NULL;
+	if (txbuf) {
+		/* Recycle the oldest transmitted buffer */
+		*txbuf = NULL;
+		if (tx_count) {
+			*txbuf = tx_done[tx_head];
+			tx_head = (tx_head + 1) % EFI_NET_TX_SLOTS;
+			tx_count--;
+		}
+	}
 
 	return EFI_EXIT(EFI_SUCCESS);
 }
@@ -173,14 +271,78 @@ static efi_status_t EFIAPI efi_net_transmit(struct efi_simple_network *this,
 	net_send_packet(buffer, buffer_size);
 #endif
 
-	new_tx_packet = buffer;
+	/*
+	 * Queue the buffer for recycling. If the payload does not collect
+	 * its buffers, forget the oldest one.
+	 */
+	if (tx_count == EFI_NET_TX_SLOTS) {
+		tx_head = (tx_head + 1) % EFI_NET_TX_SLOTS;
+		tx_count--;
+	}
+	tx_done[(tx_head + tx_count) % EFI_NET_TX_SLOTS] = buffer;
+	tx_count++;
 
 	return EFI_EXIT(EFI_SUCCESS);
 }
 
+/*
+ * Check a received frame against the receive filters.
+ *
+ * @mode	mode of the Simple Network Protocol
+ * @dest	destination MAC address of the frame
+ * @return	true if the payload wants to receive the frame
+ */
+static bool efi_net_accept(struct efi_simple_network_mode *mode,
+			   const u8 *dest)
+{
+	u32 filter = mode->receive_filter_setting;
+	u32 i;
+
+	if (filter & EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS)
+		return true;
+	if (is_broadcast_ethaddr(dest))
+		return filter & EFI_SIMPLE_NETWORK_RECEIVE_BROADCAST;
+	if (is_multicast_ethaddr(dest)) {
+		if (filter & EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS_MULTICAST)
+			return true;
+		if (!(filter & EFI_SIMPLE_NETWORK_RECEIVE_MULTICAST))
+			return false;
+		for (i = 0; i < mode->mcast_filter_count; i++) {
+			if (!memcmp(dest, mode->mcast_filter[i].mac_addr,
+				    ARP_HLEN))
+				return true;
+		}
+		return false;
+	}
+	return (filter & EFI_SIMPLE_NETWORK_RECEIVE_UNICAST) &&
+	       !memcmp(dest, mode->current_address.mac_addr, ARP_HLEN);
+}
+
+/*
+ * Capture a frame received by eth_rx() into the receive ring.
+ *
+ * Frames that do not pass the receive filters, and frames arriving while
+ * the ring is full, are dropped.
+ *
+ * @pkt		received frame
+ * @len		length of the frame
+ */
 static void efi_net_push(void *pkt, int len)
 {
-	new_rx_packet = true;
+	struct ethernet_hdr *eth_hdr = pkt;
+	unsigned int slot;
+
+	if (len < ETHER_HDR_SIZE || len > PKTSIZE)
+		return;
+	if (!efi_net_accept(&efi_net->net_mode, eth_hdr->et_dest))
+		return;
+	if (rx_count == EFI_NET_RX_SLOTS)
+		return;
+
+	slot = (rx_head + rx_count) % EFI_NET_RX_SLOTS;
+	memcpy(rx_frames + slot * PKTSIZE_ALIGN, pkt, len);
+	rx_lengths[slot] = len;
+	rx_count++;
 	wait_for_packet->is_signaled = true;
 }
 
@@ -206,6 +368,8 @@ static efi_status_t EFIAPI efi_net_receive(struct efi_simple_network *this,
 {
 	struct ethernet_hdr *eth_hdr;
 	size_t hdr_size = sizeof(struct ethernet_hdr);
+	u8 *pkt;
+	size_t len;
 	u16 protlen;
 
 	EFI_ENTRY("%p, %p, %p, %p, %p, %p, %p", this, header_size,
@@ -213,19 +377,17 @@ static efi_status_t EFIAPI efi_net_receive(struct efi_simple_network *this,
 
 	efi_timer_check();
 
-	if (!new_rx_packet)
+	if (!rx_count)
 		return EFI_EXIT(EFI_NOT_READY);
-	/* Check that we at least received an Ethernet header */
-	if (net_rx_packet_len < sizeof(struct ethernet_hdr)) {
-		new_rx_packet = false;
-		return EFI_EXIT(EFI_NOT_READY);
-	}
+	/* efi_net_push() only queues frames with an Ethernet header */
+	pkt = rx_frames + rx_head * PKTSIZE_ALIGN;
+	len = rx_lengths[rx_head];
 	/* Fill export parameters */
-	eth_hdr = (struct ethernet_hdr *)net_rx_packet;
+	eth_hdr = (struct ethernet_hdr *)pkt;
 	protlen = ntohs(eth_hdr->et_protlen);
 	if (protlen == 0x8100) {
 		hdr_size += 4;
-		protlen = ntohs(*(u16 *)&net_rx_packet[hdr_size - 2]);
+		protlen = ntohs(*(u16 *)&pkt[hdr_size - 2]);
 	}
 	if (header_size)
 		*header_size = hdr_size;
@@ -235,15 +397,16 @@ static efi_status_t EFIAPI efi_net_receive(struct efi_simple_network *this,
 		memcpy(src_addr, eth_hdr->et_src, ARP_HLEN);
 	if (protocol)
 		*protocol = protlen;
-	if (*buffer_size < net_rx_packet_len) {
+	if (*buffer_size < len) {
 		/* Packet doesn't fit, try again with bigger buf */
-		*buffer_size = net_rx_packet_len;
+		*buffer_size = len;
 		return EFI_EXIT(EFI_BUFFER_TOO_SMALL);
 	}
-	/* Copy packet */
-	memcpy(buffer, net_rx_packet, net_rx_packet_len);
-	*buffer_size = net_rx_packet_len;
-	new_rx_packet = false;
+	/* Copy packet and release its slot */
+	memcpy(buffer, pkt, len);
+	*buffer_size = len;
+	rx_head = (rx_head + 1) % EFI_NET_RX_SLOTS;
+	rx_count--;
 
 	return EFI_EXIT(EFI_SUCCESS);
 }
@@ -259,9 +422,10 @@ void efi_net_set_dhcp_ack(void *pkt, int len)
 }
 
 /*
- * Check if a new network packet has been received.
+ * Check if new network packets have been received.
  *
- * This notification function is called in every timer cycle.
+ * This notification function is called in every timer cycle. All frames
+ * the driver has ready are captured as long as the receive ring has room.
  *
  * @event	the event for which this notification function is registered
  * @context	event context - not used in this function
@@ -271,7 +435,7 @@ static void EFIAPI efi_network_timer_notify(struct efi_event *event,
 {
 	EFI_ENTRY("%p, %p", event, context);
 
-	if (!new_rx_packet) {
+	if (rx_count < EFI_NET_RX_SLOTS) {
 		push_packet = efi_net_push;
 		eth_rx();
 		push_packet = NULL;
@@ -294,6 +458,11 @@ int efi_net_register(void)
 	netobj = calloc(1, sizeof(*netobj));
 	if (!netobj)
 		goto out_of_memory;
+	rx_frames = malloc(EFI_NET_RX_SLOTS * PKTSIZE_ALIGN);
+	if (!rx_frames)
+		goto out_of_memory;
+	efi_net_flush_queues();
+	efi_net = netobj;
 
 	/* Hook net up to the device list */
 	efi_add_handle(&netobj->parent);
@@ -330,6 +499,14 @@ int efi_net_register(void)
 	memcpy(netobj->net_mode.current_address.mac_addr, eth_get_ethaddr(), 6);
 	netobj->net_mode.hwaddr_size = ARP_HLEN;
 	netobj->net_mode.max_packet_size = PKTSIZE;
+	netobj->net_mode.receive_filter_mask = EFI_NET_RECEIVE_FILTERS;
+	netobj->net_mode.receive_filter_setting =
+		EFI_SIMPLE_NETWORK_RECEIVE_UNICAST |
+		EFI_SIMPLE_NETWORK_RECEIVE_BROADCAST |
+		EFI_SIMPLE_NETWORK_RECEIVE_PROMISCUOUS_MULTICAST;
+	netobj->net_mode.max_mcast_filter_count =
+		ARRAY_SIZE(netobj->net_mode.mcast_filter);
+	memset(netobj->net_mode.broadcast_address.mac_addr, 0xff, ARP_HLEN);
 
 	netobj->pxe.mode = &netobj->pxe_mode;
 	if (dhcp_ack)
@@ -6,13 +6,23 @@
  *  SPDX-License-Identifier:     GPL-2.0+
  */
 
+#include <common.h>
 #include <malloc.h>
 #include <charset.h>
 #include <efi_loader.h>
+#include <environment.h>
+#include <search.h>
+#include <uuid.h>
 
 #define READ_ONLY BIT(31)
 
 /*
+ * EFI variables are kept in a binary store in memory, indexed by vendor
+ * GUID and name. The store is populated from the u-boot environment on
+ * first access and written back to it in batches, see
+ * efi_variables_flush(). bootefi reloads it with efi_variables_reload(),
+ * so that changes made to the environment in between are seen.
+ *
  * Mapping between EFI variables and u-boot variables:
  *
  *   efi_$guid_$varname = {attributes}(type)value
@@ -22,33 +32,77 @@
  *   efi_8be4df61-93ca-11d2-aa0d-00e098032b8c_OsIndicationsSupported=
  *      "{ro,boot,run}(blob)0000000000000000"
  *   efi_8be4df61-93ca-11d2-aa0d-00e098032b8c_BootOrder=
- *      "(blob)00010000"
+ *      "{nv,boot,run}(base64)AAEAAA=="
  *
  * The attributes are a comma separated list of these possible
  * attributes:
  *
  *   + ro   - read-only
+ *   + nv   - non-volatile
  *   + boot - boot-services access
  *   + run  - runtime access
  *
- * NOTE: with current implementation, no variables are available after
- * ExitBootServices, and all are persisted (if possible).
+ * Only non-volatile variables are written to the environment. Variables
+ * imported from the environment stay there until they are deleted or
+ * rewritten as volatile. No variables are available after
+ * ExitBootServices.
  *
  * If not specified, the attributes default to "{boot}".
  *
- * The required type is one of:
+ * Older versions wrote utf8 and blob values without "nv", although all
+ * variables they kept in the environment were persistent. Such values
+ * are imported as non-volatile unless they are read-only.
  *
- *   + utf8 - raw utf8 string
- *   + blob - arbitrary length hex string
+ * The required type is one of:
  *
- * Maybe a utf16 type would be useful to for a string value to be auto
- * converted to utf16?
+ *   + utf8   - raw utf8 string
+ *   + blob   - arbitrary length hex string
+ *   + base64 - base64 encoded binary data, used when writing variables
  */
 
-#define MAX_VAR_NAME 31
-#define MAX_NATIVE_VAR_NAME \
-	(strlen("efi_xxxxxxxx-xxxx-xxxx-xxxxxxxxxxxxxxxx_") + \
-		(MAX_VAR_NAME * MAX_UTF8_PER_UTF16))
+#define ACCESS_ATTR (EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+/* Number of buckets of the variable index, must be a power of two */
+#define EFI_VAR_HASH_SIZE 64
+
+/**
+ * struct efi_var - EFI variable in the variable store
+ *
+ * @link:	link in the list of variables, in order of creation
+ * @hash_next:	next variable in the same hash bucket
+ * @vendor:	vendor GUID
+ * @attributes:	EFI_VARIABLE_* attributes and READ_ONLY
+ * @dirty:	the variable has to be written to the environment
+ * @deleted:	the variable has been deleted but still has to be removed
+ *		from the environment
+ * @in_env:	the environment holds a copy of the variable
+ * @name_size:	size of the name in bytes, including the terminating zero
+ * @data_size:	size of the value in bytes
+ * @data:	value
+ * @name:	UTF-16 name
+ */
+struct efi_var {
+	struct list_head link;
+	struct efi_var *hash_next;
+	efi_guid_t vendor;
+	u32 attributes;
+	bool dirty;
+	bool deleted;
+	bool in_env;
+	efi_uintn_t name_size;
+	efi_uintn_t data_size;
+	u8 *data;
+	u16 name[];
+};
+
+static LIST_HEAD(efi_vars);
+static struct efi_var *efi_var_hash[EFI_VAR_HASH_SIZE];
+static bool efi_vars_loaded;
+/* Bytes of the store used by names and values of live variables */
+static efi_uintn_t efi_vars_used;
+
+static const char base64_chars[] =
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 
 static int hex(unsigned char ch)
 {
@@ -101,33 +155,51 @@ static const char *hex2mem(u8 *mem, const char *hexstr, int count)
 	return NULL;
 }
 
-static char *mem2hex(char *hexstr, const u8 *mem, int count)
+static char *mem2base64(char *str, const u8 *mem, size_t count)
 {
-	static const char hexchars[] = "0123456789abcdef";
-
-	while (count-- > 0) {
-		u8 ch = *mem++;
-		*hexstr++ = hexchars[ch >> 4];
-		*hexstr++ = hexchars[ch & 0xf];
+	u32 bits;
+
+	for (; count >= 3; count -= 3, mem += 3) {
+		bits = mem[0] << 16 | mem[1] << 8 | mem[2];
+		*str++ = base64_chars[bits >> 18];
+		*str++ = base64_chars[(bits >> 12) & 0x3f];
+		*str++ = base64_chars[(bits >> 6) & 0x3f];
+		*str++ = base64_chars[bits & 0x3f];
+	}
+	if (count) {
+		bits = mem[0] << 16 | (count > 1 ? mem[1] << 8 : 0);
+		*str++ = base64_chars[bits >> 18];
+		*str++ = base64_chars[(bits >> 12) & 0x3f];
+		*str++ = count > 1 ? base64_chars[(bits >> 6) & 0x3f] : '=';
+		*str++ = '=';
 	}
 
-	return hexstr;
+	return str;
 }
 
-static efi_status_t efi_to_native(char *native, s16 *variable_name,
-		efi_guid_t *vendor)
+/*
+ * Decode a base64 string. Returns the number of bytes written to @mem,
+ * or -1 if the string is malformed.
+ */
+static int base642mem(u8 *mem, const char *str)
 {
-	size_t len;
-
-	len = utf16_strlen((u16 *)variable_name);
-	if (len >= MAX_VAR_NAME)
-		return EFI_DEVICE_ERROR;
-
-	native += sprintf(native, "efi_%pUl_", vendor);
-	native  = (char *)utf16_to_utf8((u8 *)native, (u16 *)variable_name, len);
-	*native = '\0';
+	u32 bits = 0;
+	int nbits = 0, len = 0;
+	const char *c;
+
+	for (; *str && *str != '='; str++) {
+		c = strchr(base64_chars, *str);
+		if (!c)
+			return -1;
+		bits = bits << 6 | (c - base64_chars);
+		nbits += 6;
+		if (nbits >= 8) {
+			nbits -= 8;
+			mem[len++] = bits >> nbits;
+		}
+	}
 
-	return EFI_SUCCESS;
+	return len;
 }
 
 static const char *prefix(const char *str, const char *prefix)
@@ -156,6 +228,8 @@ static const char *parse_attr(const char *str, u32 *attrp)
 
 		if ((s = prefix(str, "ro"))) {
 			attr |= READ_ONLY;
+		} else if ((s = prefix(str, "nv"))) {
+			attr |= EFI_VARIABLE_NON_VOLATILE;
 		} else if ((s = prefix(str, "boot"))) {
 			attr |= EFI_VARIABLE_BOOTSERVICE_ACCESS;
 		} else if ((s = prefix(str, "run"))) {
@@ -176,76 +250,328 @@ static const char *parse_attr(const char *str, u32 *attrp)
 	return str;
 }
 
-/* http://wiki.phoenix.com/wiki/index.php/EFI_RUNTIME_SERVICES#GetVariable.28.29 */
-efi_status_t EFIAPI efi_get_variable(s16 *variable_name,
-		efi_guid_t *vendor, u32 *attributes,
-		unsigned long *data_size, void *data)
+static unsigned int efi_var_hash_key(const u16 *name, efi_uintn_t name_size,
+				     const efi_guid_t *vendor)
 {
-	char native_name[MAX_NATIVE_VAR_NAME + 1];
-	efi_status_t ret;
-	unsigned long in_size;
-	const char *val, *s;
-	u32 attr;
+	const u8 *p = (const u8 *)vendor;
+	u32 hash = 2166136261u;
+	efi_uintn_t i;
+
+	/* FNV-1a */
+	for (i = 0; i < sizeof(*vendor); i++)
+		hash = (hash ^ p[i]) * 16777619;
+	p = (const u8 *)name;
+	for (i = 0; i < name_size; i++)
+		hash = (hash ^ p[i]) * 16777619;
+
+	return hash & (EFI_VAR_HASH_SIZE - 1);
+}
 
-	EFI_ENTRY("\"%ls\" %pUl %p %p %p", variable_name, vendor, attributes,
-		  data_size, data);
+static struct efi_var *efi_var_find(const u16 *name, efi_uintn_t name_size,
+				    const efi_guid_t *vendor)
+{
+	struct efi_var *var;
+
+	var = efi_var_hash[efi_var_hash_key(name, name_size, vendor)];
+	for (; var; var = var->hash_next) {
+		if (var->name_size == name_size &&
+		    !guidcmp(&var->vendor, vendor) &&
+		    !memcmp(var->name, name, name_size))
+			return var;
+	}
 
-	if (!variable_name || !vendor || !data_size)
-		return EFI_EXIT(EFI_INVALID_PARAMETER);
+	return NULL;
+}
 
-	ret = efi_to_native(native_name, variable_name, vendor);
-	if (ret)
-		return EFI_EXIT(ret);
+static struct efi_var *efi_var_new(const u16 *name, efi_uintn_t name_size,
+				   const efi_guid_t *vendor)
+{
+	struct efi_var *var;
+	unsigned int key;
+
+	var = calloc(1, sizeof(*var) + name_size);
+	if (!var)
+		return NULL;
+	memcpy(var->name, name, name_size);
+	guidcpy(&var->vendor, vendor);
+	var->name_size = name_size;
+	var->deleted = true;
+
+	key = efi_var_hash_key(name, name_size, vendor);
+	var->hash_next = efi_var_hash[key];
+	efi_var_hash[key] = var;
+	list_add_tail(&var->link, &efi_vars);
+
+	return var;
+}
+
+static void efi_var_free(struct efi_var *var)
+{
+	struct efi_var **p;
+
+	p = &efi_var_hash[efi_var_hash_key(var->name, var->name_size,
+					   &var->vendor)];
+	while (*p != var)
+		p = &(*p)->hash_next;
+	*p = var->hash_next;
+	list_del(&var->link);
+	free(var->data);
+	free(var);
+}
 
-	debug("%s: get '%s'\n", __func__, native_name);
+/*
+ * Import one efi_$guid_$varname environment variable into the store.
+ */
+static void efi_var_import(const char *key, const char *val)
+{
+	char guid_str[UUID_STR_LEN + 1];
+	efi_guid_t vendor;
+	struct efi_var *var;
+	efi_uintn_t len, name_size;
+	const char *name, *s;
+	u16 *name16;
+	bool legacy = true;
+	u8 *data;
+	u32 attr;
+	int size;
 
-	val = env_get(native_name);
-	if (!val)
-		return EFI_EXIT(EFI_NOT_FOUND);
+	name = key + strlen("efi_");
+	if (strlen(name) <= UUID_STR_LEN + 1 || name[UUID_STR_LEN] != '_')
+		return;
+	memcpy(guid_str, name, UUID_STR_LEN);
+	guid_str[UUID_STR_LEN] = '\0';
+	if (uuid_str_to_bin(guid_str, vendor.b, UUID_STR_FORMAT_GUID))
+		return;
+	name += UUID_STR_LEN + 1;
 
 	val = parse_attr(val, &attr);
+	len = strlen(val);
 
-	in_size = *data_size;
-
+	/* The value never needs more bytes than its string */
+	data = malloc(len + 1);
+	if (!data)
+		return;
 	if ((s = prefix(val, "(blob)"))) {
-		unsigned len = strlen(s);
+		size = DIV_ROUND_UP(strlen(s), 2);
+		if (hex2mem(data, s, size * 2))
+			size = -1;
+	} else if ((s = prefix(val, "(utf8)"))) {
+		size = strlen(s) + 1;
+		memcpy(data, s, size);
+	} else if ((s = prefix(val, "(base64)"))) {
+		size = base642mem(data, s);
+		legacy = false;
+	} else {
+		size = -1;
+	}
+	if (size < 0) {
+		debug("%s: invalid value: '%s'\n", __func__, val);
+		free(data);
+		return;
+	}
+	if (legacy && !(attr & READ_ONLY))
+		attr |= EFI_VARIABLE_NON_VOLATILE;
+
+	len = strlen(name);
+	name16 = calloc(len + 1, sizeof(u16));
+	if (!name16) {
+		free(data);
+		return;
+	}
+	utf8_to_utf16(name16, (const u8 *)name, len);
+	name_size = (utf16_strlen(name16) + 1) * sizeof(u16);
+
+	var = efi_var_find(name16, name_size, &vendor);
+	if (!var)
+		var = efi_var_new(name16, name_size, &vendor);
+	free(name16);
+	if (!var) {
+		free(data);
+		return;
+	}
 
-		/* two characters per byte: */
-		len = DIV_ROUND_UP(len, 2);
-		*data_size = len;
+	if (!var->deleted)
+		efi_vars_used -= var->name_size + var->data_size;
+	free(var->data);
+	var->data = data;
+	var->data_size = size;
+	var->attributes = attr;
+	var->deleted = false;
+	var->dirty = false;
+	var->in_env = true;
+	efi_vars_used += var->name_size + var->data_size;
+}
+
+/*
+ * Populate the variable store from the environment on first use.
+ */
+static void efi_vars_load(void)
+{
+	ENTRY *match;
+	int idx = 0;
 
-		if (in_size < len)
-			return EFI_EXIT(EFI_BUFFER_TOO_SMALL);
+	if (efi_vars_loaded)
+		return;
+	efi_vars_loaded = true;
 
-		if (!data)
-			return EFI_EXIT(EFI_INVALID_PARAMETER);
+	while ((idx = hmatch_r("efi_", idx, &match, &env_htab)))
+		efi_var_import(match->key, match->data);
+}
 
-		if (hex2mem(data, s, len * 2))
-			return EFI_EXIT(EFI_DEVICE_ERROR);
+/*
+ * Write one variable back to the environment.
+ */
+static int efi_var_export(struct efi_var *var)
+{
+	char *key, *val, *s;
+	u32 attr = var->attributes;
+	size_t len;
+	int ret;
+
+	len = (var->name_size / sizeof(u16)) * MAX_UTF8_PER_UTF16;
+	key = malloc(strlen("efi_xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx_") +
+		     len + 1);
+	if (!key)
+		return -ENOMEM;
+	s = key + sprintf(key, "efi_%pUl_", &var->vendor);
+	s = (char *)utf16_to_utf8((u8 *)s, var->name,
+				  var->name_size / sizeof(u16) - 1);
+	*s = '\0';
 
-		debug("%s: got value: \"%s\"\n", __func__, s);
-	} else if ((s = prefix(val, "(utf8)"))) {
-		unsigned len = strlen(s) + 1;
+	if (var->deleted || !(attr & EFI_VARIABLE_NON_VOLATILE)) {
+		ret = var->in_env ? env_set(key, NULL) : 0;
+		if (!ret)
+			var->in_env = false;
+		free(key);
+		return ret;
+	}
 
-		*data_size = len;
+	val = malloc(strlen("{ro,nv,boot,run}(base64)") +
+		     DIV_ROUND_UP(var->data_size, 3) * 4 + 1);
+	if (!val) {
+		free(key);
+		return -ENOMEM;
+	}
 
-		if (in_size < len)
-			return EFI_EXIT(EFI_BUFFER_TOO_SMALL);
+	/* store attributes: */
+	s = val;
+	*s++ = '{';
+	if (attr & READ_ONLY)
+		s += sprintf(s, "ro,");
+	s += sprintf(s, "nv");
+	if (attr & EFI_VARIABLE_BOOTSERVICE_ACCESS)
+		s += sprintf(s, ",boot");
+	if (attr & EFI_VARIABLE_RUNTIME_ACCESS)
+		s += sprintf(s, ",run");
+	*s++ = '}';
 
-		if (!data)
-			return EFI_EXIT(EFI_INVALID_PARAMETER);
+	/* store payload: */
+	s += sprintf(s, "(base64)");
+	s = mem2base64(s, var->data, var->data_size);
+	*s = '\0';
 
-		memcpy(data, s, len);
-		((char *)data)[len] = '\0';
+	debug("%s: setting: %s=%s\n", __func__, key, val);
 
-		debug("%s: got value: \"%s\"\n", __func__, (char *)data);
-	} else {
-		debug("%s: invalid value: '%s'\n", __func__, val);
-		return EFI_EXIT(EFI_DEVICE_ERROR);
+	ret = env_set(key, val);
+	if (!ret)
+		var->in_env = true;
+
+	free(val);
+	free(key);
+
+	return ret;
+}
+
+/**
+ * efi_variables_flush() - write changed variables to the environment
+ *
+ * SetVariable() only updates the in-memory store. This function writes
+ * all changed non-volatile variables to the environment and removes
+ * deleted and volatile ones from it. If CONFIG_EFI_VARIABLES_SAVEENV is
+ * enabled, the environment is also saved to its storage.
+ */
+void efi_variables_flush(void)
+{
+	struct efi_var *var, *tmp;
+	bool changed = false;
+
+	list_for_each_entry_safe(var, tmp, &efi_vars, link) {
+		if (!var->dirty)
+			continue;
+		if (efi_var_export(var)) {
+			printf("EFI: cannot store variable %ls\n", var->name);
+			continue;
+		}
+		var->dirty = false;
+		changed = true;
+		if (var->deleted)
+			efi_var_free(var);
+	}
+
+	if (changed && IS_ENABLED(CONFIG_EFI_VARIABLES_SAVEENV))
+		env_save();
+}
+
+/**
+ * efi_variables_reload() - re-read the variables from the environment
+ *
+ * The environment may have been changed by setenv, env default or env
+ * import since the store was loaded. Changed variables are written back
+ * first. All variables taken from the environment are then dropped, and
+ * the next access imports them again. Volatile variables are kept.
+ */
+void efi_variables_reload(void)
+{
+	struct efi_var *var, *tmp;
+
+	if (!efi_vars_loaded)
+		return;
+	efi_variables_flush();
+
+	list_for_each_entry_safe(var, tmp, &efi_vars, link) {
+		if (!var->in_env)
+			continue;
+		if (!var->deleted)
+			efi_vars_used -= var->name_size + var->data_size;
+		efi_var_free(var);
+	}
+	efi_vars_loaded = false;
+}
+
+/* http://wiki.phoenix.com/wiki/index.php/EFI_RUNTIME_SERVICES#GetVariable.28.29 */
+efi_status_t EFIAPI efi_get_variable(s16 *variable_name,
+		efi_guid_t *vendor, u32 *attributes,
+		unsigned long *data_size, void *data)
+{
+	struct efi_var *var;
+	efi_uintn_t name_size;
+
+	EFI_ENTRY("\"%ls\" %pUl %p %p %p", variable_name, vendor, attributes,
+		  data_size, data);
+
+	if (!variable_name || !vendor || !data_size)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+
+	efi_vars_load();
+
+	name_size = (utf16_strlen((u16 *)variable_name) + 1) * sizeof(u16);
+	var = efi_var_find((u16 *)variable_name, name_size, vendor);
+	if (!var || var->deleted)
+		return EFI_EXIT(EFI_NOT_FOUND);
+
+	if (*data_size < var->data_size) {
+		*data_size = var->data_size;
+		return EFI_EXIT(EFI_BUFFER_TOO_SMALL);
 	}
+	*data_size = var->data_size;
+
+	if (!data)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+
+	memcpy(data, var->data, var->data_size);
 
 	if (attributes)
-		*attributes = attr & EFI_VARIABLE_MASK;
+		*attributes = var->attributes & EFI_VARIABLE_MASK;
 
 	return EFI_EXIT(EFI_SUCCESS);
 }
@@ -255,9 +581,44 @@ efi_status_t EFIAPI efi_get_next_variable(
 		unsigned long *variable_name_size,
 		s16 *variable_name, efi_guid_t *vendor)
 {
+	struct list_head *pos = &efi_vars;
+	struct efi_var *var;
+	efi_uintn_t name_size;
+
 	EFI_ENTRY("%p \"%ls\" %pUl", variable_name_size, variable_name, vendor);
 
-	return EFI_EXIT(EFI_DEVICE_ERROR);
+	if (!variable_name_size || !variable_name || !vendor)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+
+	efi_vars_load();
+
+	/* An empty name starts the enumeration */
+	if (variable_name[0]) {
+		name_size = (utf16_strlen((u16 *)variable_name) + 1) *
+			    sizeof(u16);
+		var = efi_var_find((u16 *)variable_name, name_size, vendor);
+		if (!var)
+			return EFI_EXIT(EFI_INVALID_PARAMETER);
+		pos = &var->link;
+	}
+
+	/* Skip deleted variables */
+	do {
+		pos = pos->next;
+		if (pos == &efi_vars)
+			return EFI_EXIT(EFI_NOT_FOUND);
+		var = list_entry(pos, struct efi_var, link);
+	} while (var->deleted);
+
+	if (*variable_name_size < var->name_size) {
+		*variable_name_size = var->name_size;
+		return EFI_EXIT(EFI_BUFFER_TOO_SMALL);
+	}
+	*variable_name_size = var->name_size;
+	memcpy(variable_name, var->name, var->name_size);
+	guidcpy(vendor, &var->vendor);
+
+	return EFI_EXIT(EFI_SUCCESS);
 }
 
 /* http://wiki.phoenix.com/wiki/index.php/EFI_RUNTIME_SERVICES#SetVariable.28.29 */
@@ -265,71 +626,130 @@ efi_status_t EFIAPI efi_set_variable(s16 *variable_name,
 		efi_guid_t *vendor, u32 attributes,
 		unsigned long data_size, void *data)
 {
-	char native_name[MAX_NATIVE_VAR_NAME + 1];
-	efi_status_t ret = EFI_SUCCESS;
-	char *val, *s;
-	u32 attr;
+	struct efi_var *var;
+	efi_uintn_t name_size, new_size, used;
+	bool append;
+	u8 *buf;
 
 	EFI_ENTRY("\"%ls\" %pUl %x %lu %p", variable_name, vendor, attributes,
 		  data_size, data);
 
-	if (!variable_name || !vendor)
+	if (!variable_name || !variable_name[0] || !vendor ||
+	    (data_size && !data))
 		return EFI_EXIT(EFI_INVALID_PARAMETER);
 
-	ret = efi_to_native(native_name, variable_name, vendor);
-	if (ret)
-		return EFI_EXIT(ret);
+	append = attributes & EFI_VARIABLE_APPEND_WRITE;
+	attributes &= ~EFI_VARIABLE_APPEND_WRITE;
+	if (attributes & ~(EFI_VARIABLE_NON_VOLATILE | ACCESS_ATTR))
+		return EFI_EXIT(EFI_UNSUPPORTED);
+	if (attributes == EFI_VARIABLE_RUNTIME_ACCESS)
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
 
-#define ACCESS_ATTR (EFI_VARIABLE_RUNTIME_ACCESS | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+	efi_vars_load();
+
+	name_size = (utf16_strlen((u16 *)variable_name) + 1) * sizeof(u16);
+	var = efi_var_find((u16 *)variable_name, name_size, vendor);
+	if (var && var->deleted)
+		var = NULL;
+	if (var && (var->attributes & READ_ONLY))
+		return EFI_EXIT(EFI_WRITE_PROTECTED);
 
-	if ((data_size == 0) || !(attributes & ACCESS_ATTR)) {
+	if ((!append && !data_size) || !(attributes & ACCESS_ATTR)) {
 		/* delete the variable: */
-		env_set(native_name, NULL);
+		if (!var)
+			return EFI_EXIT(EFI_NOT_FOUND);
+		efi_vars_used -= var->name_size + var->data_size;
+		free(var->data);
+		var->data = NULL;
+		var->data_size = 0;
+		var->deleted = true;
+		var->dirty = true;
+		if (!var->in_env)
+			efi_var_free(var);
 		return EFI_EXIT(EFI_SUCCESS);
 	}
 
-	val = env_get(native_name);
-	if (val) {
-		parse_attr(val, &attr);
+	if (append && !data_size)
+		return EFI_EXIT(EFI_SUCCESS);
 
-		if (attr & READ_ONLY)
-			return EFI_EXIT(EFI_WRITE_PROTECTED);
+	new_size = data_size;
+	used = efi_vars_used + name_size + data_size;
+	if (var) {
+		if (append)
+			new_size += var->data_size;
+		used -= var->name_size;
+		if (!append)
+			used -= var->data_size;
 	}
-
-	val = malloc(2 * data_size + strlen("{ro,run,boot}(blob)") + 1);
-	if (!val)
+	if (used > CONFIG_EFI_VARIABLE_STORE_SIZE)
 		return EFI_EXIT(EFI_OUT_OF_RESOURCES);
 
-	s = val;
+	buf = malloc(new_size);
+	if (!buf)
+		return EFI_EXIT(EFI_OUT_OF_RESOURCES);
 
-	/* store attributes: */
-	attributes &= (EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS);
-	s += sprintf(s, "{");
-	while (attributes) {
-		u32 attr = 1 << (ffs(attributes) - 1);
-
-		if (attr == EFI_VARIABLE_BOOTSERVICE_ACCESS)
-			s += sprintf(s, "boot");
-		else if (attr == EFI_VARIABLE_RUNTIME_ACCESS)
-			s += sprintf(s, "run");
-
-		attributes &= ~attr;
-		if (attributes)
-			s += sprintf(s, ",");
+	if (!var) {
+		var = efi_var_find((u16 *)variable_name, name_size, vendor);
+		if (!var)
+			var = efi_var_new((u16 *)variable_name, name_size,
+					  vendor);
+		if (!var) {
+			free(buf);
+			return EFI_EXIT(EFI_OUT_OF_RESOURCES);
+		}
 	}
-	s += sprintf(s, "}");
 
-	/* store payload: */
-	s += sprintf(s, "(blob)");
-	s = mem2hex(s, data, data_size);
-	*s = '\0';
+	if (append)
+		memcpy(buf, var->data, var->data_size);
+	memcpy(buf + new_size - data_size, data, data_size);
+	free(var->data);
+	var->data = buf;
+	var->data_size = new_size;
+	var->attributes = attributes;
+	var->deleted = false;
+	var->dirty = true;
+	efi_vars_used = used;
 
-	debug("%s: setting: %s=%s\n", __func__, native_name, val);
+	return EFI_EXIT(EFI_SUCCESS);
+}
 
-	if (env_set(native_name, val))
-		ret = EFI_DEVICE_ERROR;
+/**
+ * efi_query_variable_info() - get information about the variable store
+ *
+ * This function implements the QueryVariableInfo() runtime service.
+ * See the Unified Extensible Firmware Interface (UEFI) specification
+ * for details.
+ *
+ * @attributes:				attributes of the variables of interest
+ * @maximum_variable_storage_size:	receives the size of the store
+ * @remaining_variable_storage_size:	receives the free space of the store
+ * @maximum_variable_size:		receives the maximum variable size
+ * @return:				status code
+ */
+efi_status_t EFIAPI efi_query_variable_info(
+			u32 attributes,
+			u64 *maximum_variable_storage_size,
+			u64 *remaining_variable_storage_size,
+			u64 *maximum_variable_size)
+{
+	EFI_ENTRY("%x %p %p %p", attributes, maximum_variable_storage_size,
+		  remaining_variable_storage_size, maximum_variable_size);
 
-	free(val);
+	if (!maximum_variable_storage_size ||
+	    !remaining_variable_storage_size || !maximum_variable_size ||
+	    !(attributes & ACCESS_ATTR))
+		return EFI_EXIT(EFI_INVALID_PARAMETER);
+	if (attributes & ~(EFI_VARIABLE_NON_VOLATILE | ACCESS_ATTR))
+		return EFI_EXIT(EFI_UNSUPPORTED);
+
+	efi_vars_load();
 
-	return EFI_EXIT(ret);
+	*maximum_variable_storage_size = CONFIG_EFI_VARIABLE_STORE_SIZE;
+	*remaining_variable_storage_size = 0;
+	if (efi_vars_used < CONFIG_EFI_VARIABLE_STORE_SIZE)
+		*remaining_variable_storage_size =
+			CONFIG_EFI_VARIABLE_STORE_SIZE - efi_vars_used;
+	*maximum_variable_size = CONFIG_EFI_VARIABLE_STORE_SIZE;
+
+	return EFI_EXIT(EFI_SUCCESS);
 }
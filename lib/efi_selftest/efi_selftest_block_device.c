@@ -12,6 +12,8 @@
  * ConnectController is used to setup partitions and to install the simple
  * file protocol.
  * A known file is read from the file system and verified.
+ * The boot sector of the partition is read with the disk I/O and the
+ * block I/O 2 protocols and compared.
  */
 
 #include <efi_selftest.h>
@@ -26,6 +28,8 @@
 static struct efi_boot_services *boottime;
 
 static const efi_guid_t block_io_protocol_guid = BLOCK_IO_GUID;
+static const efi_guid_t block_io2_protocol_guid = BLOCK_IO2_GUID;
+static const efi_guid_t disk_io_protocol_guid = DISK_IO_GUID;
 static const efi_guid_t guid_device_path = DEVICE_PATH_GUID;
 static const efi_guid_t guid_simple_file_system_protocol =
 					EFI_SIMPLE_FILE_SYSTEM_PROTOCOL_GUID;
@@ -288,6 +292,96 @@ static efi_uintn_t dp_size(struct efi_device_path *dp)
 	return (char *)pos - (char *)dp;
 }
 
+/* Set by the notification function of the block I/O 2 token event */
+static bool io_completed;
+
+/*
+ * Notification function, signals the completion of a block I/O 2 request.
+ *
+ * @event	notified event
+ * @context	pointer to the completion flag
+ */
+static void EFIAPI notify(struct efi_event *event, void *context)
+{
+	*(bool *)context = true;
+}
+
+/*
+ * Read the start of a partition with the block I/O 2 and the disk I/O
+ * protocols and compare the results.
+ *
+ * @handle:	handle of the partition
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int check_disk_io(efi_handle_t handle)
+{
+	struct efi_disk_io *disk_io;
+	struct efi_block_io2 *block_io2;
+	struct efi_block_io2_token token;
+	struct efi_event *event;
+	u8 sectors[2 << LB_BLOCK_SIZE] __aligned(ARCH_DMA_MINALIGN);
+	u8 bytes[8];
+	efi_status_t ret;
+
+	ret = boottime->open_protocol(handle, &disk_io_protocol_guid,
+				      (void **)&disk_io, NULL, NULL,
+				      EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to open disk I/O protocol\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = boottime->open_protocol(handle, &block_io2_protocol_guid,
+				      (void **)&block_io2, NULL, NULL,
+				      EFI_OPEN_PROTOCOL_GET_PROTOCOL);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to open block I/O 2 protocol\n");
+		return EFI_ST_FAILURE;
+	}
+	io_completed = false;
+	ret = boottime->create_event(EVT_NOTIFY_SIGNAL, TPL_CALLBACK, notify,
+				     &io_completed, &event);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to create event\n");
+		return EFI_ST_FAILURE;
+	}
+
+	token.event = event;
+	token.transaction_status = EFI_NOT_READY;
+	ret = block_io2->read_blocks_ex(block_io2, block_io2->media->media_id,
+					0, &token, sizeof(sectors), sectors);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("ReadBlocksEx failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (!io_completed || token.transaction_status != EFI_SUCCESS) {
+		efi_st_error("ReadBlocksEx did not complete\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = boottime->close_event(event);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to close event\n");
+		return EFI_ST_FAILURE;
+	}
+	if (sectors[510] != 0x55 || sectors[511] != 0xaa) {
+		efi_st_error("Boot sector signature not found\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* Unaligned read crossing a block boundary */
+	ret = disk_io->read_disk(disk_io, block_io2->media->media_id, 507,
+				 sizeof(bytes), bytes);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("ReadDisk failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (efi_st_memcmp(bytes, sectors + 507, sizeof(bytes))) {
+		efi_st_error("ReadDisk returned unexpected data\n");
+		return EFI_ST_FAILURE;
+	}
+
+	return EFI_ST_SUCCESS;
+}
+
 /*
  * Execute unit test.
  *
@@ -383,7 +477,7 @@ static int execute(void)
 		return EFI_ST_FAILURE;
 	}
 
-	return EFI_ST_SUCCESS;
+	return check_disk_io(handle_partition);
 }
 
 EFI_UNIT_TEST(blkdev) = {
@@ -0,0 +1,168 @@
+/*
+ * efi_selftest_memory
+ *
+ * SPDX-License-Identifier:     GPL-2.0+
+ *
+ * This unit test checks the AllocatePool and FreePool boot services.
+ * Many small pool allocations must not overlap, must be 8 byte aligned,
+ * and must not grow the memory map by one entry each. Reserved memory
+ * types are rejected.
+ */
+
+#include <efi_selftest.h>
+
+#define NUM_ALLOCATIONS 256
+
+static struct efi_boot_services *boottime;
+static u8 *buffers[NUM_ALLOCATIONS];
+
+/*
+ * Get the number of entries in the memory map.
+ *
+ * @count:	number of memory descriptors
+ * @return:	status code
+ */
+static efi_status_t memory_map_entries(efi_uintn_t *count)
+{
+	efi_uintn_t map_size = 0, map_key;
+	efi_uintn_t desc_size = sizeof(struct efi_mem_desc);
+	u32 desc_version;
+	efi_status_t ret;
+
+	ret = boottime->get_memory_map(&map_size, NULL, &map_key, &desc_size,
+				       &desc_version);
+	if (ret != EFI_BUFFER_TOO_SMALL)
+		return ret;
+	*count = map_size / desc_size;
+	return EFI_SUCCESS;
+}
+
+/*
+ * Size of the n-th test allocation, a mix of tiny, medium and
+ * multi-page requests.
+ *
+ * @n:		number of the allocation
+ * @return:	size in bytes
+ */
+static efi_uintn_t allocation_size(unsigned int n)
+{
+	if (n % 64 == 63)
+		return 5000 + n;
+	return 1 + (n * 37) % 2048;
+}
+
+/*
+ * Setup unit test.
+ *
+ * @handle:	handle of the loaded image
+ * @systable:	system table
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int setup(const efi_handle_t handle,
+		 const struct efi_system_table *systable)
+{
+	boottime = systable->boottime;
+
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Tear down unit test.
+ *
+ * Free any buffers left over by a failed test.
+ *
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int teardown(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < NUM_ALLOCATIONS; i++) {
+		if (buffers[i])
+			boottime->free_pool(buffers[i]);
+		buffers[i] = NULL;
+	}
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Execute unit test.
+ *
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int execute(void)
+{
+	efi_uintn_t entries_before, entries_after, size, j;
+	efi_status_t ret;
+	unsigned int i;
+
+	ret = boottime->allocate_pool(EFI_MAX_MEMORY_TYPE, 16,
+				      (void **)&buffers[0]);
+	if (ret != EFI_INVALID_PARAMETER) {
+		efi_st_error("AllocatePool accepted a reserved memory type\n");
+		return EFI_ST_FAILURE;
+	}
+
+	ret = memory_map_entries(&entries_before);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("GetMemoryMap failed\n");
+		return EFI_ST_FAILURE;
+	}
+
+	for (i = 0; i < NUM_ALLOCATIONS; i++) {
+		size = allocation_size(i);
+		ret = boottime->allocate_pool(EFI_LOADER_DATA, size,
+					      (void **)&buffers[i]);
+		if (ret != EFI_SUCCESS) {
+			efi_st_error("AllocatePool failed\n");
+			return EFI_ST_FAILURE;
+		}
+		if ((uintptr_t)buffers[i] & 7) {
+			efi_st_error("Pool allocation is not 8 byte aligned\n");
+			return EFI_ST_FAILURE;
+		}
+		for (j = 0; j < size; j++)
+			buffers[i][j] = i;
+	}
+
+	/* Overlapping allocations would have overwritten each other */
+	for (i = 0; i < NUM_ALLOCATIONS; i++) {
+		size = allocation_size(i);
+		for (j = 0; j < size; j++) {
+			if (buffers[i][j] != (u8)i) {
+				efi_st_error("Pool allocations overlap\n");
+				return EFI_ST_FAILURE;
+			}
+		}
+	}
+
+	ret = memory_map_entries(&entries_after);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("GetMemoryMap failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (entries_after - entries_before >= NUM_ALLOCATIONS / 4) {
+		efi_st_error("Pool allocations grew the memory map by %u entries\n",
+			     (unsigned int)(entries_after - entries_before));
+		return EFI_ST_FAILURE;
+	}
+
+	for (i = 0; i < NUM_ALLOCATIONS; i++) {
+		ret = boottime->free_pool(buffers[i]);
+		if (ret != EFI_SUCCESS) {
+			efi_st_error("FreePool failed\n");
+			return EFI_ST_FAILURE;
+		}
+		buffers[i] = NULL;
+	}
+
+	return EFI_ST_SUCCESS;
+}
+
+EFI_UNIT_TEST(memory) = {
+	.name = "pool allocation",
+	.phase = EFI_EXECUTE_BEFORE_BOOTTIME_EXIT,
+	.setup = setup,
+	.execute = execute,
+	.teardown = teardown,
+};
@@ -0,0 +1,164 @@
+/*
+ * efi_selftest_memorymap
+ *
+ * SPDX-License-Identifier:     GPL-2.0+
+ *
+ * This unit test checks the memory map kept by the AllocatePages and
+ * FreePages boot services. Many single page allocations of alternating
+ * memory types must each show up in the map, a failed AllocatePages call
+ * must leave the map unchanged, and once all pages are freed again they
+ * must be merged back so that the map returns to its original size.
+ */
+
+#include <efi_selftest.h>
+
+#define NUM_PAGES 2000
+
+static struct efi_boot_services *boottime;
+static u64 pages[NUM_PAGES];
+
+/*
+ * Get the number of entries in the memory map.
+ *
+ * @count:	number of memory descriptors
+ * @return:	status code
+ */
+static efi_status_t memory_map_entries(efi_uintn_t *count)
+{
+	efi_uintn_t map_size = 0, map_key;
+	efi_uintn_t desc_size = sizeof(struct efi_mem_desc);
+	u32 desc_version;
+	efi_status_t ret;
+
+	ret = boottime->get_memory_map(&map_size, NULL, &map_key, &desc_size,
+				       &desc_version);
+	if (ret != EFI_BUFFER_TOO_SMALL)
+		return ret;
+	*count = map_size / desc_size;
+	return EFI_SUCCESS;
+}
+
+/*
+ * Setup unit test.
+ *
+ * @handle:	handle of the loaded image
+ * @systable:	system table
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int setup(const efi_handle_t handle,
+		 const struct efi_system_table *systable)
+{
+	boottime = systable->boottime;
+
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Tear down unit test.
+ *
+ * Free any pages left over by a failed test.
+ *
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int teardown(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < NUM_PAGES; i++) {
+		if (pages[i])
+			boottime->free_pages(pages[i], 1);
+		pages[i] = 0;
+	}
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Execute unit test.
+ *
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int execute(void)
+{
+	efi_uintn_t entries_before, entries, count;
+	efi_status_t ret;
+	unsigned int i, pass;
+	u64 addr;
+
+	ret = memory_map_entries(&entries_before);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("GetMemoryMap failed\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* Alternating memory types keep adjacent pages from being merged */
+	for (i = 0; i < NUM_PAGES; i++) {
+		ret = boottime->allocate_pages(EFI_ALLOCATE_ANY_PAGES,
+					       i & 1 ? EFI_LOADER_DATA :
+					       EFI_BOOT_SERVICES_DATA,
+					       1, &pages[i]);
+		if (ret != EFI_SUCCESS) {
+			efi_st_error("AllocatePages failed\n");
+			return EFI_ST_FAILURE;
+		}
+	}
+
+	ret = memory_map_entries(&entries);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("GetMemoryMap failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (entries < entries_before + NUM_PAGES / 2) {
+		efi_st_error("Only %u memory map entries for %u pages\n",
+			     (unsigned int)entries, NUM_PAGES);
+		return EFI_ST_FAILURE;
+	}
+
+	/* Allocating pages which are in use must fail and change nothing */
+	addr = pages[NUM_PAGES / 2] - EFI_PAGE_SIZE;
+	ret = boottime->allocate_pages(EFI_ALLOCATE_ADDRESS, EFI_LOADER_DATA,
+				       3, &addr);
+	if (ret == EFI_SUCCESS) {
+		efi_st_error("AllocatePages succeeded for used pages\n");
+		boottime->free_pages(addr, 3);
+		return EFI_ST_FAILURE;
+	}
+	ret = memory_map_entries(&count);
+	if (ret != EFI_SUCCESS || count != entries) {
+		efi_st_error("Failed AllocatePages changed the memory map\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* Free every other page first to fragment the map, then the rest */
+	for (pass = 0; pass < 2; pass++) {
+		for (i = pass; i < NUM_PAGES; i += 2) {
+			ret = boottime->free_pages(pages[i], 1);
+			if (ret != EFI_SUCCESS) {
+				efi_st_error("FreePages failed\n");
+				return EFI_ST_FAILURE;
+			}
+			pages[i] = 0;
+		}
+	}
+
+	ret = memory_map_entries(&entries);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("GetMemoryMap failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (entries != entries_before) {
+		efi_st_error("Memory map has %u entries, expected %u\n",
+			     (unsigned int)entries,
+			     (unsigned int)entries_before);
+		return EFI_ST_FAILURE;
+	}
+
+	return EFI_ST_SUCCESS;
+}
+
+EFI_UNIT_TEST(memorymap) = {
+	.name = "memory map",
+	.phase = EFI_EXECUTE_BEFORE_BOOTTIME_EXIT,
+	.setup = setup,
+	.execute = execute,
+	.teardown = teardown,
+};
@@ -102,6 +102,7 @@ static efi_status_t send_dhcp_discover(void)
 {
 	efi_status_t ret;
 	struct dhcp p = {};
+	void *txbuf;
 
 	/*
 	 * Fill ethernet header
@@ -160,10 +161,19 @@ static efi_status_t send_dhcp_discover(void)
 	 * Transmit DHCPDISCOVER message.
 	 */
 	ret = net->transmit(net, 0, sizeof(struct dhcp), &p, NULL, NULL, 0);
-	if (ret != EFI_SUCCESS)
+	if (ret != EFI_SUCCESS) {
 		efi_st_error("Sending a DHCP request failed\n");
-	else
-		efi_st_printf("DHCP Discover\n");
+		return ret;
+	}
+	efi_st_printf("DHCP Discover\n");
+	/*
+	 * The transmit buffer must be recycled before it goes out of scope.
+	 */
+	ret = net->get_status(net, NULL, &txbuf);
+	if (ret != EFI_SUCCESS || txbuf != &p) {
+		efi_st_error("Transmit buffer not recycled\n");
+		return EFI_DEVICE_ERROR;
+	}
 	return ret;
 }
 
@@ -245,6 +255,16 @@ static int setup(const efi_handle_t handle,
 		efi_st_error("Failed to start network adapter\n");
 		return EFI_ST_FAILURE;
 	}
+	/*
+	 * The DHCP offer is sent either to our MAC address or to all hosts.
+	 */
+	ret = net->receive_filters(net, EFI_SIMPLE_NETWORK_RECEIVE_UNICAST |
+				   EFI_SIMPLE_NETWORK_RECEIVE_BROADCAST,
+				   0, 0, 0, NULL);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to set receive filters\n");
+		return EFI_ST_FAILURE;
+	}
 	return EFI_ST_SUCCESS;
 }
 
@@ -0,0 +1,227 @@
+/*
+ * efi_selftest_variables
+ *
+ * SPDX-License-Identifier:     GPL-2.0+
+ *
+ * This unit test checks the GetVariable, SetVariable, GetNextVariableName
+ * and QueryVariableInfo runtime services.
+ */
+
+#include <efi_selftest.h>
+
+#define EFI_ST_MAX_DATA_SIZE 16
+#define EFI_ST_MAX_VARNAME_SIZE 40
+
+static struct efi_boot_services *boottime;
+static struct efi_runtime_services *runtime;
+static const efi_guid_t guid_vendor0 =
+	EFI_GUID(0x67029eb5, 0x0af2, 0xf6b1,
+		 0xda, 0x53, 0xfc, 0xb5, 0x66, 0xdd, 0x1c, 0xe6);
+static const efi_guid_t guid_vendor1 =
+	EFI_GUID(0xff629290, 0x1fc1, 0xd73f,
+		 0x8f, 0xb1, 0x32, 0xf9, 0x0c, 0xa0, 0x42, 0xea);
+
+/*
+ * Setup unit test.
+ *
+ * @handle:	handle of the loaded image
+ * @systable:	system table
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int setup(const efi_handle_t handle,
+		 const struct efi_system_table *systable)
+{
+	boottime = systable->boottime;
+	runtime = systable->runtime;
+
+	return EFI_ST_SUCCESS;
+}
+
+/*
+ * Check that a variable is reported by GetNextVariableName.
+ *
+ * @name:	name of the variable
+ * @vendor:	vendor GUID of the variable
+ * @return:	EFI_ST_SUCCESS if the variable is found
+ */
+static int find_variable(const u16 *name, const efi_guid_t *vendor)
+{
+	unsigned long size = EFI_ST_MAX_VARNAME_SIZE * sizeof(u16);
+	unsigned long len;
+	u16 *varname, *buf;
+	efi_guid_t guid;
+	efi_status_t ret;
+	int found = EFI_ST_FAILURE;
+
+	ret = boottime->allocate_pool(EFI_LOADER_DATA, size,
+				      (void **)&varname);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("AllocatePool failed\n");
+		return EFI_ST_FAILURE;
+	}
+	varname[0] = 0;
+	for (;;) {
+		len = size;
+		ret = runtime->get_next_variable(&len, (s16 *)varname, &guid);
+		if (ret == EFI_BUFFER_TOO_SMALL) {
+			/* Another variable has a longer name, grow the buffer */
+			ret = boottime->allocate_pool(EFI_LOADER_DATA, len,
+						      (void **)&buf);
+			if (ret != EFI_SUCCESS) {
+				efi_st_error("AllocatePool failed\n");
+				break;
+			}
+			boottime->copy_mem(buf, varname, size);
+			boottime->free_pool(varname);
+			varname = buf;
+			size = len;
+			continue;
+		}
+		if (ret == EFI_NOT_FOUND)
+			break;
+		if (ret != EFI_SUCCESS) {
+			efi_st_error("GetNextVariableName failed\n");
+			break;
+		}
+		if (!efi_st_memcmp(&guid, vendor, sizeof(guid)) &&
+		    !efi_st_memcmp(varname, name, len)) {
+			found = EFI_ST_SUCCESS;
+			break;
+		}
+	}
+	boottime->free_pool(varname);
+
+	return found;
+}
+
+/*
+ * Execute unit test.
+ *
+ * @return:	EFI_ST_SUCCESS for success
+ */
+static int execute(void)
+{
+	u16 name0[] = L"efi_st_var0";
+	u16 name1[] = L"efi_st_var1";
+	u8 v[] = {0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7, 0x8, 0x9};
+	u8 data[EFI_ST_MAX_DATA_SIZE];
+	u64 max_storage, rem_storage, max_size, rem_before;
+	unsigned long len;
+	u32 attr;
+	efi_status_t ret;
+
+	ret = runtime->query_variable_info(EFI_VARIABLE_BOOTSERVICE_ACCESS,
+					   &max_storage, &rem_before,
+					   &max_size);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("QueryVariableInfo failed\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* Set and read back a variable */
+	ret = runtime->set_variable((s16 *)name0,
+				    (efi_guid_t *)&guid_vendor0,
+				    EFI_VARIABLE_BOOTSERVICE_ACCESS, 3, v + 4);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("SetVariable failed\n");
+		return EFI_ST_FAILURE;
+	}
+	len = 1;
+	ret = runtime->get_variable((s16 *)name0, (efi_guid_t *)&guid_vendor0,
+				    &attr, &len, data);
+	if (ret != EFI_BUFFER_TOO_SMALL || len != 3) {
+		efi_st_error("GetVariable did not report the size\n");
+		return EFI_ST_FAILURE;
+	}
+	len = EFI_ST_MAX_DATA_SIZE;
+	ret = runtime->get_variable((s16 *)name0, (efi_guid_t *)&guid_vendor0,
+				    &attr, &len, data);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("GetVariable failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (len != 3 || efi_st_memcmp(data, v + 4, 3) ||
+	    attr != EFI_VARIABLE_BOOTSERVICE_ACCESS) {
+		efi_st_error("GetVariable returned wrong value\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* Append to a second variable */
+	ret = runtime->set_variable((s16 *)name1,
+				    (efi_guid_t *)&guid_vendor1,
+				    EFI_VARIABLE_BOOTSERVICE_ACCESS, 7, v);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("SetVariable failed\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = runtime->set_variable((s16 *)name1,
+				    (efi_guid_t *)&guid_vendor1,
+				    EFI_VARIABLE_BOOTSERVICE_ACCESS |
+				    EFI_VARIABLE_APPEND_WRITE, 2, v + 7);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("SetVariable(APPEND_WRITE) failed\n");
+		return EFI_ST_FAILURE;
+	}
+	len = EFI_ST_MAX_DATA_SIZE;
+	ret = runtime->get_variable((s16 *)name1, (efi_guid_t *)&guid_vendor1,
+				    &attr, &len, data);
+	if (ret != EFI_SUCCESS || len != 9 || efi_st_memcmp(data, v, 9)) {
+		efi_st_error("Appended value is wrong\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* Enumerate variables */
+	if (find_variable(name0, &guid_vendor0) != EFI_ST_SUCCESS ||
+	    find_variable(name1, &guid_vendor1) != EFI_ST_SUCCESS) {
+		efi_st_error("GetNextVariableName did not find variable\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* The variables use up storage */
+	ret = runtime->query_variable_info(EFI_VARIABLE_BOOTSERVICE_ACCESS,
+					   &max_storage, &rem_storage,
+					   &max_size);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("QueryVariableInfo failed\n");
+		return EFI_ST_FAILURE;
+	}
+	if (rem_storage + 12 + sizeof(name0) + sizeof(name1) != rem_before) {
+		efi_st_error("QueryVariableInfo reports wrong free space\n");
+		return EFI_ST_FAILURE;
+	}
+
+	/* Delete the variables */
+	ret = runtime->set_variable((s16 *)name0,
+				    (efi_guid_t *)&guid_vendor0,
+				    EFI_VARIABLE_BOOTSERVICE_ACCESS, 0, NULL);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to delete variable\n");
+		return EFI_ST_FAILURE;
+	}
+	ret = runtime->set_variable((s16 *)name1,
+				    (efi_guid_t *)&guid_vendor1, 0, 0, NULL);
+	if (ret != EFI_SUCCESS) {
+		efi_st_error("Failed to delete variable\n");
+		return EFI_ST_FAILURE;
+	}
+	len = EFI_ST_MAX_DATA_SIZE;
+	ret = runtime->get_variable((s16 *)name0, (efi_guid_t *)&guid_vendor0,
+				    &attr, &len, data);
+	if (ret != EFI_NOT_FOUND) {
+		efi_st_error("Deleted variable still exists\n");
+		return EFI_ST_FAILURE;
+	}
+	if (find_variable(name1, &guid_vendor1) == EFI_ST_SUCCESS) {
+		efi_st_error("Deleted variable is still enumerated\n");
+		return EFI_ST_FAILURE;
+	}
+
+	return EFI_ST_SUCCESS;
+}
+
+EFI_UNIT_TEST(variables) = {
+	.name = "variables",
+	.phase = EFI_EXECUTE_BEFORE_BOOTTIME_EXIT,
+	.setup = setup,
+	.execute = execute,
+};
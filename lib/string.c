@@ -476,11 +476,23 @@ void * memset(void * s,int c,size_t count)
 	int i;
 
 	/* do it one word at a time (32 bits or 64 bits) while possible */
-	if ( ((ulong)s & (sizeof(*sl) - 1)) == 0) {
+	if (count >= sizeof(*sl)) {
+		/* fill bytes up to a word boundary first */
+		for (s8 = s; (ulong)s8 & (sizeof(*sl) - 1); count--)
+			*s8++ = c;
+		sl = (unsigned long *)s8;
 		for (i = 0; i < sizeof(*sl); i++) {
 			cl <<= 8;
 			cl |= c & 0xff;
 		}
+		while (count >= 4 * sizeof(*sl)) {
+			sl[0] = cl;
+			sl[1] = cl;
+			sl[2] = cl;
+			sl[3] = cl;
+			sl += 4;
+			count -= 4 * sizeof(*sl);
+		}
 		while (count >= sizeof(*sl)) {
 			*sl++ = cl;
 			count -= sizeof(*sl);
@@ -513,8 +525,26 @@ void * memcpy(void *dest, const void *src, size_t count)
 	if (src == dest)
 		return dest;
 
-	/* while all data is aligned (common case), copy a word at a time */
-	if ( (((ulong)dest | (ulong)src) & (sizeof(*dl) - 1)) == 0) {
+	/*
+	 * while all data is aligned (common case), copy a word at a time;
+	 * areas equally misaligned are aligned by copying bytes first
+	 */
+	if ((((ulong)dest ^ (ulong)src) & (sizeof(*dl) - 1)) == 0) {
+		d8 = (char *)dest;
+		s8 = (char *)src;
+		for (; count && ((ulong)d8 & (sizeof(*dl) - 1)); count--)
+			*d8++ = *s8++;
+		dl = (unsigned long *)d8;
+		sl = (unsigned long *)s8;
+		while (count >= 4 * sizeof(*dl)) {
+			dl[0] = sl[0];
+			dl[1] = sl[1];
+			dl[2] = sl[2];
+			dl[3] = sl[3];
+			dl += 4;
+			sl += 4;
+			count -= 4 * sizeof(*dl);
+		}
 		while (count >= sizeof(*dl)) {
 			*dl++ = *sl++;
 			count -= sizeof(*dl);
@@ -548,6 +578,18 @@ void * memmove(void * dest,const void *src,size_t count)
 	} else {
 		tmp = (char *) dest + count;
 		s = (char *) src + count;
+		/* copy words from the end if the ends are equally aligned */
+		if ((((ulong)tmp ^ (ulong)s) & (sizeof(long) - 1)) == 0) {
+			while (count && ((ulong)tmp & (sizeof(long) - 1))) {
+				*--tmp = *--s;
+				count--;
+			}
+			for (; count >= sizeof(long); count -= sizeof(long)) {
+				tmp -= sizeof(long);
+				s -= sizeof(long);
+				*(unsigned long *)tmp = *(unsigned long *)s;
+			}
+		}
 		while (count--)
 			*--tmp = *--s;
 		}
@@ -565,10 +607,28 @@ void * memmove(void * dest,const void *src,size_t count)
  */
 int memcmp(const void * cs,const void * ct,size_t count)
 {
-	const unsigned char *su1, *su2;
+	const unsigned char *su1 = cs, *su2 = ct;
+	const unsigned long *ul1, *ul2;
 	int res = 0;
 
-	for( su1 = cs, su2 = ct; 0 < count; ++su1, ++su2, count--)
+	/* skip equal words if both areas can be word aligned */
+	if ((((ulong)cs ^ (ulong)ct) & (sizeof(*ul1) - 1)) == 0) {
+		for (; count && ((ulong)su1 & (sizeof(*ul1) - 1)); count--) {
+			if ((res = *su1++ - *su2++) != 0)
+				return res;
+		}
+		ul1 = (const unsigned long *)su1;
+		ul2 = (const unsigned long *)su2;
+		while (count >= sizeof(*ul1) && *ul1 == *ul2) {
+			ul1++;
+			ul2++;
+			count -= sizeof(*ul1);
+		}
+		su1 = (const unsigned char *)ul1;
+		su2 = (const unsigned char *)ul2;
+	}
+
+	for (; 0 < count; ++su1, ++su2, count--)
 		if ((res = *su1 - *su2) != 0)
 			break;
 	return res;
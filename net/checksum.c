@@ -13,25 +13,46 @@
 
 unsigned compute_ip_checksum(const void *vptr, unsigned nbytes)
 {
-	int sum, oddbyte;
-	const unsigned short *ptr = vptr;
+	const u8 *ptr = vptr;
+	const u32 *wide;
+	u64 sum = 0;
+	u32 oddbyte;
 
-	sum = 0;
+	/*
+	 * The ones' complement sum of 16-bit words can be built from wider
+	 * words and folded at the end, whatever the byte order. Use aligned
+	 * 32-bit loads, four at a time, adding into 64 bits so that the
+	 * carries are not lost.
+	 */
+	if (!((uintptr_t)ptr & 1)) {
+		if (((uintptr_t)ptr & 2) && nbytes > 1) {
+			sum += *(const u16 *)ptr;
+			ptr += 2;
+			nbytes -= 2;
+		}
+		wide = (const u32 *)ptr;
+		for (; nbytes >= 16; nbytes -= 16, wide += 4)
+			sum += (u64)wide[0] + wide[1] + wide[2] + wide[3];
+		for (; nbytes >= 4; nbytes -= 4)
+			sum += *wide++;
+		ptr = (const u8 *)wide;
+	}
 	while (nbytes > 1) {
-		sum += *ptr++;
+		sum += *(const u16 *)ptr;
+		ptr += 2;
 		nbytes -= 2;
 	}
 	if (nbytes == 1) {
 		oddbyte = 0;
-		((u8 *)&oddbyte)[0] = *(u8 *)ptr;
-		((u8 *)&oddbyte)[1] = 0;
+		((u8 *)&oddbyte)[0] = *ptr;
 		sum += oddbyte;
 	}
+	sum = (sum >> 32) + (sum & 0xffffffff);
+	sum = (sum >> 16) + (sum & 0xffff);
 	sum = (sum >> 16) + (sum & 0xffff);
 	sum += (sum >> 16);
-	sum = ~sum & 0xffff;
 
-	return sum;
+	return ~sum & 0xffff;
 }
 
 unsigned add_ip_checksums(unsigned offset, unsigned sum, unsigned new)
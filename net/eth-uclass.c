@@ -16,13 +16,18 @@
 
 DECLARE_GLOBAL_DATA_PTR;
 
+/* Maximum number of packets processed by a single call to eth_rx() */
+#define ETH_RX_BUDGET	32
+
 /**
  * struct eth_device_priv - private structure for each Ethernet device
  *
  * @state: The state of the Ethernet MAC driver (defined by enum eth_state_t)
+ * @stats: Traffic counters for this device
  */
 struct eth_device_priv {
 	enum eth_state_t state;
+	struct eth_stats stats;
 };
 
 /**
@@ -330,6 +335,7 @@ int eth_is_active(struct udevice *dev)
 int eth_send(void *packet, int length)
 {
 	struct udevice *current;
+	struct eth_stats *stats;
 	int ret;
 
 	current = eth_get_dev();
@@ -339,14 +345,98 @@ int eth_send(void *packet, int length)
 	if (!eth_is_active(current))
 		return -EINVAL;
 
+	stats = eth_get_stats(current);
 	ret = eth_get_ops(current)->send(current, packet, length);
 	if (ret < 0) {
+		stats->tx_errors++;
 		/* We cannot completely return the error at present */
 		debug("%s: send() returned error %d\n", __func__, ret);
+	} else {
+		stats->tx_packets++;
+		stats->tx_bytes += length;
 	}
 	return ret;
 }
 
+struct eth_stats *eth_get_stats(struct udevice *dev)
+{
+	struct eth_device_priv *priv = dev_get_uclass_priv(dev);
+
+	return priv ? &priv->stats : NULL;
+}
+
+void eth_reset_stats(struct udevice *dev)
+{
+	struct eth_stats *stats = eth_get_stats(dev);
+
+	if (stats)
+		memset(stats, '\0', sizeof(*stats));
+}
+
+/* Check whether the driver handed us one of the stack's own buffers */
+static bool eth_is_bounce_buffer(uchar *packet)
+{
+	return packet >= net_rx_packets[0] &&
+	       packet < net_rx_packets[PKTBUFSRX - 1] + PKTSIZE_ALIGN;
+}
+
+int eth_get_csum_offload(void)
+{
+	struct eth_pdata *pdata;
+
+	if (!eth_get_dev())
+		return 0;
+	pdata = eth_get_dev()->platdata;
+
+	return pdata->csum_offload;
+}
+
+/* Hand one received packet to the network stack and give it back */
+static void eth_process_packet(struct udevice *dev, uchar *packet, int length,
+			       int flags)
+{
+	struct eth_pdata *pdata = dev->platdata;
+	struct eth_stats *stats = eth_get_stats(dev);
+	bool csum_ok;
+
+	if (length > 0) {
+		stats->rx_packets++;
+		stats->rx_bytes += length;
+		if (eth_is_bounce_buffer(packet))
+			stats->rx_copies++;
+		csum_ok = (pdata->csum_offload & ETH_CSUM_RX) &&
+			  (flags & ETH_RX_CSUM_OK);
+		net_process_received_packet_csum(packet, length, csum_ok);
+	} else if (length < 0) {
+		stats->rx_dropped++;
+	}
+	if (eth_get_ops(dev)->free_pkt)
+		eth_get_ops(dev)->free_pkt(dev, packet, length);
+}
+
+static int eth_rx_batch(struct udevice *dev)
+{
+	struct eth_rx_desc descs[ETH_RX_BUDGET];
+	int flags = ETH_RECV_CHECK_DEVICE;
+	int done = 0;
+	int ret;
+	int i;
+
+	while (done < ETH_RX_BUDGET) {
+		ret = eth_get_ops(dev)->recv_batch(dev, flags, descs,
+						   ETH_RX_BUDGET - done);
+		flags = 0;
+		if (ret <= 0)
+			return ret;
+		for (i = 0; i < ret; i++)
+			eth_process_packet(dev, descs[i].packet,
+					   descs[i].length, descs[i].flags);
+		done += ret;
+	}
+
+	return 0;
+}
+
 int eth_rx(void)
 {
 	struct udevice *current;
@@ -362,21 +452,25 @@ int eth_rx(void)
 	if (!eth_is_active(current))
 		return -EINVAL;
 
-	/* Process up to 32 packets at one time */
-	flags = ETH_RECV_CHECK_DEVICE;
-	for (i = 0; i < 32; i++) {
-		ret = eth_get_ops(current)->recv(current, flags, &packet);
-		flags = 0;
-		if (ret > 0)
-			net_process_received_packet(packet, ret);
-		if (ret >= 0 && eth_get_ops(current)->free_pkt)
-			eth_get_ops(current)->free_pkt(current, packet, ret);
-		if (ret <= 0)
-			break;
+	if (eth_get_ops(current)->recv_batch) {
+		ret = eth_rx_batch(current);
+	} else {
+		/* Process up to ETH_RX_BUDGET packets at one time */
+		flags = ETH_RECV_CHECK_DEVICE;
+		for (i = 0; i < ETH_RX_BUDGET; i++) {
+			ret = eth_get_ops(current)->recv(current, flags,
+							 &packet);
+			flags = 0;
+			if (ret >= 0)
+				eth_process_packet(current, packet, ret, 0);
+			if (ret <= 0)
+				break;
+		}
 	}
 	if (ret == -EAGAIN)
 		ret = 0;
 	if (ret < 0) {
+		eth_get_stats(current)->rx_errors++;
 		/* We cannot completely return the error at present */
 		debug("%s: recv() returned error %d\n", __func__, ret);
 	}
@@ -472,6 +566,8 @@ static int eth_post_probe(struct udevice *dev)
 			ops->send += gd->reloc_off;
 		if (ops->recv)
 			ops->recv += gd->reloc_off;
+		if (ops->recv_batch)
+			ops->recv_batch += gd->reloc_off;
 		if (ops->free_pkt)
 			ops->free_pkt += gd->reloc_off;
 		if (ops->stop)
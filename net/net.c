@@ -1026,7 +1026,39 @@ static void receive_icmp(struct ip_udp_hdr *ip, int len,
 	}
 }
 
+#ifdef CONFIG_UDP_CHECKSUM
+/* Check the UDP checksum of a received packet, which must not be 0 */
+static bool udp_checksum_ok(struct ip_udp_hdr *ip)
+{
+	u16 pseudo[2] = { htons(ip->ip_p), ip->udp_len };
+	unsigned int sum;
+
+	/* The pseudo header holds the addresses, protocol and UDP length */
+	sum = compute_ip_checksum((uchar *)ip +
+				  offsetof(struct ip_udp_hdr, ip_src),
+				  2 * sizeof(struct in_addr));
+	sum = add_ip_checksums(0, sum,
+			       compute_ip_checksum(pseudo, sizeof(pseudo)));
+	sum = add_ip_checksums(0, sum,
+			       compute_ip_checksum((uchar *)ip + IP_HDR_SIZE,
+						   ntohs(ip->udp_len)));
+	if (sum != 0 && sum != 0xffff) {
+		printf(" UDP wrong checksum %04x %04x\n", sum,
+		       ntohs(ip->udp_xsum));
+		return false;
+	}
+
+	return true;
+}
+#endif
+
 void net_process_received_packet(uchar *in_packet, int len)
+{
+	net_process_received_packet_csum(in_packet, len, false);
+}
+
+void net_process_received_packet_csum(uchar *in_packet, int len,
+				      bool csum_ok)
 {
 	struct ethernet_hdr *et;
 	struct ip_udp_hdr *ip;
@@ -1161,7 +1193,7 @@ void net_process_received_packet(uchar *in_packet, int len)
 		if ((ip->ip_hl_v & 0x0f) > 0x05)
 			return;
 		/* Check the Checksum of the header */
-		if (!ip_checksum_ok((uchar *)ip, IP_HDR_SIZE)) {
+		if (!csum_ok && !ip_checksum_ok((uchar *)ip, IP_HDR_SIZE)) {
 			debug("checksum bad\n");
 			return;
 		}
@@ -1217,45 +1249,8 @@ void net_process_received_packet(uchar *in_packet, int len)
 			   &dst_ip, &src_ip, len);
 
 #ifdef CONFIG_UDP_CHECKSUM
-		if (ip->udp_xsum != 0) {
-			ulong   xsum;
-			ushort *sumptr;
-			ushort  sumlen;
-
-			xsum  = ip->ip_p;
-			xsum += (ntohs(ip->udp_len));
-			xsum += (ntohl(ip->ip_src.s_addr) >> 16) & 0x0000ffff;
-			xsum += (ntohl(ip->ip_src.s_addr) >>  0) & 0x0000ffff;
-			xsum += (ntohl(ip->ip_dst.s_addr) >> 16) & 0x0000ffff;
-			xsum += (ntohl(ip->ip_dst.s_addr) >>  0) & 0x0000ffff;
-
-			sumlen = ntohs(ip->udp_len);
-			sumptr = (ushort *)&(ip->udp_src);
-
-			while (sumlen > 1) {
-				ushort sumdata;
-
-				sumdata = *sumptr++;
-				xsum += ntohs(sumdata);
-				sumlen -= 2;
-			}
-			if (sumlen > 0) {
-				ushort sumdata;
-
-				sumdata = *(unsigned char *)sumptr;
-				sumdata = (sumdata << 8) & 0xff00;
-				xsum += sumdata;
-			}
-			while ((xsum >> 16) != 0) {
-				xsum = (xsum & 0x0000ffff) +
-				       ((xsum >> 16) & 0x0000ffff);
-			}
-			if ((xsum != 0x00000000) && (xsum != 0x0000ffff)) {
-				printf(" UDP wrong checksum %08lx %08x\n",
-				       xsum, ntohs(ip->udp_xsum));
-				return;
-			}
-		}
+		if (!csum_ok && ip->udp_xsum != 0 && !udp_checksum_ok(ip))
+			return;
 #endif
 
 #if defined(CONFIG_NETCONSOLE) && !defined(CONFIG_SPL_BUILD)
@@ -1463,7 +1458,8 @@ void net_set_udp_header(uchar *pkt, struct in_addr dest, int dport, int sport,
 	net_set_ip_header(pkt, dest, net_ip);
 	ip->ip_len   = htons(IP_UDP_HDR_SIZE + len);
 	ip->ip_p     = IPPROTO_UDP;
-	ip->ip_sum   = compute_ip_checksum(ip, IP_HDR_SIZE);
+	if (!(eth_get_csum_offload() & ETH_CSUM_TX))
+		ip->ip_sum = compute_ip_checksum(ip, IP_HDR_SIZE);
 
 	ip->udp_src  = htons(sport);
 	ip->udp_dst  = htons(dport);
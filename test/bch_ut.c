@@ -0,0 +1,162 @@
+/*
+ * Test and benchmark for the software BCH decoder
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <errno.h>
+#include <malloc.h>
+#include <linux/bch.h>
+
+/* Pages decoded for each number of errors */
+#define BCH_UT_RUNS		1000
+
+/* Typical software ECC set-ups of SLC and MLC NAND */
+static const struct {
+	int m;
+	int t;
+	unsigned int len;
+} bch_ut_codes[] = {
+	{ 13, 4, 512 },
+	{ 13, 8, 512 },
+	{ 14, 16, 1024 },
+};
+
+static u32 bch_ut_seed;
+
+/* xorshift, so that every run sees the same data and errors */
+static u32 bch_ut_rand(void)
+{
+	bch_ut_seed ^= bch_ut_seed << 13;
+	bch_ut_seed ^= bch_ut_seed >> 17;
+	bch_ut_seed ^= bch_ut_seed << 5;
+
+	return bch_ut_seed;
+}
+
+/* Flip bit @pos of the data followed by the ecc, as decode_bch() counts */
+static void bch_ut_flip(u8 *data, unsigned int len, u8 *ecc, unsigned int pos)
+{
+	if (pos < 8 * len)
+		data[pos / 8] ^= 1 << (pos % 8);
+	else
+		ecc[(pos - 8 * len) / 8] ^= 1 << (pos % 8);
+}
+
+/* Inject @nerr errors at distinct positions */
+static void bch_ut_inject(struct bch_control *bch, u8 *data, unsigned int len,
+			  u8 *ecc, unsigned int *pos, int nerr)
+{
+	unsigned int nbits = 8 * len + bch->ecc_bits;
+	unsigned int bit;
+	int i, j;
+
+	for (i = 0; i < nerr; i++) {
+		do {
+			pos[i] = bch_ut_rand() % nbits;
+			/* skip the padding bits in the last ecc byte */
+			bit = pos[i] - 8 * len;
+			if (pos[i] >= 8 * len &&
+			    (bit & ~7) + 7 - (bit & 7) >= bch->ecc_bits)
+				pos[i] = nbits;
+			for (j = 0; j < i; j++) {
+				if (pos[j] == pos[i])
+					pos[i] = nbits;
+			}
+		} while (pos[i] == nbits);
+		bch_ut_flip(data, len, ecc, pos[i]);
+	}
+}
+
+static int bch_ut_code(int m, int t, unsigned int len)
+{
+	struct bch_control *bch;
+	u8 *data, *ecc, *page, *page_ecc;
+	unsigned int *pos, *errloc;
+	ulong start, us;
+	int nerr, run, i, count;
+	int ret = 0;
+
+	bch = init_bch(m, t, 0);
+	if (!bch) {
+		printf("%s: cannot set up m=%d t=%d\n", __func__, m, t);
+		return -ENOMEM;
+	}
+	data = malloc(len);
+	page = malloc(len);
+	ecc = calloc(1, bch->ecc_bytes);
+	page_ecc = malloc(bch->ecc_bytes);
+	pos = calloc(t, sizeof(*pos));
+	errloc = calloc(t, sizeof(*errloc));
+	if (!data || !page || !ecc || !page_ecc || !pos || !errloc) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < len; i++)
+		data[i] = bch_ut_rand();
+	encode_bch(bch, data, len, ecc);
+
+	printf("m=%d t=%d, %u-byte pages, us per page:", m, t, len);
+	for (nerr = 0; nerr <= t; nerr++) {
+		us = 0;
+		for (run = 0; run < BCH_UT_RUNS; run++) {
+			memcpy(page, data, len);
+			memcpy(page_ecc, ecc, bch->ecc_bytes);
+			bch_ut_inject(bch, page, len, page_ecc, pos, nerr);
+
+			start = timer_get_us();
+			count = decode_bch(bch, page, len, page_ecc, NULL,
+					   NULL, errloc);
+			us += timer_get_us() - start;
+
+			if (count != nerr) {
+				printf("\n%s: found %d of %d errors\n",
+				       __func__, count, nerr);
+				ret = -EINVAL;
+				break;
+			}
+			for (i = 0; i < count; i++)
+				bch_ut_flip(page, len, page_ecc, errloc[i]);
+			if (memcmp(page, data, len) ||
+			    memcmp(page_ecc, ecc, bch->ecc_bytes)) {
+				printf("\n%s: wrong correction of %d errors\n",
+				       __func__, nerr);
+				ret = -EINVAL;
+				break;
+			}
+		}
+		if (ret)
+			break;
+		printf(" %d:%lu.%lu", nerr, us / BCH_UT_RUNS,
+		       us * 10 / BCH_UT_RUNS % 10);
+	}
+	printf("\n");
+
+out:
+	free(errloc);
+	free(pos);
+	free(page_ecc);
+	free(ecc);
+	free(page);
+	free(data);
+	free_bch(bch);
+
+	return ret;
+}
+
+int do_ut_bch(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	int i, ret = 0;
+
+	bch_ut_seed = 2463534242U;
+	for (i = 0; i < ARRAY_SIZE(bch_ut_codes) && !ret; i++)
+		ret = bch_ut_code(bch_ut_codes[i].m, bch_ut_codes[i].t,
+				  bch_ut_codes[i].len);
+
+	printf("Test %s\n", ret ? "failed" : "passed");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
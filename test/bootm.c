@@ -0,0 +1,211 @@
+/*
+ * Tests for placing boot image components with bootm
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <console.h>
+#include <image.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <membuff.h>
+#include <linux/libfdt.h>
+#include <test/suites.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define BOOTM_TEST(_name, _flags)	UNIT_TEST(_name, _flags, bootm_test)
+
+/* Where the test image is built, and the size of the kernel and ramdisk */
+#define BOOTM_TEST_ADDR		0x100000
+#define BOOTM_TEST_SIZE		0x8000
+#define BOOTM_TEST_KERNEL_SIZE	0x100
+#define BOOTM_TEST_RD_SIZE	0x3000
+
+static void bootm_test_image_node(void *fit, const char *name,
+				  const char *type, const void *data, int size)
+{
+	fdt_begin_node(fit, name);
+	fdt_property_string(fit, FIT_DESC_PROP, name);
+	fdt_property(fit, FIT_DATA_PROP, data, size);
+	fdt_property_string(fit, FIT_TYPE_PROP, type);
+	fdt_property_string(fit, FIT_ARCH_PROP, "sandbox");
+	fdt_property_string(fit, FIT_OS_PROP, "linux");
+	fdt_property_string(fit, FIT_COMP_PROP, "none");
+	if (!strcmp(type, "kernel")) {
+		/* Filled in once the kernel data has its final address */
+		fdt_property_u32(fit, FIT_LOAD_PROP, 0);
+		fdt_property_u32(fit, FIT_ENTRY_PROP, 0);
+	}
+	fdt_end_node(fit);
+}
+
+/*
+ * Build a FIT holding a kernel, which runs in place, and a ramdisk. The
+ * FIT is put where the ramdisk data is @rd_offset bytes above a 4 KiB
+ * boundary.
+ *
+ * @rd_offset:	offset of the ramdisk data from a 4 KiB boundary
+ * @return address of the FIT, 0 on error
+ */
+static ulong bootm_test_make_image(ulong rd_offset)
+{
+	u8 kernel[BOOTM_TEST_KERNEL_SIZE], *rd, *buf;
+	const void *data;
+	ulong addr, load;
+	void *fit;
+	size_t size;
+	int node, i;
+
+	buf = malloc(BOOTM_TEST_SIZE);
+	rd = malloc(BOOTM_TEST_RD_SIZE);
+	if (!buf || !rd)
+		return 0;
+	memset(kernel, 0xaa, sizeof(kernel));
+	for (i = 0; i < BOOTM_TEST_RD_SIZE; i++)
+		rd[i] = i * 7;
+
+	fdt_create(buf, BOOTM_TEST_SIZE);
+	fdt_finish_reservemap(buf);
+	fdt_begin_node(buf, "");
+	fdt_property_string(buf, FIT_DESC_PROP, "bootm test");
+	fdt_property_u32(buf, FIT_TIMESTAMP_PROP, 0);
+	fdt_begin_node(buf, FIT_IMAGES_PATH + 1);
+	bootm_test_image_node(buf, "kernel@1", "kernel", kernel,
+			      sizeof(kernel));
+	bootm_test_image_node(buf, "ramdisk@1", "ramdisk", rd,
+			      BOOTM_TEST_RD_SIZE);
+	fdt_end_node(buf);
+	fdt_begin_node(buf, FIT_CONFS_PATH + 1);
+	fdt_property_string(buf, FIT_DEFAULT_PROP, "conf@1");
+	fdt_begin_node(buf, "conf@1");
+	fdt_property_string(buf, FIT_KERNEL_PROP, "kernel@1");
+	fdt_property_string(buf, FIT_RAMDISK_PROP, "ramdisk@1");
+	fdt_end_node(buf);
+	fdt_end_node(buf);
+	fdt_end_node(buf);
+	if (fdt_finish(buf))
+		return 0;
+	free(rd);
+
+	/* Move the FIT so that the ramdisk data has the requested offset */
+	node = fdt_path_offset(buf, FIT_IMAGES_PATH "/ramdisk@1");
+	fit_image_get_data(buf, node, &data, &size);
+	addr = BOOTM_TEST_ADDR + ((rd_offset - ((u8 *)data - buf)) & 0xfff);
+	fit = map_sysmem(addr, fdt_totalsize(buf));
+	memcpy(fit, buf, fdt_totalsize(buf));
+	free(buf);
+
+	/* Let the kernel run where it is, so that it is not copied */
+	node = fdt_path_offset(fit, FIT_IMAGES_PATH "/kernel@1");
+	fit_image_get_data(fit, node, &data, &size);
+	load = map_to_sysmem(data);
+	fdt_setprop_inplace_u32(fit, node, FIT_LOAD_PROP, load);
+	fdt_setprop_inplace_u32(fit, node, FIT_ENTRY_PROP, load);
+	unmap_sysmem(fit);
+
+	return addr;
+}
+
+/* Get the address of the ramdisk data in the FIT at @addr */
+static ulong bootm_test_ramdisk_addr(ulong addr)
+{
+	const void *data;
+	void *fit;
+	size_t size;
+	int node;
+
+	fit = map_sysmem(addr, 0);
+	node = fdt_path_offset(fit, FIT_IMAGES_PATH "/ramdisk@1");
+	fit_image_get_data(fit, node, &data, &size);
+	unmap_sysmem(fit);
+
+	return map_to_sysmem(data);
+}
+
+/* Check that the bootstage report shows the placement counts in @expect */
+static int bootm_test_check_report(struct unit_test_state *uts,
+				   const char *expect)
+{
+	char buf[CONFIG_CONSOLE_RECORD_OUT_SIZE];
+	int len;
+
+	console_record_reset_enable();
+	run_command("bootstage report", 0);
+	gd->flags &= ~GD_FLG_RECORD;
+	len = membuff_get(&gd->console_out, buf, sizeof(buf) - 1);
+	buf[len] = '\0';
+	ut_assertnonnull(strstr(buf, expect));
+
+	return 0;
+}
+
+/* Run bootm up to placing the ramdisk and check where it ended up */
+static int bootm_test_place_ramdisk(struct unit_test_state *uts,
+				    ulong rd_offset, bool in_place)
+{
+	ulong addr, rd, start, end;
+	char cmd[48];
+	u8 *buf;
+	int i;
+
+	addr = bootm_test_make_image(rd_offset);
+	ut_assert(addr);
+	rd = bootm_test_ramdisk_addr(addr);
+	ut_asserteq(rd_offset, rd & 0xfff);
+	env_set("initrd_high", NULL);
+	env_set("initrd_start", NULL);
+	env_set("initrd_end", NULL);
+
+	snprintf(cmd, sizeof(cmd), "bootm start %lx", addr);
+	ut_assertok(run_command(cmd, 0));
+	ut_assertok(run_command("bootm loados", 0));
+	ut_assertok(run_command("bootm ramdisk", 0));
+
+	start = env_get_hex("initrd_start", 0);
+	end = env_get_hex("initrd_end", 0);
+	ut_asserteq(in_place, start == rd);
+	ut_asserteq(0, start & 0xfff);
+	ut_asserteq(start + BOOTM_TEST_RD_SIZE, end);
+
+	buf = map_sysmem(start, BOOTM_TEST_RD_SIZE);
+	for (i = 0; i < BOOTM_TEST_RD_SIZE; i++)
+		ut_asserteq((u8)(i * 7), buf[i]);
+	unmap_sysmem(buf);
+
+	/* Only the ramdisk is placed, the kernel runs where it was loaded */
+	snprintf(cmd, sizeof(cmd), "bootm_place: %d in place, %d bytes moved",
+		 in_place ? 1 : 0, in_place ? 0 : BOOTM_TEST_RD_SIZE);
+	ut_assertok(bootm_test_check_report(uts, cmd));
+
+	env_set("initrd_start", NULL);
+	env_set("initrd_end", NULL);
+
+	return 0;
+}
+
+/* A ramdisk which is suitably aligned is used where it was loaded */
+static int bootm_test_ramdisk_in_place(struct unit_test_state *uts)
+{
+	return bootm_test_place_ramdisk(uts, 0, true);
+}
+BOOTM_TEST(bootm_test_ramdisk_in_place, 0);
+
+/* A misaligned ramdisk is copied to an aligned location */
+static int bootm_test_ramdisk_moved(struct unit_test_state *uts)
+{
+	return bootm_test_place_ramdisk(uts, 4, false);
+}
+BOOTM_TEST(bootm_test_ramdisk_moved, 0);
+
+int do_ut_bootm(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test, bootm_test);
+	const int n_ents = ll_entry_count(struct unit_test, bootm_test);
+
+	return cmd_ut_category("bootm", tests, n_ents, argc, argv);
+}
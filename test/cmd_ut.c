@@ -44,13 +44,28 @@ static cmd_tbl_t cmd_ut_sub[] = {
 #if defined(CONFIG_UT_ENV)
 	U_BOOT_CMD_MKENT(env, CONFIG_SYS_MAXARGS, 1, do_ut_env, "", ""),
 #endif
+#ifdef CONFIG_UT_LIB
+	U_BOOT_CMD_MKENT(lib, CONFIG_SYS_MAXARGS, 1, do_ut_lib, "", ""),
+#endif
 #ifdef CONFIG_UT_OVERLAY
 	U_BOOT_CMD_MKENT(overlay, CONFIG_SYS_MAXARGS, 1, do_ut_overlay, "", ""),
 #endif
 #ifdef CONFIG_UT_TIME
 	U_BOOT_CMD_MKENT(time, CONFIG_SYS_MAXARGS, 1, do_ut_time, "", ""),
 #endif
+#ifdef CONFIG_UT_HUSH_CACHE
+	U_BOOT_CMD_MKENT(hush_cache, CONFIG_SYS_MAXARGS, 1, do_ut_hush_cache,
+			 "", ""),
+#endif
+#ifdef CONFIG_UT_BCH
+	U_BOOT_CMD_MKENT(bch, CONFIG_SYS_MAXARGS, 1, do_ut_bch, "", ""),
+#endif
+#ifdef CONFIG_UT_FS_FILE
+	U_BOOT_CMD_MKENT(fs_file, CONFIG_SYS_MAXARGS, 1, do_ut_fs_file,
+			 "", ""),
+#endif
 #ifdef CONFIG_SANDBOX
+	U_BOOT_CMD_MKENT(bootm, CONFIG_SYS_MAXARGS, 1, do_ut_bootm, "", ""),
 	U_BOOT_CMD_MKENT(compression, CONFIG_SYS_MAXARGS, 1, do_ut_compression,
 			 "", ""),
 #endif
@@ -100,13 +115,26 @@ static char ut_help_text[] =
 #ifdef CONFIG_UT_ENV
 	"ut env [test-name]\n"
 #endif
+#ifdef CONFIG_UT_LIB
+	"ut lib [test-name]\n"
+#endif
 #ifdef CONFIG_UT_OVERLAY
 	"ut overlay [test-name]\n"
 #endif
 #ifdef CONFIG_UT_TIME
 	"ut time - Very basic test of time functions\n"
 #endif
+#ifdef CONFIG_UT_HUSH_CACHE
+	"ut hush_cache - Test and time cached parsing of hush scripts\n"
+#endif
+#ifdef CONFIG_UT_BCH
+	"ut bch - Test and time the software BCH decoder\n"
+#endif
+#ifdef CONFIG_UT_FS_FILE
+	"ut fs_file [test-name]\n"
+#endif
 #ifdef CONFIG_SANDBOX
+	"ut bootm - Test placing boot image components\n"
 	"ut compression - Test compressors and bootm decompression\n"
 #endif
 	;
@@ -52,6 +52,13 @@ static int do_ut_cmd(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
 	assert(!strcmp("2", env_get("adder")));
 #endif
 
+	/* exact, abbreviated, ambiguous and unknown command names */
+	assert(!strcmp(find_cmd("setenv")->name, "setenv"));
+	assert(!strcmp(find_cmd("setexp")->name, "setexpr"));
+	assert(!strcmp(find_cmd("md.b")->name, "md"));
+	assert(find_cmd("se") == NULL);
+	assert(find_cmd("setenvx") == NULL);
+
 	assert(run_command("", 0) == 0);
 	assert(run_command(" ", 0) == 0);
 
@@ -0,0 +1,168 @@
+/*
+ * Tests for operations which complete in the background
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <dm.h>
+#include <asm/test.h>
+#include <dm/async.h>
+#include <dm/device-internal.h>
+#include <dm/root.h>
+#include <dm/test.h>
+#include <test/ut.h>
+
+struct async_test {
+	struct dm_async op;
+	int polls;	/* Number of times the poll function was called */
+	int busy;	/* Number of polls before the operation finishes */
+	int result;	/* Result of the operation once finished */
+};
+
+static int async_test_poll(struct dm_async *op)
+{
+	struct async_test *test = container_of(op, struct async_test, op);
+
+	if (++test->polls <= test->busy) {
+		dm_async_delay(op, 0);
+		return -EAGAIN;
+	}
+
+	return test->result;
+}
+
+static void async_test_init(struct async_test *test, int busy, int result)
+{
+	memset(test, '\0', sizeof(*test));
+	test->busy = busy;
+	test->result = result;
+}
+
+/* Test that operations run alongside each other and report their result */
+static int dm_test_async_wait(struct unit_test_state *uts)
+{
+	struct async_test first, second;
+	struct udevice *dev;
+
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 0, &dev));
+	async_test_init(&first, 2, 0);
+	async_test_init(&second, 4, -EIO);
+
+	ut_assert(!dm_async_pending(&first.op));
+	ut_assertok(dm_async_start(&first.op, dev, "first", async_test_poll,
+				   0));
+	ut_assertok(dm_async_start(&second.op, dev, "second",
+				   async_test_poll, 0));
+	ut_assert(dm_async_pending(&first.op));
+	ut_asserteq(-EBUSY, dm_async_start(&first.op, dev, "first",
+					   async_test_poll, 0));
+	ut_asserteq(0, first.polls);
+
+	/* The second operation moves along while we wait for the first */
+	ut_assertok(dm_async_wait(&first.op));
+	ut_asserteq(3, first.polls);
+	ut_assert(dm_async_pending(&second.op));
+	ut_asserteq(2, second.polls);
+
+	ut_asserteq(-EIO, dm_async_wait(&second.op));
+	ut_asserteq(5, second.polls);
+
+	/* Waiting again just returns the result */
+	ut_assertok(dm_async_wait(&first.op));
+	ut_asserteq(3, first.polls);
+
+	return 0;
+}
+DM_TEST(dm_test_async_wait, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test that an operation is not polled before its deadline */
+static int dm_test_async_delay(struct unit_test_state *uts)
+{
+	struct async_test test;
+
+	async_test_init(&test, 0, 0);
+	ut_assertok(dm_async_start(&test.op, NULL, "delay", async_test_poll,
+				   1000));
+	dm_async_poll();
+	ut_asserteq(0, test.polls);
+	ut_assert(dm_async_pending(&test.op));
+
+	sandbox_timer_add_offset(1000);
+	dm_async_poll();
+	ut_asserteq(1, test.polls);
+	ut_assert(!dm_async_pending(&test.op));
+	ut_assertok(dm_async_wait(&test.op));
+
+	return 0;
+}
+DM_TEST(dm_test_async_delay, 0);
+
+/* Test that probing moves operations along and removal waits for them */
+static int dm_test_async_probe(struct unit_test_state *uts)
+{
+	struct async_test test;
+	struct udevice *dev;
+
+	ut_assertok(uclass_first_device_err(UCLASS_TEST_FDT, &dev));
+	async_test_init(&test, 5, 0);
+	ut_assertok(dm_async_start(&test.op, dev, "probe", async_test_poll,
+				   0));
+
+	/* Probing another device polls, probing an active one does not */
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 1, &dev));
+	ut_asserteq(1, test.polls);
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 1, &dev));
+	ut_asserteq(1, test.polls);
+
+	/* The operation is finished, not cancelled, before removal */
+	ut_assertok(dm_remove_devices_flags(DM_REMOVE_ACTIVE_ALL));
+	ut_assert(!dm_async_pending(&test.op));
+	ut_assertok(dm_async_wait(&test.op));
+	ut_asserteq(6, test.polls);
+
+	return 0;
+}
+DM_TEST(dm_test_async_probe, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Test cancelling operations, directly and by removing the device */
+static int dm_test_async_cancel(struct unit_test_state *uts)
+{
+	struct async_test first, second, other;
+	struct udevice *dev;
+
+	ut_assertok(uclass_get_device(UCLASS_TEST_FDT, 0, &dev));
+	async_test_init(&first, 10, 0);
+	async_test_init(&second, 10, 0);
+	async_test_init(&other, 1, 0);
+	ut_assertok(dm_async_start(&first.op, dev, "first", async_test_poll,
+				   0));
+	ut_assertok(dm_async_start(&second.op, dev, "second",
+				   async_test_poll, 0));
+	ut_assertok(dm_async_start(&other.op, NULL, "other", async_test_poll,
+				   0));
+
+	dm_async_cancel(&first.op);
+	ut_assert(!dm_async_pending(&first.op));
+	ut_asserteq(-ECANCELED, dm_async_wait(&first.op));
+	ut_asserteq(0, first.polls);
+
+	ut_assertok(device_remove(dev, DM_REMOVE_NORMAL));
+	ut_asserteq(-ECANCELED, dm_async_wait(&second.op));
+	ut_assert(dm_async_pending(&other.op));
+
+	/* Cancelled operations are not polled any more */
+	dm_async_wait_all();
+	ut_assertok(dm_async_wait(&other.op));
+	ut_asserteq(0, first.polls);
+	ut_asserteq(0, second.polls);
+
+	/* A cancelled operation can be started again */
+	ut_assertok(dm_async_start(&first.op, NULL, "first", async_test_poll,
+				   0));
+	ut_assertok(dm_async_wait(&first.op));
+	ut_asserteq(11, first.polls);
+
+	return 0;
+}
+DM_TEST(dm_test_async_cancel, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
@@ -261,3 +261,172 @@ static int dm_test_net_retry(struct unit_test_state *uts)
 	return retval;
 }
 DM_TEST(dm_test_net_retry, DM_TESTF_SCAN_FDT);
+
+static int dm_test_eth_stats(struct unit_test_state *uts)
+{
+	struct eth_stats *stats;
+	struct udevice *dev;
+
+	net_ping_ip = string_to_ip("1.1.2.2");
+
+	ut_assertok(uclass_get_device_by_name(UCLASS_ETH, "eth@10002000",
+					      &dev));
+	eth_reset_stats(dev);
+	stats = eth_get_stats(dev);
+	ut_assertnonnull(stats);
+	ut_asserteq(0, stats->tx_packets);
+	ut_asserteq(0, stats->rx_packets);
+
+	/* An ARP request/reply followed by an ICMP echo request/reply */
+	env_set("ethact", "eth@10002000");
+	ut_assertok(net_loop(PING));
+	ut_asserteq(2, stats->tx_packets);
+	ut_asserteq(2, stats->rx_packets);
+	ut_assert(stats->tx_bytes > 0);
+	ut_assert(stats->rx_bytes > 0);
+	ut_asserteq(0, stats->rx_dropped);
+	ut_asserteq(0, stats->rx_errors);
+	ut_asserteq(0, stats->tx_errors);
+
+	/* The sandbox driver lends its own buffers through recv_batch() */
+	ut_asserteq(0, stats->rx_copies);
+
+	eth_reset_stats(dev);
+	ut_asserteq(0, stats->tx_packets);
+	ut_asserteq(0, stats->rx_packets);
+
+	return 0;
+}
+DM_TEST(dm_test_eth_stats, DM_TESTF_SCAN_FDT);
+
+/* Send an ARP request for @ip, which the sandbox driver answers */
+static int dm_test_eth_send_arp(struct unit_test_state *uts,
+				struct in_addr ip)
+{
+	uchar pkt[ETHER_HDR_SIZE + ARP_HDR_SIZE];
+	struct ethernet_hdr *eth = (struct ethernet_hdr *)pkt;
+	struct arp_hdr *arp = (struct arp_hdr *)(pkt + ETHER_HDR_SIZE);
+
+	memset(pkt, '\0', sizeof(pkt));
+	memset(eth->et_dest, 0xff, ARP_HLEN);
+	memcpy(eth->et_src, net_ethaddr, ARP_HLEN);
+	eth->et_protlen = htons(PROT_ARP);
+	arp->ar_op = htons(ARPOP_REQUEST);
+	net_write_ip(&arp->ar_tpa, ip);
+	ut_assertok(eth_send(pkt, sizeof(pkt)));
+
+	return 0;
+}
+
+/* Check that batches of lent buffers are given back and drops counted */
+static int dm_test_eth_rx_batch(struct unit_test_state *uts)
+{
+	struct in_addr ip = string_to_ip("1.1.2.2");
+	struct eth_stats *stats;
+	struct udevice *dev;
+
+	ut_assertok(uclass_get_device_by_name(UCLASS_ETH, "eth@10002000",
+					      &dev));
+	env_set("ethact", "eth@10002000");
+	ut_assertok(eth_init());
+	eth_reset_stats(dev);
+	stats = eth_get_stats(dev);
+
+	/* The driver has two receive buffers, so the third reply is lost */
+	ut_assertok(dm_test_eth_send_arp(uts, ip));
+	ut_assertok(dm_test_eth_send_arp(uts, ip));
+	ut_assertok(dm_test_eth_send_arp(uts, ip));
+	ut_asserteq(3, stats->tx_packets);
+	ut_asserteq(1, stats->rx_dropped);
+
+	/* Both replies come in one batch and their buffers are given back */
+	ut_assertok(eth_rx());
+	ut_asserteq(2, stats->rx_packets);
+	ut_asserteq(0, stats->rx_copies);
+	ut_assertok(dm_test_eth_send_arp(uts, ip));
+	ut_assertok(dm_test_eth_send_arp(uts, ip));
+	ut_asserteq(1, stats->rx_dropped);
+	ut_assertok(eth_rx());
+	ut_asserteq(4, stats->rx_packets);
+	ut_asserteq(0, stats->rx_errors);
+	eth_halt();
+
+	return 0;
+}
+DM_TEST(dm_test_eth_rx_batch, DM_TESTF_SCAN_FDT);
+
+static int dm_test_eth_csum_offload(struct unit_test_state *uts)
+{
+	uchar pkt[IP_UDP_HDR_SIZE + 2];
+	struct ip_udp_hdr *ip = (struct ip_udp_hdr *)pkt;
+	struct eth_pdata *pdata;
+	struct udevice *dev;
+
+	ut_assertok(uclass_get_device_by_name(UCLASS_ETH, "eth@10002000",
+					      &dev));
+	env_set("ethact", "eth@10002000");
+	ut_asserteq_ptr(dev, eth_get_dev());
+	pdata = dev_get_platdata(dev);
+	ut_asserteq(0, eth_get_csum_offload());
+
+	net_set_udp_header(pkt, string_to_ip("1.1.2.2"), 69, 1234, 2);
+	ut_assert(ip->ip_sum != 0);
+	ut_assert(ip_checksum_ok(ip, IP_HDR_SIZE));
+
+	/* The hardware fills in the header checksum */
+	pdata->csum_offload = ETH_CSUM_TX;
+	ut_asserteq(ETH_CSUM_TX, eth_get_csum_offload());
+	net_set_udp_header(pkt, string_to_ip("1.1.2.2"), 69, 1234, 2);
+	ut_asserteq(0, ip->ip_sum);
+	pdata->csum_offload = 0;
+
+	return 0;
+}
+DM_TEST(dm_test_eth_csum_offload, DM_TESTF_SCAN_FDT);
+
+/* The asserts include a return on fail; cleanup in the caller */
+static int _dm_test_eth_rx_csum(struct unit_test_state *uts,
+				struct eth_pdata *pdata)
+{
+	/* The MAC checks the replies and the stack trusts it */
+	pdata->csum_offload = ETH_CSUM_RX;
+	ut_assertok(net_loop(PING));
+
+	/*
+	 * A reply spoilt after the MAC checked it is still taken, which shows
+	 * that the stack did not check the header again
+	 */
+	sandbox_eth_damage_ip_sum(0, true);
+	ut_assertok(net_loop(PING));
+
+	/* Without offload the stack checks it and drops the reply */
+	pdata->csum_offload = 0;
+	sandbox_eth_skip_timeout();
+	ut_asserteq(-ETIMEDOUT, net_loop(PING));
+
+	return 0;
+}
+
+static int dm_test_eth_rx_csum(struct unit_test_state *uts)
+{
+	struct eth_pdata *pdata;
+	struct udevice *dev;
+	int retval;
+
+	ut_assertok(uclass_get_device_by_name(UCLASS_ETH, "eth@10002000",
+					      &dev));
+	pdata = dev_get_platdata(dev);
+	net_ping_ip = string_to_ip("1.1.2.2");
+	env_set("ethact", "eth@10002000");
+	env_set("netretry", "no");
+
+	retval = _dm_test_eth_rx_csum(uts, pdata);
+
+	/* Restore the env and the device */
+	env_set("netretry", NULL);
+	sandbox_eth_damage_ip_sum(0, false);
+	pdata->csum_offload = 0;
+
+	return retval;
+}
+DM_TEST(dm_test_eth_rx_csum, DM_TESTF_SCAN_FDT);
@@ -6,7 +6,9 @@
 
 #include <common.h>
 #include <dm.h>
+#include <pci.h>
 #include <asm/io.h>
+#include <dm/device-internal.h>
 #include <dm/test.h>
 #include <test/ut.h>
 
@@ -65,3 +67,104 @@ static int dm_test_pci_swapcase(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_pci_swapcase, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/*
+ * Check the bus numbers and windows of the bridge at @bdf, and that the
+ * device behind it is inside the windows. The memory window is returned
+ * in @mem_basep.
+ */
+static int pci_test_check_bridge(struct unit_test_state *uts, pci_dev_t bdf,
+				 int busnum, u32 *mem_basep)
+{
+	u32 io_base, io_limit, mem_base, mem_limit, addr;
+	struct udevice *bridge, *swap;
+	u16 val16;
+	u8 val;
+
+	ut_assertok(dm_pci_bus_find_bdf(bdf, &bridge));
+	ut_assert(device_active(bridge));
+	ut_asserteq(busnum, bridge->seq);
+
+	ut_assertok(dm_pci_read_config8(bridge, PCI_PRIMARY_BUS, &val));
+	ut_asserteq(0, val);
+	ut_assertok(dm_pci_read_config8(bridge, PCI_SECONDARY_BUS, &val));
+	ut_asserteq(busnum, val);
+	ut_assertok(dm_pci_read_config8(bridge, PCI_SUBORDINATE_BUS, &val));
+	ut_asserteq(busnum, val);
+
+	dm_pci_read_config8(bridge, PCI_IO_BASE, &val);
+	dm_pci_read_config16(bridge, PCI_IO_BASE_UPPER16, &val16);
+	io_base = (val16 << 16) | (val & PCI_IO_RANGE_MASK) << 8;
+	dm_pci_read_config8(bridge, PCI_IO_LIMIT, &val);
+	dm_pci_read_config16(bridge, PCI_IO_LIMIT_UPPER16, &val16);
+	io_limit = (val16 << 16) | (val & PCI_IO_RANGE_MASK) << 8 | 0xfff;
+	dm_pci_read_config16(bridge, PCI_MEMORY_BASE, &val16);
+	mem_base = (val16 & PCI_MEMORY_RANGE_MASK) << 16;
+	dm_pci_read_config16(bridge, PCI_MEMORY_LIMIT, &val16);
+	mem_limit = (val16 & PCI_MEMORY_RANGE_MASK) << 16 | 0xfffff;
+	ut_assert(io_base < io_limit);
+	ut_assert(mem_base < mem_limit);
+
+	ut_assertok(dm_pci_bus_find_bdf(PCI_BDF(busnum, 0, 0), &swap));
+	ut_asserteq_ptr(bridge, swap->parent);
+	addr = dm_pci_read_bar32(swap, 0);
+	ut_assert(addr >= io_base && addr <= io_limit);
+	addr = dm_pci_read_bar32(swap, 1);
+	ut_assert(addr >= mem_base && addr <= mem_limit);
+	*mem_basep = mem_base;
+
+	return 0;
+}
+
+/* Test that pci_init() sets up the bridges in order */
+static int dm_test_pci_bridge_init(struct unit_test_state *uts)
+{
+	u32 mem1, mem2;
+
+	pci_init();
+	ut_assertok(pci_test_check_bridge(uts, PCI_BDF(0, 1, 0), 1, &mem1));
+	ut_assertok(pci_test_check_bridge(uts, PCI_BDF(0, 2, 0), 2, &mem2));
+	ut_assert(mem2 > mem1);
+
+	return 0;
+}
+DM_TEST(dm_test_pci_bridge_init, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_PCI_LAZY_ENUM
+/* Test that bridges are set up only when something behind them is used */
+static int dm_test_pci_bridge_lazy(struct unit_test_state *uts)
+{
+	struct udevice *bridge1, *bridge2, *swap;
+	u32 mem1, mem2;
+	u8 val;
+
+	/* Configuring the controller leaves the bridges alone */
+	ut_assertok(dm_pci_bus_find_bdf(PCI_BDF(0, 1, 0), &bridge1));
+	ut_assertok(dm_pci_bus_find_bdf(PCI_BDF(0, 2, 0), &bridge2));
+	ut_assert(!device_active(bridge1));
+	ut_assert(!device_active(bridge2));
+	ut_assertok(dm_pci_read_config8(bridge1, PCI_SECONDARY_BUS, &val));
+	ut_asserteq(0, val);
+
+	/* Using the device behind the second bridge sets up only that one */
+	ut_assertok(device_find_first_child(bridge2, &swap));
+	ut_assertok(device_probe(swap));
+	ut_assert(!device_active(bridge1));
+	ut_assertok(pci_test_check_bridge(uts, PCI_BDF(0, 2, 0), 1, &mem2));
+
+	/* Looking up a device on the next bus sets up the first bridge */
+	ut_assertok(dm_pci_bus_find_bdf(PCI_BDF(2, 0, 0), &swap));
+	ut_asserteq_ptr(bridge1, swap->parent);
+	ut_assertok(pci_test_check_bridge(uts, PCI_BDF(0, 1, 0), 2, &mem1));
+	ut_assert(mem1 > mem2);
+
+	/* This leaves nothing for pci_init() to do */
+	pci_init();
+	ut_assertok(pci_test_check_bridge(uts, PCI_BDF(0, 2, 0), 1, &mem2));
+	ut_assertok(pci_test_check_bridge(uts, PCI_BDF(0, 1, 0), 2, &mem1));
+	ut_assert(mem1 > mem2);
+
+	return 0;
+}
+DM_TEST(dm_test_pci_bridge_lazy, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+#endif
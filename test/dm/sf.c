@@ -6,10 +6,16 @@
 
 #include <common.h>
 #include <dm.h>
+#include <environment.h>
+#include <env_sf_log.h>
 #include <fdtdec.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <search.h>
 #include <spi.h>
 #include <spi_flash.h>
 #include <asm/state.h>
+#include <asm/test.h>
 #include <dm/test.h>
 #include <dm/util.h>
 #include <test/ut.h>
@@ -41,3 +47,346 @@ static int dm_test_spi_flash(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_spi_flash, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Read back @len bytes of SPI flash and check they match @expect */
+static int check_flash_read(struct unit_test_state *uts, struct udevice *dev,
+			    const u8 *expect, size_t len)
+{
+	u8 *buf;
+
+	buf = calloc(1, len);
+	ut_assertnonnull(buf);
+	ut_assertok(spi_flash_read_dm(dev, 0x100, len, buf));
+	ut_assertok(memcmp(expect, buf, len));
+	free(buf);
+
+	return 0;
+}
+
+/* Test reading through the SPI controller's mem_read() method */
+static int dm_test_spi_flash_mem_read(struct unit_test_state *uts)
+{
+	const size_t len = 0x1000;
+	struct udevice *dev, *bus;
+	uint count;
+	u8 *data;
+	int i;
+
+	ut_assertok(run_command("sb save hostfs - 0 spi.bin 200000", 0));
+	ut_assertok(spi_flash_probe_bus_cs(0, 0, 0, 0, &dev));
+	bus = dev_get_parent(dev);
+
+	data = malloc(len);
+	ut_assertnonnull(data);
+	for (i = 0; i < len; i++)
+		data[i] = i * 7 + (i >> 8);
+	ut_assertok(spi_flash_erase_dm(dev, 0, 0x10000));
+	ut_assertok(spi_flash_write_dm(dev, 0x100, len, data));
+
+	/* The whole read is done by mem_read(), in one go */
+	count = sandbox_spi_get_mem_read_count(bus);
+	ut_assertok(check_flash_read(uts, dev, data, len));
+	ut_asserteq(count + 1, sandbox_spi_get_mem_read_count(bus));
+
+	/* -ENOTSUPP falls back to spi_xfer() for this read only */
+	sandbox_spi_set_mem_read_err(bus, -ENOTSUPP);
+	ut_assertok(check_flash_read(uts, dev, data, len));
+	ut_asserteq(count + 1, sandbox_spi_get_mem_read_count(bus));
+	sandbox_spi_set_mem_read_err(bus, 0);
+	ut_assertok(check_flash_read(uts, dev, data, len));
+	ut_asserteq(count + 2, sandbox_spi_get_mem_read_count(bus));
+
+	/* -ENOSYS means mem_read() is not tried again */
+	sandbox_spi_set_mem_read_err(bus, -ENOSYS);
+	ut_assertok(check_flash_read(uts, dev, data, len));
+	sandbox_spi_set_mem_read_err(bus, 0);
+	ut_assertok(check_flash_read(uts, dev, data, len));
+	ut_asserteq(count + 2, sandbox_spi_get_mem_read_count(bus));
+	free(data);
+
+	sandbox_sf_unbind_emul(state_get_current(), 0, 0);
+
+	return 0;
+}
+DM_TEST(dm_test_spi_flash_mem_read, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/*
+ * Add a 4MiB flash with 4KiB sectors on chip select 1, so that the 64KiB
+ * block erase can be tested. The one in the device tree has 64KiB sectors.
+ */
+static int sf_bind_4k_flash(struct unit_test_state *uts, struct udevice **devp)
+{
+	struct sandbox_state *state = state_get_current();
+	struct udevice *bus;
+
+	ut_assertok(run_command("sb save hostfs - 0 spi4k.bin 400000", 0));
+	state->spi[0][1].spec = "w25q32dw:spi4k.bin";
+	ut_assertok(uclass_get_device_by_seq(UCLASS_SPI, 0, &bus));
+	ut_assertok(sandbox_sf_bind_emul(state, 0, 1, bus, ofnode_null(),
+					 "w25q32dw"));
+	ut_assertok(spi_flash_probe_bus_cs(0, 1, 0, 0, devp));
+
+	return 0;
+}
+
+static void sf_unbind_4k_flash(void)
+{
+	struct sandbox_state *state = state_get_current();
+
+	sandbox_sf_unbind_emul(state, 0, 1);
+	state->spi[0][1].spec = NULL;
+}
+
+/* Test the choice of erase command */
+static int dm_test_spi_flash_erase(struct unit_test_state *uts)
+{
+	struct sandbox_state *state = state_get_current();
+	struct sandbox_sf_stats old, new;
+	struct udevice *dev;
+	u8 buf[0x100];
+
+	ut_assertok(sf_bind_4k_flash(uts, &dev));
+
+	/* Erasing the whole chip uses a chip erase */
+	memset(buf, 0x5a, sizeof(buf));
+	ut_assertok(spi_flash_write_dm(dev, 0x200000, sizeof(buf), buf));
+	ut_assertok(sandbox_sf_get_stats(state, 0, 1, &old));
+	ut_assertok(spi_flash_erase_dm(dev, 0, 0x400000));
+	ut_assertok(sandbox_sf_get_stats(state, 0, 1, &new));
+	ut_asserteq(old.erase_chip + 1, new.erase_chip);
+	ut_asserteq(old.erase_64k, new.erase_64k);
+	ut_asserteq(old.erase_4k, new.erase_4k);
+	ut_assertok(spi_flash_read_dm(dev, 0x200000, sizeof(buf), buf));
+	ut_asserteq_ptr(NULL, memchr_inv(buf, 0xff, sizeof(buf)));
+
+	/* Aligned 64KiB blocks use a block erase, the rest 4KiB sectors */
+	old = new;
+	ut_assertok(spi_flash_erase_dm(dev, 0x10000, 0x11000));
+	ut_assertok(sandbox_sf_get_stats(state, 0, 1, &new));
+	ut_asserteq(old.erase_64k + 1, new.erase_64k);
+	ut_asserteq(old.erase_4k + 1, new.erase_4k);
+
+	old = new;
+	ut_assertok(spi_flash_erase_dm(dev, 0x31000, 0x10000));
+	ut_assertok(sandbox_sf_get_stats(state, 0, 1, &new));
+	ut_asserteq(old.erase_64k, new.erase_64k);
+	ut_asserteq(old.erase_4k + 16, new.erase_4k);
+	ut_asserteq(old.erase_chip, new.erase_chip);
+
+	sf_unbind_4k_flash();
+
+	return 0;
+}
+DM_TEST(dm_test_spi_flash_erase, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* Run 'sf update' and check which erase and program operations it used */
+static int sf_check_update(struct unit_test_state *uts, uint erase_4k,
+			   uint program)
+{
+	struct sandbox_state *state = state_get_current();
+	struct sandbox_sf_stats old, new;
+
+	ut_assertok(sandbox_sf_get_stats(state, 0, 1, &old));
+	ut_assertok(run_command("sf update 100000 0 2000", 0));
+	ut_assertok(sandbox_sf_get_stats(state, 0, 1, &new));
+	ut_asserteq(old.erase_4k + erase_4k, new.erase_4k);
+	ut_asserteq(old.erase_64k, new.erase_64k);
+	ut_asserteq(old.program + program, new.program);
+
+	ut_assertok(run_command("sf read 200000 0 2000", 0));
+	ut_assertok(memcmp(map_sysmem(0x100000, 0x2000),
+			   map_sysmem(0x200000, 0x2000), 0x2000));
+
+	return 0;
+}
+
+/* Test that 'sf update' only erases and programs what it needs to */
+static int dm_test_spi_flash_update(struct unit_test_state *uts)
+{
+	const bool no_erase = IS_ENABLED(CONFIG_CMD_SF_UPDATE_NO_ERASE);
+	struct udevice *dev;
+	u8 *buf;
+	int i;
+
+	ut_assertok(sf_bind_4k_flash(uts, &dev));
+	ut_assertok(spi_flash_erase_dm(dev, 0, 0x10000));
+	ut_assertok(run_command("sf probe 0:1", 0));
+
+	/* Pages which stay erased are not programmed */
+	buf = map_sysmem(0x100000, 0x2000);
+	for (i = 0; i < 0x1000; i++)
+		buf[i] = i * 7 + (i >> 8);
+	memset(buf + 0x1000, 0xff, 0x1000);
+	ut_assertok(sf_check_update(uts, !no_erase, 16));
+
+	/* Clearing bits only needs the changed page programmed */
+	buf[0x123] &= 0xf0;
+	ut_assertok(sf_check_update(uts, !no_erase, no_erase ? 1 : 16));
+
+	/* Setting a bit needs an erase */
+	buf[0x234] = 0xff;
+	ut_assertok(sf_check_update(uts, 1, 16));
+
+	sf_unbind_4k_flash();
+
+	return 0;
+}
+DM_TEST(dm_test_spi_flash_update, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+#ifdef CONFIG_ENV_SF_LOG
+/* The log uses the last two sectors of spi.bin */
+#define SF_LOG_SECT_SIZE	0x10000
+#define SF_LOG_OFFSET		0x1e0000
+#define SF_LOG_OFFSET_REDUND	0x1f0000
+
+/*
+ * Find the environment entry @str, including its terminator, in an
+ * environment area. Sets *@posp to its offset or -1 if not found.
+ */
+static int env_sf_find(struct unit_test_state *uts, struct spi_flash *flash,
+		       ulong area, const char *str, int *posp)
+{
+	int len = strlen(str) + 1;
+	char *buf;
+	int pos;
+
+	buf = malloc(SF_LOG_SECT_SIZE);
+	ut_assertnonnull(buf);
+	ut_assertok(spi_flash_read(flash, area, SF_LOG_SECT_SIZE, buf));
+	*posp = -1;
+	for (pos = 0; pos + len <= SF_LOG_SECT_SIZE; pos++) {
+		if (!memcmp(buf + pos, str, len)) {
+			*posp = pos;
+			break;
+		}
+	}
+	free(buf);
+
+	return 0;
+}
+
+/* Overwrite one byte of SPI flash */
+static int env_sf_poke(struct unit_test_state *uts, struct spi_flash *flash,
+		       ulong offset, u8 val)
+{
+	ut_assertok(spi_flash_write(flash, offset, 1, &val));
+
+	return 0;
+}
+
+static int env_sf_log_test(struct unit_test_state *uts, struct env_sf_log *log)
+{
+	ulong first = SF_LOG_OFFSET, second = SF_LOG_OFFSET_REDUND;
+	struct spi_flash *flash = log->flash;
+	char value[1024];
+	int i, pos;
+
+	/* Nothing valid in flash, so the first save writes a snapshot */
+	ut_asserteq(-ENOENT, env_sf_log_load(log));
+	ut_assertok(env_set("sflog_a", "1"));
+	ut_assertok(env_sf_log_save(log));
+	ut_assertok(env_sf_find(uts, flash, first, "sflog_a=1", &pos));
+	if (pos == -1) {
+		first = SF_LOG_OFFSET_REDUND;
+		second = SF_LOG_OFFSET;
+	}
+	ut_assertok(env_sf_find(uts, flash, first, "sflog_a=1", &pos));
+	ut_assert(pos >= 0);
+	ut_assertok(env_sf_find(uts, flash, second, "sflog_a=1", &pos));
+	ut_asserteq(-1, pos);
+
+	/* Later saves append to the same area */
+	ut_assertok(env_set("sflog_b", "2"));
+	ut_assertok(env_sf_log_save(log));
+	ut_assertok(env_sf_find(uts, flash, first, "sflog_b=2", &pos));
+	ut_assert(pos >= 0);
+	ut_assertok(env_sf_find(uts, flash, second, "sflog_b=2", &pos));
+	ut_asserteq(-1, pos);
+
+	/* A deletion is logged as "name=" */
+	ut_assertok(env_set("sflog_a", NULL));
+	ut_assertok(env_sf_log_save(log));
+	ut_assertok(env_sf_find(uts, flash, first, "sflog_a=", &pos));
+	ut_assert(pos >= 0);
+
+	ut_assertok(env_set("sflog_a", "x"));
+	ut_assertok(env_set("sflog_b", NULL));
+	ut_assertok(env_sf_log_load(log));
+	ut_asserteq_ptr(NULL, env_get("sflog_a"));
+	ut_asserteq_str("2", env_get("sflog_b"));
+
+	/* Fill the area so that the log wraps around to the other one */
+	memset(value, 'v', sizeof(value) - 1);
+	value[sizeof(value) - 1] = '\0';
+	for (i = 0; i < 80; i++) {
+		snprintf(value, 4, "%03d", i);
+		value[3] = 'v';
+		ut_assertok(env_set("sflog_big", value));
+		ut_assertok(env_sf_log_save(log));
+	}
+	ut_assertok(env_sf_find(uts, flash, second, value, &pos));
+	ut_assert(pos >= 0);
+	ut_assertok(env_sf_find(uts, flash, first, value, &pos));
+	ut_asserteq(-1, pos);
+
+	ut_assertok(env_set("sflog_big", NULL));
+	ut_assertok(env_sf_log_load(log));
+	ut_asserteq_str(value, env_get("sflog_big"));
+	ut_asserteq_str("2", env_get("sflog_b"));
+
+	/* A record with a bad CRC is ignored */
+	ut_assertok(env_set("sflog_c", "3"));
+	ut_assertok(env_sf_log_save(log));
+	ut_assertok(env_sf_find(uts, flash, second, "sflog_c=3", &pos));
+	ut_assert(pos >= 0);
+	ut_assertok(env_sf_poke(uts, flash, second + pos + 8, '4'));
+	ut_assertok(env_sf_log_load(log));
+	ut_asserteq_ptr(NULL, env_get("sflog_c"));
+	ut_asserteq_str(value, env_get("sflog_big"));
+
+	/* If the newest area is corrupted the previous log is used */
+	ut_assertok(env_sf_poke(uts, flash, second, 0));
+	ut_assertok(env_sf_log_load(log));
+	ut_assertnonnull(env_get("sflog_big"));
+	ut_assert(strcmp(value, env_get("sflog_big")));
+	ut_asserteq_str("2", env_get("sflog_b"));
+
+	return 0;
+}
+
+/* Test the log-structured environment on the emulated SPI flash */
+static int dm_test_spi_flash_env_log(struct unit_test_state *uts)
+{
+	struct env_sf_log log = {
+		.offset		= { SF_LOG_OFFSET, SF_LOG_OFFSET_REDUND },
+		.num_areas	= 2,
+		.area_size	= SF_LOG_SECT_SIZE,
+		.full		= true,
+	};
+	struct udevice *dev;
+	char *saved = NULL;
+	ssize_t len;
+	int ret;
+
+	/* Keep the current environment so it can be put back at the end */
+	len = hexport_r(&env_htab, '\0', 0, &saved, 0, 0, NULL);
+	ut_assert(len > 0);
+
+	ut_assertok(run_command_list(
+		"sb save hostfs - 0 spi.bin 200000;"
+		"sf probe;"
+		"sf erase 1e0000 20000", -1, 0));
+	ut_assertok(spi_flash_probe_bus_cs(0, 0, 0, 0, &dev));
+	log.flash = dev_get_uclass_priv(dev);
+
+	ret = env_sf_log_test(uts, &log);
+
+	ut_assert(himport_r(&env_htab, saved, len, '\0', 0, 0, 0, NULL));
+	free(saved);
+	free(log.base);
+	sandbox_sf_unbind_emul(state_get_current(), 0, 0);
+
+	return ret;
+}
+DM_TEST(dm_test_spi_flash_env_log, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+#endif
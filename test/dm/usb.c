@@ -147,3 +147,52 @@ static int dm_test_usb_keyb(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_usb_keyb, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
+/* test that requests complete in order and can be cancelled */
+static int dm_test_usb_request(struct unit_test_state *uts)
+{
+	struct usb_endpoint_descriptor *ep;
+	struct usb_request req, req2;
+	struct udevice *dev, *emul;
+	struct usb_device *udev;
+	u8 report[8], report2[8];
+
+	state_set_skip_delays(true);
+	ut_assertok(usb_init());
+	ut_assertok(uclass_get_device_by_name(UCLASS_KEYBOARD, "usb_kbd",
+					      &dev));
+	ut_assertok(uclass_get_device_by_name(UCLASS_USB_EMUL, "keyb",
+					      &emul));
+	udev = dev_get_parent_priv(dev);
+	ep = &udev->config.if_desc[0].ep_desc[0];
+
+	memset(&req, '\0', sizeof(req));
+	req.udev = udev;
+	req.pipe = usb_rcvintpipe(udev, ep->bEndpointAddress);
+	req.buffer = report;
+	req.length = sizeof(report);
+	req.interval = ep->bInterval;
+	req2 = req;
+	req2.buffer = report2;
+
+	/* The keyboard's own request is ahead of these two and gets the 'a' */
+	ut_assertok(sandbox_usb_keyb_add_string(emul, "ab"));
+	ut_assertok(usb_submit_request(&req));
+	ut_assertok(usb_submit_request(&req2));
+	ut_asserteq(-EINPROGRESS, req.status);
+	ut_assertok(usb_poll_request(&req));
+	ut_asserteq(sizeof(report), req.act_len);
+	ut_asserteq(-EINPROGRESS, req2.status);
+	ut_assertok(usb_wait_request(&req2, 100));
+	ut_asserteq(4 + 'b' - 'a', report[2]);
+	ut_asserteq(0, report2[2]);
+
+	ut_assertok(usb_submit_request(&req));
+	ut_assertok(usb_cancel_request(&req));
+	ut_asserteq(-ECONNRESET, usb_poll_request(&req));
+
+	ut_assertok(usb_stop());
+
+	return 0;
+}
+DM_TEST(dm_test_usb_request, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
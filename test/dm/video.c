@@ -52,6 +52,8 @@ DM_TEST(dm_test_video_base, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
  * size of the compressed data. This provides a pretty good level of
  * certainty and the resulting tests need only check a single value.
  *
+ * This also syncs the frame buffer and checks that any copy of it is the same.
+ *
  * @dev:	Video device
  * @return compressed size of the frame buffer, or -ve on error
  */
@@ -62,6 +64,11 @@ static int compress_frame_buffer(struct udevice *dev)
 	void *dest;
 	int ret;
 
+	/* Once synced, the hardware must show the same as the frame buffer */
+	video_sync(dev);
+	if (priv->copy_fb && memcmp(priv->fb, priv->copy_fb, priv->fb_size))
+		return -EIO;
+
 	destlen = priv->fb_size;
 	dest = malloc(priv->fb_size);
 	if (!dest)
@@ -143,6 +150,61 @@ static int dm_test_video_text(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_video_text, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
 
+/* Test that drawing records the damaged area and that rectangles are copied */
+static int dm_test_video_damage(struct unit_test_state *uts)
+{
+	struct video_priv *priv;
+	struct udevice *dev, *con;
+	int i;
+
+	ut_assertok(select_vidconsole(uts, "vidconsole0"));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO, 0, &dev));
+	ut_assertok(uclass_get_device(UCLASS_VIDEO_CONSOLE, 0, &con));
+	priv = dev_get_uclass_priv(dev);
+	video_sync(dev);
+	ut_asserteq(0, priv->damage.xend);
+
+	vidconsole_putc_xy(con, VID_TO_POS(16), 32, 'a');
+	vidconsole_putc_xy(con, VID_TO_POS(40), 48, 'b');
+	ut_asserteq(16, priv->damage.xstart);
+	ut_asserteq(32, priv->damage.ystart);
+	ut_asserteq(48, priv->damage.xend);
+	ut_asserteq(64, priv->damage.yend);
+	video_sync(dev);
+	ut_asserteq(0, priv->damage.xend);
+	vidconsole_putc_xy(con, VID_TO_POS(16), 32, ' ');
+	vidconsole_putc_xy(con, VID_TO_POS(40), 48, ' ');
+	video_sync(dev);
+
+	/* The area is clipped to the display */
+	video_damage(dev, 1360, -4, 20, 10);
+	ut_asserteq(1360, priv->damage.xstart);
+	ut_asserteq(0, priv->damage.ystart);
+	ut_asserteq(1366, priv->damage.xend);
+	ut_asserteq(6, priv->damage.yend);
+	ut_asserteq(46, compress_frame_buffer(dev));
+
+	/* Copy a character, then move it down over itself */
+	vidconsole_putc_xy(con, 0, 0, 'a');
+	ut_assertok(video_copy_rect(dev, 100, 50, 0, 0, 8, 16));
+	ut_assertok(video_copy_rect(dev, 100, 52, 100, 50, 8, 16));
+	for (i = 0; i < 16; i++) {
+		ut_assertok(memcmp(priv->fb + i * priv->line_length,
+				   priv->fb + (52 + i) * priv->line_length +
+				   100 * 2, 8 * 2));
+	}
+	ut_asserteq(108, priv->damage.xend);
+	ut_asserteq(68, priv->damage.yend);
+
+	/* Clear it all again */
+	vidconsole_putc_xy(con, 0, 0, ' ');
+	ut_assertok(video_fill_rect(dev, 100, 50, 8, 18, priv->colour_bg));
+	ut_asserteq(46, compress_frame_buffer(dev));
+
+	return 0;
+}
+DM_TEST(dm_test_video_damage, DM_TESTF_SCAN_PDATA | DM_TESTF_SCAN_FDT);
+
 /* Test handling of special characters in the console */
 static int dm_test_video_chars(struct unit_test_state *uts)
 {
@@ -0,0 +1,219 @@
+/*
+ * Tests for reading through open files with fs_openfile()/fs_pread()
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <command.h>
+#include <fs.h>
+#include <malloc.h>
+#include <os.h>
+#include <sandboxblockdev.h>
+#include <test/suites.h>
+#include <test/test.h>
+#include <test/ut.h>
+#include <asm/unaligned.h>
+
+#define FS_FILE_TEST(_name, _flags)	UNIT_TEST(_name, _flags, fs_file_test)
+
+#define FS_FILE_HOSTFS		"fs_file_ut.bin"
+#define FS_FILE_FAT_IMG		"fs_file_ut.img"
+#define FS_FILE_FAT_NAME	"/test.bin"
+
+/* FAT12 image: 512-byte sectors and clusters, one sector per FAT */
+#define FAT_SECT_SIZE		512
+#define FAT_TOTAL_SECTS		128
+#define FAT_ROOT_SECT		3
+#define FAT_DATA_SECT		4
+
+/* Clusters in the test file, spread out so that the chain is fragmented */
+#define FS_FILE_CLUSTERS	40
+#define FS_FILE_SIZE		(FS_FILE_CLUSTERS * FAT_SECT_SIZE - 123)
+
+static u8 fs_file_byte(loff_t pos)
+{
+	return (pos * 13 + 7) ^ (pos >> 8);
+}
+
+static void fs_file_fill(u8 *buf, loff_t size)
+{
+	loff_t i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = fs_file_byte(i);
+}
+
+static int fs_file_write_host(const char *fname, const void *buf, int size)
+{
+	int fd, ret;
+
+	os_unlink(fname);
+	fd = os_open(fname, OS_O_CREAT | OS_O_WRONLY);
+	if (fd < 0)
+		return -EIO;
+	ret = os_write(fd, buf, size);
+	os_close(fd);
+
+	return ret == size ? 0 : -EIO;
+}
+
+static unsigned int fat_cluster(unsigned int i)
+{
+	return 2 + 2 * (i * 7 % FS_FILE_CLUSTERS);
+}
+
+static void fat12_set(u8 *fat, unsigned int clust, unsigned int val)
+{
+	u8 *p = fat + clust + clust / 2;
+
+	if (clust & 1) {
+		p[0] = (p[0] & 0x0f) | (val << 4);
+		p[1] = val >> 4;
+	} else {
+		p[0] = val;
+		p[1] = (p[1] & 0xf0) | ((val >> 8) & 0x0f);
+	}
+}
+
+/* Build a FAT12 image holding FS_FILE_FAT_NAME with a fragmented chain */
+static int fs_file_make_fat(const u8 *data)
+{
+	u8 *img, *fat, *dent;
+	unsigned int i, next;
+	int ret;
+
+	img = calloc(FAT_TOTAL_SECTS, FAT_SECT_SIZE);
+	if (!img)
+		return -ENOMEM;
+
+	memcpy(img, "\xeb\x3c\x90MSWIN4.1", 11);
+	put_unaligned_le16(FAT_SECT_SIZE, img + 11);
+	img[13] = 1;				/* sectors per cluster */
+	put_unaligned_le16(1, img + 14);	/* reserved sectors */
+	img[16] = 2;				/* number of FATs */
+	put_unaligned_le16(16, img + 17);	/* root directory entries */
+	put_unaligned_le16(FAT_TOTAL_SECTS, img + 19);
+	img[21] = 0xf8;				/* media */
+	put_unaligned_le16(1, img + 22);	/* sectors per FAT */
+	img[38] = 0x29;
+	memcpy(img + 43, "NO NAME    FAT12   ", 19);
+	img[510] = 0x55;
+	img[511] = 0xaa;
+
+	fat = img + FAT_SECT_SIZE;
+	fat12_set(fat, 0, 0xff8);
+	fat12_set(fat, 1, 0xfff);
+	for (i = 0; i < FS_FILE_CLUSTERS; i++) {
+		next = i + 1 < FS_FILE_CLUSTERS ? fat_cluster(i + 1) : 0xfff;
+		fat12_set(fat, fat_cluster(i), next);
+		memcpy(img + (FAT_DATA_SECT + fat_cluster(i) - 2) *
+		       FAT_SECT_SIZE, data + i * FAT_SECT_SIZE,
+		       min_t(int, FAT_SECT_SIZE,
+			     FS_FILE_SIZE - i * FAT_SECT_SIZE));
+	}
+	memcpy(fat + FAT_SECT_SIZE, fat, FAT_SECT_SIZE);
+
+	dent = img + FAT_ROOT_SECT * FAT_SECT_SIZE;
+	memcpy(dent, "TEST    BIN", 11);
+	dent[11] = 0x20;			/* archive */
+	put_unaligned_le16(fat_cluster(0), dent + 26);
+	put_unaligned_le32(FS_FILE_SIZE, dent + 28);
+
+	ret = fs_file_write_host(FS_FILE_FAT_IMG, img,
+				 FAT_TOTAL_SECTS * FAT_SECT_SIZE);
+	free(img);
+
+	return ret;
+}
+
+/* Read @len bytes at @offset and check them against the pattern */
+static int fs_file_check(struct unit_test_state *uts, struct fs_file *file,
+			 u8 *buf, loff_t offset, loff_t len, loff_t expect)
+{
+	loff_t actread, i;
+
+	memset(buf, 0, len);
+	ut_assertok(fs_pread(file, buf, offset, len, &actread));
+	ut_asserteq(expect, actread);
+	for (i = 0; i < actread; i++)
+		ut_asserteq(fs_file_byte(offset + i), buf[i]);
+
+	return 0;
+}
+
+/*
+ * Open a file on hostfs, which has no block device, and one on a FAT image,
+ * then read from both in turn so that each read must go back to the
+ * filesystem its file was opened on.
+ */
+static int fs_file_test_pread(struct unit_test_state *uts)
+{
+	struct fs_file *hfile, *ffile;
+	loff_t offset;
+	u8 *data, *buf;
+
+	data = malloc(FS_FILE_SIZE);
+	buf = memalign(ARCH_DMA_MINALIGN, FS_FILE_SIZE);
+	ut_assertnonnull(data);
+	ut_assertnonnull(buf);
+	fs_file_fill(data, FS_FILE_SIZE);
+	ut_assertok(fs_file_write_host(FS_FILE_HOSTFS, data, FS_FILE_SIZE));
+	ut_assertok(fs_file_make_fat(data));
+	ut_assertok(host_dev_bind(0, FS_FILE_FAT_IMG));
+
+	ut_assertok(fs_set_blk_dev("hostfs", "-", FS_TYPE_SANDBOX));
+	hfile = fs_openfile(FS_FILE_HOSTFS);
+	ut_assertnonnull(hfile);
+	ut_asserteq(FS_FILE_SIZE, hfile->size);
+
+	ut_assertok(fs_set_blk_dev("host", "0:0", FS_TYPE_FAT));
+	ffile = fs_openfile(FS_FILE_FAT_NAME);
+	ut_assertnonnull(ffile);
+	ut_asserteq(FS_FILE_SIZE, ffile->size);
+
+	/* Sequential chunks which do not line up with clusters */
+	for (offset = 0; offset < FS_FILE_SIZE; offset += 1000) {
+		ut_assertok(fs_file_check(uts, hfile, buf, offset, 1000,
+					  min(1000LL, FS_FILE_SIZE - offset)));
+		ut_assertok(fs_file_check(uts, ffile, buf, offset, 1000,
+					  min(1000LL, FS_FILE_SIZE - offset)));
+	}
+
+	/* Going backwards, across a cluster boundary and past the end */
+	ut_assertok(fs_file_check(uts, hfile, buf, 5000, 3000, 3000));
+	ut_assertok(fs_file_check(uts, ffile, buf, 5000, 3000, 3000));
+	ut_assertok(fs_file_check(uts, hfile, buf, 511, 2, 2));
+	ut_assertok(fs_file_check(uts, ffile, buf, 511, 2, 2));
+	ut_assertok(fs_file_check(uts, hfile, buf, FS_FILE_SIZE - 100, 4096,
+				  100));
+	ut_assertok(fs_file_check(uts, ffile, buf, FS_FILE_SIZE - 100, 4096,
+				  100));
+	ut_assertok(fs_file_check(uts, ffile, buf, FS_FILE_SIZE, 10, 0));
+
+	/* The whole file in one go */
+	ut_assertok(fs_file_check(uts, ffile, buf, 0, FS_FILE_SIZE,
+				  FS_FILE_SIZE));
+	ut_assertok(fs_file_check(uts, hfile, buf, 0, FS_FILE_SIZE,
+				  FS_FILE_SIZE));
+
+	fs_closefile(ffile);
+	fs_closefile(hfile);
+	ut_assertok(host_dev_bind(0, NULL));
+	os_unlink(FS_FILE_FAT_IMG);
+	os_unlink(FS_FILE_HOSTFS);
+	free(buf);
+	free(data);
+
+	return 0;
+}
+FS_FILE_TEST(fs_file_test_pread, 0);
+
+int do_ut_fs_file(cmd_tbl_t *cmdtp, int flag, int argc, char * const argv[])
+{
+	struct unit_test *tests = ll_entry_start(struct unit_test,
+						 fs_file_test);
+	const int n_ents = ll_entry_count(struct unit_test, fs_file_test);
+
+	return cmd_ut_category("fs_file", tests, n_ents, argc, argv);
+}
@@ -0,0 +1,126 @@
+/*
+ * Tests and benchmark for the cache of parsed hush scripts
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <cli.h>
+#include <cli_hush.h>
+#include <command.h>
+#include <environment.h>
+#include <errno.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Number of times each boot script is run by the benchmark */
+#define HUSH_UT_RUNS		200
+
+static int hush_ut_expect(const char *var, const char *expect)
+{
+	const char *val = env_get(var);
+
+	if (!val || strcmp(val, expect)) {
+		printf("%s: %s is '%s', expected '%s'\n", __func__, var,
+		       val ? val : "(null)", expect);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Run scripts twice so that the second run comes from the cache, and check
+ * that loops can be run again and that a changed variable is parsed again.
+ */
+static int test_hush_cache_scripts(void)
+{
+	int ret;
+
+	env_set("hc_out", "");
+	env_set("hc_loop",
+		"for i in a b c; do setenv hc_out ${hc_out}$i; done");
+	run_command("run hc_loop; run hc_loop", 0);
+	ret = hush_ut_expect("hc_out", "abcabc");
+	if (ret)
+		return ret;
+
+	/* Leaving a loop with 'exit' must not break the next run */
+	env_set("hc_out", "");
+	env_set("hc_exit",
+		"for i in x y; do setenv hc_out ${hc_out}$i; exit; done");
+	run_command("run hc_exit; run hc_exit", 0);
+	ret = hush_ut_expect("hc_out", "xx");
+	if (ret)
+		return ret;
+
+	/* A script that changes itself runs the new text next time */
+	env_set("hc_self", "setenv hc_out 1; setenv hc_self setenv hc_out 2");
+	run_command("run hc_self", 0);
+	ret = hush_ut_expect("hc_out", "1");
+	if (!ret) {
+		run_command("run hc_self", 0);
+		ret = hush_ut_expect("hc_out", "2");
+	}
+
+	env_set("hc_out", NULL);
+	env_set("hc_loop", NULL);
+	env_set("hc_exit", NULL);
+	env_set("hc_self", NULL);
+
+	return ret;
+}
+
+/* Time the distro boot scripts with the console silenced */
+static ulong hush_ut_time_boot(void)
+{
+	ulong start;
+	int i;
+
+	gd->flags |= GD_FLG_SILENT;
+	start = timer_get_us();
+	for (i = 0; i < HUSH_UT_RUNS; i++) {
+		run_command("run distro_bootcmd", 0);
+		run_command("setenv devtype host; setenv devnum 0; "
+			    "for distro_bootpart in 1 2 3 4; do "
+			    "run scan_dev_for_boot; done", 0);
+	}
+	start = timer_get_us() - start;
+	gd->flags &= ~GD_FLG_SILENT;
+
+	return start;
+}
+
+static int test_hush_cache_benchmark(void)
+{
+	ulong parsed_us, cached_us;
+
+	if (!env_get("distro_bootcmd") || !env_get("scan_dev_for_boot")) {
+		printf("%s: no distro boot scripts, skipping\n", __func__);
+		return 0;
+	}
+
+	hush_cache_enable(0);
+	parsed_us = hush_ut_time_boot();
+	hush_cache_enable(1);
+	cached_us = hush_ut_time_boot();
+
+	printf("distro boot scripts, %d runs: %lu us parsed, %lu us cached\n",
+	       HUSH_UT_RUNS, parsed_us, cached_us);
+
+	return 0;
+}
+
+int do_ut_hush_cache(cmd_tbl_t *cmdtp, int flag, int argc,
+		     char * const argv[])
+{
+	int ret;
+
+	ret = test_hush_cache_scripts();
+	if (!ret)
+		ret = test_hush_cache_benchmark();
+
+	printf("Test %s\n", ret ? "failed" : "passed");
+
+	return ret ? CMD_RET_FAILURE : CMD_RET_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*
+ * Stress test for the EFI memory map
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ *
+ * Sandbox builds the memory map without the rest of the EFI loader, so
+ * nothing else uses it. The test adds a region of RAM at an arbitrary
+ * address (it is only bookkeeping, the memory is never touched) and makes
+ * single page allocations from it.
+ */
+
+#include <common.h>
+#include <efi_loader.h>
+#include <malloc.h>
+#include <test/lib.h>
+#include <test/ut.h>
+
+/* Number of single page allocations made by the test */
+#define EFI_UT_REGIONS		20000
+#define EFI_UT_RAM_BASE		0x40000000ULL
+#define EFI_UT_RAM_PAGES	(2 * EFI_UT_REGIONS)
+#define EFI_UT_RAM_END		(EFI_UT_RAM_BASE + \
+				 ((u64)EFI_UT_RAM_PAGES << EFI_PAGE_SHIFT))
+
+struct efi_ut_latency {
+	ulong total_us;
+	ulong max_us;
+};
+
+static void efi_ut_account(struct efi_ut_latency *lat, ulong start_us)
+{
+	ulong delta = timer_get_us() - start_us;
+
+	lat->total_us += delta;
+	if (delta > lat->max_us)
+		lat->max_us = delta;
+}
+
+static void efi_ut_report(const char *name, struct efi_ut_latency *lat,
+			  int calls)
+{
+	printf("%-14s %6d calls, avg %lu us, max %lu us\n", name, calls,
+	       lat->total_us / calls, lat->max_us);
+}
+
+static efi_uintn_t efi_ut_map_entries(void)
+{
+	efi_uintn_t size = 0, key;
+
+	efi_get_memory_map(&size, NULL, &key, NULL, NULL);
+
+	return size / sizeof(struct efi_mem_desc);
+}
+
+/* Check that the map is sorted by address and has no overlaps */
+static int efi_ut_check_map(struct unit_test_state *uts,
+			    struct efi_ut_latency *map_lat)
+{
+	struct efi_mem_desc *desc;
+	efi_uintn_t size, key, i;
+	efi_status_t r;
+	u64 end = 0;
+	ulong start;
+
+	size = efi_ut_map_entries() * sizeof(*desc);
+	desc = malloc(size);
+	ut_assertnonnull(desc);
+	start = timer_get_us();
+	r = efi_get_memory_map(&size, desc, &key, NULL, NULL);
+	efi_ut_account(map_lat, start);
+	for (i = 0; r == EFI_SUCCESS && i < size / sizeof(*desc); i++) {
+		if (desc[i].physical_start < end)
+			break;
+		end = desc[i].physical_start +
+			(desc[i].num_pages << EFI_PAGE_SHIFT);
+	}
+	free(desc);
+	ut_asserteq(EFI_SUCCESS, r);
+	ut_asserteq(size / sizeof(*desc), i);
+
+	return 0;
+}
+
+static int efi_ut_stress(struct unit_test_state *uts, u64 *pages)
+{
+	struct efi_ut_latency alloc_lat = { 0 }, free_lat = { 0 };
+	struct efi_ut_latency map_lat = { 0 };
+	efi_uintn_t entries;
+	u64 addr;
+	ulong start;
+	int i, pass;
+
+	ut_assert(efi_add_memory_map(EFI_UT_RAM_BASE, EFI_UT_RAM_PAGES,
+				     EFI_CONVENTIONAL_MEMORY, false) ==
+		  EFI_UT_RAM_BASE);
+	entries = efi_ut_map_entries();
+
+	/* Alternate the memory types so that the map cannot merge them */
+	for (i = 0; i < EFI_UT_REGIONS; i++) {
+		pages[i] = EFI_UT_RAM_END;
+		start = timer_get_us();
+		ut_asserteq(EFI_SUCCESS,
+			    efi_allocate_pages(1, i & 1 ? EFI_LOADER_DATA :
+					       EFI_BOOT_SERVICES_DATA, 1,
+					       &pages[i]));
+		efi_ut_account(&alloc_lat, start);
+		ut_assert(pages[i] >= EFI_UT_RAM_BASE);
+	}
+	ut_asserteq(entries + EFI_UT_REGIONS, efi_ut_map_entries());
+	ut_assertok(efi_ut_check_map(uts, &map_lat));
+
+	/* Allocating a page which is in use fails and changes nothing */
+	addr = pages[EFI_UT_REGIONS / 2];
+	ut_asserteq(EFI_OUT_OF_RESOURCES,
+		    efi_allocate_pages(2, EFI_LOADER_DATA, 2, &addr));
+	ut_asserteq(entries + EFI_UT_REGIONS, efi_ut_map_entries());
+
+	/* Free every other page first to fragment the map, then the rest */
+	for (pass = 0; pass < 2; pass++) {
+		for (i = pass; i < EFI_UT_REGIONS; i += 2) {
+			start = timer_get_us();
+			ut_asserteq(EFI_SUCCESS, efi_free_pages(pages[i], 1));
+			efi_ut_account(&free_lat, start);
+			pages[i] = 0;
+		}
+	}
+
+	/* All freed pages must have been merged back */
+	ut_asserteq(entries, efi_ut_map_entries());
+	ut_assertok(efi_ut_check_map(uts, &map_lat));
+
+	efi_ut_report("AllocatePages", &alloc_lat, EFI_UT_REGIONS);
+	efi_ut_report("FreePages", &free_lat, EFI_UT_REGIONS);
+	efi_ut_report("GetMemoryMap", &map_lat, 2);
+
+	return 0;
+}
+
+/*
+ * Make tens of thousands of page allocations and free them again,
+ * reporting the time taken by each call
+ */
+static int lib_test_efi_memory_map(struct unit_test_state *uts)
+{
+	u64 *pages;
+	int ret;
+
+	pages = calloc(EFI_UT_REGIONS, sizeof(*pages));
+	ut_assertnonnull(pages);
+	ret = efi_ut_stress(uts, pages);
+	free(pages);
+
+	/* Drop anything left over by a failure */
+	efi_add_memory_map(EFI_UT_RAM_BASE, EFI_UT_RAM_PAGES,
+			   EFI_CONVENTIONAL_MEMORY, false);
+
+	return ret;
+}
+LIB_TEST(lib_test_efi_memory_map, 0);
@@ -0,0 +1,42 @@
+/*
+ * Tests for the network checksum routines
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ */
+
+#include <common.h>
+#include <net.h>
+#include <test/lib.h>
+#include <test/ut.h>
+
+/* Check the IP checksum against a plain 16-bit sum at every alignment */
+static int lib_test_net_checksum(struct unit_test_state *uts)
+{
+	u8 buf[64 + 4];
+	uint align, len, i;
+	u8 *ptr;
+	u32 sum;
+	u16 word;
+
+	for (i = 0; i < sizeof(buf); i++)
+		buf[i] = i * 37 + 11;
+
+	for (align = 0; align < 4; align++) {
+		ptr = buf + align;
+		for (len = 0; len <= 64; len++) {
+			sum = 0;
+			for (i = 0; i < len; i += 2) {
+				word = 0;
+				memcpy(&word, ptr + i, min(2U, len - i));
+				sum += word;
+			}
+			sum = (sum >> 16) + (sum & 0xffff);
+			sum += sum >> 16;
+			ut_asserteq(~sum & 0xffff,
+				    compute_ip_checksum(ptr, len));
+		}
+	}
+
+	return 0;
+}
+LIB_TEST(lib_test_net_checksum, 0);
@@ -0,0 +1,231 @@
+/*
+ * Tests for memcpy(), memmove(), memset() and memcmp()
+ *
+ * SPDX-License-Identifier:	GPL-2.0+
+ *
+ * Each routine is compared against a byte loop for all sizes up to
+ * STR_TEST_MAX_SIZE, at every alignment of source and destination up to
+ * STR_TEST_ALIGN. The bytes around the destination must not be touched.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+#include <test/lib.h>
+#include <test/ut.h>
+
+#define STR_TEST_MAX_SIZE	256
+/* Covers the word size and the 16-byte alignment of the ARM64 routines */
+#define STR_TEST_ALIGN		16
+/* Source and destination offsets tried for memmove(), both ways around */
+#define STR_TEST_SHIFT		(2 * STR_TEST_ALIGN)
+#define STR_TEST_BUF_SIZE	(STR_TEST_MAX_SIZE + 2 * STR_TEST_SHIFT)
+
+static u8 str_test_pattern(int i, int seed)
+{
+	return (i * 29 + seed * 13 + 1) ^ (i >> 3);
+}
+
+static void str_test_fill(u8 *buf, int size, int seed)
+{
+	int i;
+
+	for (i = 0; i < size; i++)
+		buf[i] = str_test_pattern(i, seed);
+}
+
+/* Return the offset of the first byte which differs, -1 if none */
+static int str_test_diff(const u8 *a, const u8 *b, int size)
+{
+	int i;
+
+	for (i = 0; i < size; i++) {
+		if (a[i] != b[i])
+			return i;
+	}
+
+	return -1;
+}
+
+static int lib_test_memset(struct unit_test_state *uts)
+{
+	u8 *buf, *expect;
+	int size, off, i, c, diff;
+
+	buf = memalign(ARCH_DMA_MINALIGN, STR_TEST_BUF_SIZE);
+	expect = malloc(STR_TEST_BUF_SIZE);
+	ut_assertnonnull(buf);
+	ut_assertnonnull(expect);
+
+	for (c = 0; c < 0x100; c += 0xa5) {
+		for (size = 0; size <= STR_TEST_MAX_SIZE; size++) {
+			for (off = 0; off < STR_TEST_ALIGN; off++) {
+				str_test_fill(buf, STR_TEST_BUF_SIZE, size);
+				str_test_fill(expect, STR_TEST_BUF_SIZE, size);
+				for (i = 0; i < size; i++)
+					expect[off + i] = c;
+
+				ut_asserteq_ptr(buf + off,
+						memset(buf + off, c, size));
+				diff = str_test_diff(buf, expect,
+					     STR_TEST_BUF_SIZE);
+				ut_asserteq(-1, diff);
+			}
+		}
+	}
+
+	free(expect);
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_memset, 0);
+
+static int lib_test_memcpy(struct unit_test_state *uts)
+{
+	u8 *src, *dst, *expect;
+	int size, soff, doff, i, diff;
+
+	src = memalign(ARCH_DMA_MINALIGN, STR_TEST_BUF_SIZE);
+	dst = memalign(ARCH_DMA_MINALIGN, STR_TEST_BUF_SIZE);
+	expect = malloc(STR_TEST_BUF_SIZE);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	ut_assertnonnull(expect);
+	str_test_fill(src, STR_TEST_BUF_SIZE, 1);
+
+	for (size = 0; size <= STR_TEST_MAX_SIZE; size++) {
+		for (soff = 0; soff < STR_TEST_ALIGN; soff++) {
+			for (doff = 0; doff < STR_TEST_ALIGN; doff++) {
+				str_test_fill(dst, STR_TEST_BUF_SIZE, 2);
+				str_test_fill(expect, STR_TEST_BUF_SIZE, 2);
+				for (i = 0; i < size; i++)
+					expect[doff + i] = src[soff + i];
+
+				ut_asserteq_ptr(dst + doff,
+						memcpy(dst + doff, src + soff,
+						       size));
+				diff = str_test_diff(dst, expect,
+					     STR_TEST_BUF_SIZE);
+				ut_asserteq(-1, diff);
+			}
+		}
+	}
+
+	free(expect);
+	free(dst);
+	free(src);
+
+	return 0;
+}
+LIB_TEST(lib_test_memcpy, 0);
+
+/*
+ * Move within one buffer, so that the areas overlap with the destination
+ * both below and above the source.
+ */
+static int lib_test_memmove(struct unit_test_state *uts)
+{
+	u8 *buf, *expect;
+	int size, soff, doff, i, diff;
+
+	buf = memalign(ARCH_DMA_MINALIGN, STR_TEST_BUF_SIZE);
+	expect = malloc(STR_TEST_BUF_SIZE);
+	ut_assertnonnull(buf);
+	ut_assertnonnull(expect);
+
+	for (size = 0; size <= STR_TEST_MAX_SIZE; size++) {
+		for (soff = 0; soff < STR_TEST_SHIFT; soff++) {
+			for (doff = 0; doff < STR_TEST_SHIFT; doff++) {
+				str_test_fill(buf, STR_TEST_BUF_SIZE, 3);
+				str_test_fill(expect, STR_TEST_BUF_SIZE, 3);
+				for (i = 0; i < size; i++)
+					expect[doff + i] =
+						str_test_pattern(soff + i, 3);
+
+				ut_asserteq_ptr(buf + doff,
+						memmove(buf + doff, buf + soff,
+							size));
+				diff = str_test_diff(buf, expect,
+					     STR_TEST_BUF_SIZE);
+				ut_asserteq(-1, diff);
+			}
+		}
+	}
+
+	free(expect);
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_memmove, 0);
+
+static int str_test_sign(int val)
+{
+	return val < 0 ? -1 : val > 0;
+}
+
+/*
+ * Make @b differ from @a at @pos, with the next byte pulling the other way,
+ * and check that memcmp() sees the first difference in both directions.
+ */
+static int str_test_memcmp_at(struct unit_test_state *uts, const u8 *a,
+			      u8 *b, int size, int pos)
+{
+	int expect;
+
+	b[pos] ^= 0x80;
+	if (pos + 1 < size)
+		b[pos + 1] = ~a[pos + 1];
+
+	expect = str_test_sign(a[pos] - b[pos]);
+	ut_asserteq(expect, str_test_sign(memcmp(a, b, size)));
+	ut_asserteq(-expect, str_test_sign(memcmp(b, a, size)));
+
+	b[pos] = a[pos];
+	if (pos + 1 < size)
+		b[pos + 1] = a[pos + 1];
+
+	return 0;
+}
+
+static int lib_test_memcmp(struct unit_test_state *uts)
+{
+	u8 *a, *b;
+	int size, aoff, boff, pos, i;
+
+	a = memalign(ARCH_DMA_MINALIGN, STR_TEST_BUF_SIZE);
+	b = memalign(ARCH_DMA_MINALIGN, STR_TEST_BUF_SIZE);
+	ut_assertnonnull(a);
+	ut_assertnonnull(b);
+
+	for (size = 0; size <= STR_TEST_MAX_SIZE; size++) {
+		for (aoff = 0; aoff < STR_TEST_ALIGN; aoff++) {
+			for (boff = 0; boff < STR_TEST_ALIGN; boff++) {
+				memset(a, 0, STR_TEST_BUF_SIZE);
+				memset(b, 0xff, STR_TEST_BUF_SIZE);
+				for (i = 0; i < size; i++) {
+					a[aoff + i] = str_test_pattern(i, 4);
+					b[boff + i] = a[aoff + i];
+				}
+				ut_asserteq(0, memcmp(a + aoff, b + boff,
+						      size));
+				if (!size)
+					continue;
+
+				/* The first, a middle and the last byte */
+				for (i = 0; i < 3; i++) {
+					pos = i * (size - 1) / 2;
+					ut_assertok(str_test_memcmp_at(uts,
+						a + aoff, b + boff, size, pos));
+				}
+			}
+		}
+	}
+
+	free(b);
+	free(a);
+
+	return 0;
+}
+LIB_TEST(lib_test_memcmp, 0);